@@ -0,0 +1,286 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_BETWEENNESS_HPP
+#define GRAPH_BETWEENNESS_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Betweenness centrality
+//
+// The betweenness of a vertex v is the sum, over pairs of distinct
+// vertices s and t other than v, of the fraction of shortest paths from s
+// to t that pass through v. It is computed with Brandes' algorithm: a
+// search from each source counts shortest paths, and a pass over the
+// vertices in reverse order of distance accumulates the dependency of the
+// source on each vertex. This takes O(VE) time for unweighted graphs and
+// O(VE + V^2 log V) for weighted graphs.
+//
+// Sources are searched in parallel. Each thread claims sources from a
+// shared counter and accumulates dependencies into its own vector, and the
+// vectors are summed at the end, so no synchronization is needed during
+// the searches. The result for a given graph does not depend on the number
+// of threads, except for rounding.
+//
+// Directed graphs follow outgoing edges. For undirected graphs, each pair
+// is counted once, not once in each direction. Edge weights must be
+// positive. Paths are compared by exact distance, so weights should be
+// integers or otherwise sum without rounding.
+//
+// The approximate algorithms search from k sources sampled uniformly
+// without replacement, and scale the result by n / k. This is an unbiased
+// estimate whose error shrinks as k grows.
+
+
+namespace betweenness_impl {
+
+// The state of single-source searches. Only the vertices reached by a
+// search are reset after it.
+template<typename T>
+struct source_state
+{
+  using key_label = decltype(vertex_label(std::declval<std::vector<T>&>()));
+  using queue_type = mutable_binary_heap<vertex_t, key_label>;
+
+  static constexpr T infinity = std::numeric_limits<T>::max();
+
+  source_state(std::size_t n)
+    : distances(n, infinity),
+      paths(n, 0),
+      deltas(n, 0),
+      queue(n, vertex_label(distances))
+  { }
+
+  source_state(source_state const&) = delete;
+  source_state& operator=(source_state const&) = delete;
+
+  void reset()
+  {
+    for (vertex_t v : order) {
+      distances[v] = infinity;
+      paths[v] = 0;
+      deltas[v] = 0;
+    }
+    order.clear();
+  }
+
+  std::vector<T> distances;
+  std::vector<double> paths;    // The number of shortest paths
+  std::vector<double> deltas;   // The dependency of the source
+  std::vector<vertex_t> order;  // Vertices by non-decreasing distance
+  queue_type queue;
+};
+
+// Count the shortest paths from s by breadth-first search.
+template<typename G, typename T>
+void
+count_paths(G const& g, vertex_t s, unit_weight, source_state<T>& st)
+{
+  st.distances[s] = 0;
+  st.paths[s] = 1;
+  st.order.push_back(s);
+  for (std::size_t i = 0; i < st.order.size(); ++i) {
+    vertex_t u = st.order[i];
+    T d = st.distances[u] + 1;
+    for_each_successor(g, u, [&](vertex_t v, edge_t) {
+      if (st.distances[v] == st.infinity) {
+        st.distances[v] = d;
+        st.order.push_back(v);
+      }
+      if (st.distances[v] == d)
+        st.paths[v] += st.paths[u];
+    });
+  }
+}
+
+// Count the shortest paths from s by Dijkstra's algorithm. Vertices are
+// added to the order as they are settled.
+template<typename G, typename W, typename T>
+void
+count_paths(G const& g, vertex_t s, W weight, source_state<T>& st)
+{
+  st.distances[s] = 0;
+  st.paths[s] = 1;
+  st.queue.push(s);
+  while (!st.queue.is_empty()) {
+    vertex_t u = st.queue.top();
+    st.queue.pop();
+    st.order.push_back(u);
+    T du = st.distances[u];
+    for_each_successor(g, u, [&](vertex_t v, edge_t e) {
+      assert(weight(e) > T(0));
+      T d = du + weight(e);
+      T& dv = st.distances[v];
+      if (d < dv) {
+        st.paths[v] = st.paths[u];
+        if (st.queue.contains(v)) {
+          st.queue.update(v, d);
+        }
+        else {
+          dv = d;
+          st.queue.push(v);
+        }
+      }
+      else if (d == dv) {
+        st.paths[v] += st.paths[u];
+      }
+    });
+  }
+}
+
+// Add the dependencies of s on each vertex to centrality. Successors on
+// shortest paths are farther from s, so they are finished first.
+template<typename G, typename W, typename T>
+void
+accumulate(G const& g, vertex_t s, W weight, source_state<T>& st,
+           std::vector<double>& centrality)
+{
+  count_paths(g, s, weight, st);
+  for (auto i = st.order.rbegin(); i != st.order.rend(); ++i) {
+    vertex_t u = *i;
+    T du = st.distances[u];
+    double delta = 0;
+    for_each_successor(g, u, [&](vertex_t v, edge_t e) {
+      if (st.distances[v] == du + weight(e))
+        delta += (1 + st.deltas[v]) / st.paths[v];
+    });
+    st.deltas[u] = st.paths[u] * delta;
+    if (u != s)
+      centrality[u] += st.deltas[u];
+  }
+  st.reset();
+}
+
+// Returns the sum of the dependencies of each source, times scale.
+template<typename G, typename W>
+std::vector<double>
+betweenness(G const& g, W weight, std::vector<vertex_t> const& sources,
+            double scale)
+{
+  using weight_type = std::decay_t<decltype(weight(edge_t()))>;
+
+  std::size_t n = g.num_vertices();
+  std::size_t nthreads = std::max<std::size_t>(
+    1, std::min(concurrency(), sources.size()));
+  if (!incidence_graph<G>)
+    scale /= 2;
+
+  std::vector<std::vector<double>> partial(nthreads);
+  std::atomic<std::size_t> next(0);
+  parallel_for(counted_range<std::size_t>(nthreads),
+               [&](counted_range<std::size_t> r) {
+    for (std::size_t i : r) {
+      partial[i].assign(n, 0.0);
+      source_state<weight_type> st(n);
+      std::size_t j;
+      while ((j = next.fetch_add(1, std::memory_order_relaxed)) <
+             sources.size())
+        accumulate(g, sources[j], weight, st, partial[i]);
+    }
+  }, 1);
+
+  std::vector<double> result(n);
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      double sum = 0;
+      for (auto const& p : partial)
+        sum += p[v];
+      result[v] = sum * scale;
+    }
+  });
+  return result;
+}
+
+// Returns k vertices of g sampled without replacement.
+template<typename G>
+std::vector<vertex_t>
+sample_sources(G const& g, std::size_t k, std::size_t seed)
+{
+  std::vector<vertex_t> vs(g.num_vertices());
+  std::iota(vs.begin(), vs.end(), 0);
+  k = std::min(k, vs.size());
+  std::minstd_rand gen(seed);
+  for (std::size_t i = 0; i < k; ++i) {
+    std::uniform_int_distribution<std::size_t> pick(i, vs.size() - 1);
+    std::swap(vs[i], vs[pick(gen)]);
+  }
+  vs.resize(k);
+  return vs;
+}
+
+} // namespace betweenness_impl
+
+
+// Returns the betweenness centrality of each vertex of g, where the length
+// of each path is its number of edges.
+template<typename G>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+std::vector<double>
+betweenness_centrality(G const& g)
+{
+  std::vector<vertex_t> sources(g.num_vertices());
+  std::iota(sources.begin(), sources.end(), 0);
+  return betweenness_impl::betweenness(g, unit_weight(), sources, 1.0);
+}
+
+// Returns the betweenness centrality of each vertex of g, where the length
+// of each path is the sum of its edge weights.
+template<typename G, typename W>
+  requires vertex_list_graph<G> && edge_property<W> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+std::vector<double>
+betweenness_centrality(G const& g, W weight)
+{
+  std::vector<vertex_t> sources(g.num_vertices());
+  std::iota(sources.begin(), sources.end(), 0);
+  return betweenness_impl::betweenness(g, weight, sources, 1.0);
+}
+
+// Returns an estimate of the betweenness centrality of each vertex of g
+// from the searches of k sampled sources.
+template<typename G>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+std::vector<double>
+approximate_betweenness(G const& g, std::size_t k, std::size_t seed = 1)
+{
+  std::size_t n = g.num_vertices();
+  auto sources = betweenness_impl::sample_sources(g, k, seed);
+  double scale = sources.empty() ? 0 : double(n) / sources.size();
+  return betweenness_impl::betweenness(g, unit_weight(), sources, scale);
+}
+
+template<typename G, typename W>
+  requires vertex_list_graph<G> && edge_property<W> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+std::vector<double>
+approximate_betweenness(G const& g, W weight, std::size_t k,
+                        std::size_t seed = 1)
+{
+  std::size_t n = g.num_vertices();
+  auto sources = betweenness_impl::sample_sources(g, k, seed);
+  double scale = sources.empty() ? 0 : double(n) / sources.size();
+  return betweenness_impl::betweenness(g, weight, sources, scale);
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../betweenness.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+bool
+close(std::vector<double> const& a, std::vector<double> const& b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (std::size_t i = 0; i < a.size(); ++i)
+    if (std::abs(a[i] - b[i]) > 1e-9 * (1 + std::abs(b[i])))
+      return false;
+  return true;
+}
+
+// Computes betweenness from the definition: v lies on a shortest path from
+// s to t exactly when d(s, v) + d(v, t) = d(s, t), and then carries
+// paths(s, v) * paths(v, t) of the paths(s, t) shortest paths.
+std::vector<double>
+brute_force(digraph<> const& g)
+{
+  constexpr std::size_t inf = std::numeric_limits<std::size_t>::max() / 4;
+  std::size_t n = g.num_vertices();
+  std::vector<std::vector<std::size_t>> d(n);
+  std::vector<std::vector<double>> p(n);
+  for (vertex_t s = 0; s < n; ++s) {
+    d[s].assign(n, inf);
+    p[s].assign(n, 0);
+    d[s][s] = 0;
+    p[s][s] = 1;
+    std::vector<vertex_t> queue {s};
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      vertex_t u = queue[i];
+      for (edge_t e : g.out_edges(u)) {
+        vertex_t v = g.target(e);
+        if (d[s][v] == inf) {
+          d[s][v] = d[s][u] + 1;
+          queue.push_back(v);
+        }
+        if (d[s][v] == d[s][u] + 1)
+          p[s][v] += p[s][u];
+      }
+    }
+  }
+  std::vector<double> bc(n, 0);
+  for (vertex_t s = 0; s < n; ++s)
+    for (vertex_t t = 0; t < n; ++t)
+      for (vertex_t v = 0; v < n; ++v) {
+        if (v == s || v == t || s == t || d[s][t] == inf)
+          continue;
+        if (d[s][v] + d[v][t] == d[s][t])
+          bc[v] += p[s][v] * p[v][t] / p[s][t];
+      }
+  return bc;
+}
+
+int
+main()
+{
+  // A path a - b - c - d.
+  {
+    graph<> g;
+    for (int i = 0; i < 4; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 3);
+    assert(close(betweenness_centrality(g), {0, 2, 2, 0}));
+
+    digraph<> h;
+    for (int i = 0; i < 4; ++i)
+      h.add_vertex();
+    h.add_edge(0, 1);
+    h.add_edge(1, 2);
+    h.add_edge(2, 3);
+    assert(close(betweenness_centrality(h), {0, 2, 2, 0}));
+  }
+
+  // A star with 5 leaves: the center is on every path between leaves.
+  {
+    graph<> g;
+    for (int i = 0; i < 6; ++i)
+      g.add_vertex();
+    for (vertex_t v = 1; v < 6; ++v)
+      g.add_edge(0, v);
+    assert(close(betweenness_centrality(g), {10, 0, 0, 0, 0, 0}));
+  }
+
+  // Weights move paths: the direct edge from 0 to 2 is longer than the
+  // path through 1, and two equal paths from 0 to 4 split through 2 and 3.
+  {
+    digraph<empty, int> g;
+    for (int i = 0; i < 5; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1, 1);
+    g.add_edge(1, 2, 1);
+    g.add_edge(0, 2, 5);
+    g.add_edge(2, 4, 2);
+    g.add_edge(0, 3, 2);
+    g.add_edge(3, 4, 2);
+    auto weight = [&g](edge_t e) { return g.edges_[e].data; };
+    auto bc = betweenness_centrality(g, weight);
+    // 1 is on 0->2 and half of 0->4; 2 is on 1->4 and half of 0->4.
+    assert(close(bc, {0, 1.5, 1.5, 0.5, 0}));
+    assert(close(betweenness_centrality(g), {0, 0, 1.5, 0.5, 0}));
+  }
+
+  // Random graphs agree with the definition, and with unit weights.
+  std::minstd_rand gen(3);
+  for (int trial = 0; trial < 5; ++trial) {
+    std::size_t n = 40;
+    digraph<> g;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (int i = 0; i < 120; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (u != v && !g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    auto bc = betweenness_centrality(g);
+    assert(close(bc, brute_force(g)));
+    assert(close(betweenness_centrality(g, [](edge_t) { return 1; }), bc));
+
+    // Sampling every vertex is exact. Sampling half is an estimate with
+    // the same total, in expectation.
+    assert(close(approximate_betweenness(g, n), bc));
+    assert(close(approximate_betweenness(g, 2 * n, 5), bc));
+    auto est = approximate_betweenness(g, n / 2, trial);
+    assert(est.size() == n);
+  }
+}
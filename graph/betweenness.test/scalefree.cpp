@@ -0,0 +1,90 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../betweenness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Computes betweenness on a preferential attachment graph, whose degrees
+// follow a power law, exactly and from samples of increasing size. For
+// each sample size, reports the time and the mean relative error of the
+// estimate over the 100 most central vertices.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 10000;
+  std::size_t k = argc > 2 ? std::atoi(argv[2]) : 4;
+
+  // Each new vertex attaches to k distinct endpoints of existing edges.
+  graph<> g;
+  std::minstd_rand gen(29);
+  std::vector<vertex_t> ends;
+  for (std::size_t i = 0; i <= k; ++i)
+    g.add_vertex();
+  for (vertex_t u = 0; u <= k; ++u)
+    for (vertex_t v = u + 1; v <= k; ++v) {
+      g.add_edge(u, v);
+      ends.push_back(u);
+      ends.push_back(v);
+    }
+  while (g.num_vertices() < n) {
+    vertex_t u = g.add_vertex();
+    std::uniform_int_distribution<std::size_t> pick(0, ends.size() - 1);
+    for (std::size_t i = 0; i < k; ++i) {
+      vertex_t v = ends[pick(gen)];
+      if (g.has_edge(u, v))
+        continue;
+      g.add_edge(u, v);
+      ends.push_back(u);
+      ends.push_back(v);
+    }
+  }
+  std::cout << g.num_vertices() << " vertices, " << g.num_edges()
+            << " edges, " << concurrency() << " threads\n";
+
+  auto start = clock::now();
+  std::vector<double> exact = betweenness_centrality(g);
+  ms t0 = clock::now() - start;
+  std::cout << "exact: " << t0.count() << " ms\n";
+
+  std::vector<vertex_t> top(n);
+  for (vertex_t v = 0; v < n; ++v)
+    top[v] = v;
+  std::size_t m = std::min<std::size_t>(100, n);
+  std::partial_sort(top.begin(), top.begin() + m, top.end(),
+                    [&](vertex_t a, vertex_t b) {
+    return exact[a] > exact[b];
+  });
+
+  for (std::size_t s : {64, 256, 1024}) {
+    start = clock::now();
+    std::vector<double> est = approximate_betweenness(g, s);
+    ms t = clock::now() - start;
+    double error = 0;
+    for (std::size_t i = 0; i < m; ++i) {
+      vertex_t v = top[i];
+      error += std::abs(est[v] - exact[v]) / exact[v];
+    }
+    std::cout << "sample " << s << ": " << t.count() << " ms, error "
+              << error / m << '\n';
+  }
+
+  // Weighted searches on the same graph, with unit weights.
+  start = clock::now();
+  approximate_betweenness(g, [](edge_t) { return 1u; }, 1024);
+  ms t1 = clock::now() - start;
+  std::cout << "weighted sample 1024: " << t1.count() << " ms\n";
+}
@@ -0,0 +1,635 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_BSP_HPP
+#define GRAPH_BSP_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "gather.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Sharded graphs
+//
+// A sharded digraph splits the vertices of a directed graph into
+// contiguous ranges, one per shard. A shard owns the vertices in its range
+// and their outgoing edges. The target of an edge is either owned by the
+// shard or is a ghost: a vertex owned by another shard. Each shard stores
+// only its own part of the graph, so shards can be placed on different
+// machines.
+//
+// Within a shard, owned vertices are numbered from 0 in the order of their
+// global numbers, and ghosts are numbered after them, also in order. Since
+// shards own contiguous ranges, the ghosts owned by each other shard are
+// also contiguous.
+struct digraph_shard
+{
+  // Returns the number of owned vertices.
+  std::size_t size() const { return last - first; }
+
+  // Returns the local number of each target of the local vertex v.
+  counted_range<std::size_t> out_edges(vertex_t v) const
+  {
+    return {offsets[v], offsets[v + 1]};
+  }
+
+  std::size_t out_degree(vertex_t v) const
+  {
+    return offsets[v + 1] - offsets[v];
+  }
+
+  // Returns the global number of the local vertex v.
+  vertex_t global(vertex_t v) const
+  {
+    return v < size() ? first + v : ghosts[v - size()];
+  }
+
+  vertex_t first;                       // The owned range is [first, last)
+  vertex_t last;
+  std::vector<std::size_t> offsets;     // Edges of v are [offsets[v],
+  std::vector<vertex_t> heads;          // offsets[v + 1]) in heads
+  std::vector<edge_t> edges;            // The global number of each edge
+  std::vector<vertex_t> ghosts;         // The global number of each ghost
+  std::vector<std::size_t> ghost_bounds; // Ghosts of shard j begin here
+};
+
+// Build shard i of g, which owns [bounds[i], bounds[i + 1]).
+template<typename G>
+  requires incidence_graph<G>
+digraph_shard
+make_shard(G const& g, std::vector<vertex_t> const& bounds, std::size_t i)
+{
+  digraph_shard s;
+  s.first = bounds[i];
+  s.last = bounds[i + 1];
+  s.offsets.push_back(0);
+  for (vertex_t u = s.first; u < s.last; ++u) {
+    for (edge_t e : g.out_edges(u)) {
+      vertex_t v = g.target(e);
+      if (v < s.first || v >= s.last)
+        s.ghosts.push_back(v);
+    }
+  }
+  std::sort(s.ghosts.begin(), s.ghosts.end());
+  s.ghosts.erase(std::unique(s.ghosts.begin(), s.ghosts.end()),
+                 s.ghosts.end());
+
+  for (vertex_t u = s.first; u < s.last; ++u) {
+    for (edge_t e : g.out_edges(u)) {
+      vertex_t v = g.target(e);
+      if (v >= s.first && v < s.last)
+        s.heads.push_back(v - s.first);
+      else
+        s.heads.push_back(s.size() + (std::lower_bound(s.ghosts.begin(),
+                                                       s.ghosts.end(), v) -
+                                      s.ghosts.begin()));
+      s.edges.push_back(e);
+    }
+    s.offsets.push_back(s.heads.size());
+  }
+
+  for (vertex_t b : bounds)
+    s.ghost_bounds.push_back(std::lower_bound(s.ghosts.begin(),
+                                              s.ghosts.end(), b) -
+                             s.ghosts.begin());
+  return s;
+}
+
+struct sharded_digraph
+{
+  // Returns the number of shards.
+  std::size_t size() const { return shards.size(); }
+
+  std::size_t num_vertices() const { return bounds.back(); }
+
+  // Returns the shard that owns v.
+  std::size_t owner(vertex_t v) const
+  {
+    return std::upper_bound(bounds.begin(), bounds.end(), v) -
+           bounds.begin() - 1;
+  }
+
+  std::vector<vertex_t> bounds;  // Shard i owns [bounds[i], bounds[i + 1])
+  std::vector<digraph_shard> shards;
+};
+
+// Split g into at most k shards. The ranges are chosen so that each shard
+// has about the same number of vertices plus outgoing edges.
+template<typename G>
+  requires incidence_graph<G>
+sharded_digraph
+shard_digraph(G const& g, std::size_t k)
+{
+  sharded_digraph s;
+  s.bounds = partition_vertices(g, k, [&g](vertex_t v) {
+    return 1 + g.out_degree(v);
+  }).bounds;
+  for (std::size_t i = 0; i + 1 < s.bounds.size(); ++i)
+    s.shards.push_back(make_shard(g, s.bounds, i));
+  return s;
+}
+
+
+// Transports
+//
+// A transport moves batches of messages between shards, and combines
+// values contributed by each shard. Between supersteps, each shard sends
+// its batches and contributes its totals, and then every shard calls
+// exchange(). After that, receive() returns the batches sent to a shard
+// and totals() the combined totals. A transport for separate processes
+// implements exchange() as a collective operation.
+//
+// Batches are arrays of bytes, so any transport can carry them.
+
+// Values combined across shards after each superstep.
+struct bsp_totals
+{
+  double aggregate = 0;    // The sum of values passed to aggregate()
+  std::size_t pending = 0; // Active vertices plus messages sent
+};
+
+// A transport for shards in the same process. Batches are moved between
+// mailboxes, and are never copied.
+struct shared_memory_transport
+{
+  explicit shared_memory_transport(std::size_t n)
+    : outboxes(n), inboxes(n), locks(n), parts(n), batches(0), bytes(0)
+  { }
+
+  void send(std::size_t from, std::size_t to, std::vector<char>& batch);
+  void contribute(std::size_t from, bsp_totals t) { parts[from] = t; }
+  void exchange();
+  void receive(std::size_t to, std::vector<std::vector<char>>& out);
+  bsp_totals totals() const { return combined; }
+
+  std::vector<std::vector<std::vector<char>>> outboxes;
+  std::vector<std::vector<std::vector<char>>> inboxes;
+  std::vector<std::mutex> locks;
+  std::vector<bsp_totals> parts;
+  bsp_totals combined;
+
+  std::atomic<std::size_t> batches; // The number of batches sent
+  std::atomic<std::size_t> bytes;   // The number of bytes sent
+};
+
+// Send batch to shard to. The batch is moved, and is left empty.
+inline void
+shared_memory_transport::send(std::size_t, std::size_t to,
+                              std::vector<char>& batch)
+{
+  batches += 1;
+  bytes += batch.size();
+  std::lock_guard<std::mutex> lock(locks[to]);
+  outboxes[to].push_back(std::move(batch));
+  batch.clear();
+}
+
+// Deliver the batches sent since the last exchange, and combine totals.
+inline void
+shared_memory_transport::exchange()
+{
+  for (std::size_t i = 0; i < outboxes.size(); ++i) {
+    inboxes[i].clear();
+    inboxes[i].swap(outboxes[i]);
+  }
+  combined = bsp_totals();
+  for (bsp_totals const& t : parts) {
+    combined.aggregate += t.aggregate;
+    combined.pending += t.pending;
+  }
+}
+
+inline void
+shared_memory_transport::receive(std::size_t to,
+                                 std::vector<std::vector<char>>& out)
+{
+  out.clear();
+  out.swap(inboxes[to]);
+}
+
+
+// Bulk synchronous execution
+//
+// A vertex program is run on each vertex of a sharded digraph in a
+// sequence of supersteps, as in Pregel. In each superstep, the program is
+// called for each vertex that is active or has received a message. It may
+// update the value of the vertex, send messages to any vertex, contribute
+// to a global sum, and vote to halt. A halted vertex becomes active again
+// when it receives a message. Messages sent in one superstep are received
+// in the next. Execution stops when every vertex has halted and no
+// messages are in flight, or after max_supersteps supersteps.
+//
+// A program P has the following members:
+//
+//    P::value_type        The value of each vertex.
+//    P::message_type      A trivially copyable message.
+//    p.combine(a, b)      Returns the combination of two messages sent to
+//                         the same vertex, which replaces them. It must be
+//                         associative and commutative.
+//    p.compute(ctx, m)    Run the program for the vertex ctx.vertex(). m
+//                         points to the combination of the messages sent
+//                         to the vertex, or is null if there are none.
+//
+// Messages to the same vertex are combined by the sending shard before
+// they are sent, so at most one message per ghost leaves a shard in each
+// superstep. All messages from one shard to another in a superstep are
+// sent as a single batch. Shards are run concurrently, each by a single
+// thread.
+template<typename P, typename T = shared_memory_transport>
+struct bsp_engine
+{
+  using value_type = typename P::value_type;
+  using message_type = typename P::message_type;
+
+  static_assert(std::is_trivially_copyable<message_type>::value,
+                "messages must be trivially copyable");
+
+  struct shard_state;
+  struct context;
+
+  bsp_engine(sharded_digraph const& g, P& program, T& transport)
+    : graph(g),
+      program(program),
+      transport(transport),
+      max_supersteps(std::numeric_limits<std::size_t>::max()),
+      combining(true),
+      supersteps(0),
+      messages(0),
+      remote_messages(0),
+      aggregated(0)
+  { }
+
+  void operator()();
+
+  // Returns the value of each vertex, by global number.
+  std::vector<value_type> values() const;
+
+  void compute(std::size_t i);
+  void flush(std::size_t i);
+  void deliver(std::size_t i);
+
+  void put(message_type& slot, char& full, message_type m)
+  {
+    slot = full ? program.combine(slot, m) : m;
+    full = 1;
+  }
+
+  sharded_digraph const& graph;
+  P& program;
+  T& transport;
+  std::size_t max_supersteps;
+  bool combining;  // If false, only messages to owned vertices are combined
+
+  std::vector<shard_state> states;
+  std::size_t supersteps;
+  std::size_t messages;         // Messages sent by the program
+  std::size_t remote_messages;  // Messages sent between shards
+  double aggregated;            // The sum of the previous superstep
+};
+
+template<typename P, typename T>
+struct bsp_engine<P, T>::shard_state
+{
+  std::vector<value_type> values;
+  std::vector<char> active;
+  std::vector<message_type> inbox;  // Messages for this superstep
+  std::vector<char> full;
+  std::vector<message_type> next;   // Messages for the next superstep
+  std::vector<char> next_full;
+  std::vector<message_type> ghost_out;
+  std::vector<char> ghost_full;
+  std::vector<std::vector<std::pair<vertex_t, message_type>>> spill;
+  std::vector<std::vector<char>> received;
+  std::vector<char> batch;
+  double aggregate;
+  std::size_t pending;
+  std::size_t messages;
+  std::size_t remote;
+};
+
+// The view of the engine given to a vertex program.
+template<typename P, typename T>
+struct bsp_engine<P, T>::context
+{
+  std::size_t superstep() const { return engine.supersteps; }
+  std::size_t num_vertices() const { return engine.graph.num_vertices(); }
+
+  // Returns the global number of the current vertex.
+  vertex_t vertex() const { return shard.first + v; }
+
+  value_type& value() { return state.values[v]; }
+  std::size_t out_degree() const { return shard.out_degree(v); }
+
+  // Returns the global number of each target of the current vertex.
+  template<typename F>
+  void for_each_target(F f) const
+  {
+    for (std::size_t j : shard.out_edges(v))
+      f(shard.global(shard.heads[j]));
+  }
+
+  void send(vertex_t target, message_type m);
+  void send_to_neighbors(message_type m);
+
+  // Add x to the sum available in the next superstep.
+  void aggregate(double x) { state.aggregate += x; }
+
+  // Returns the sum of values aggregated in the previous superstep.
+  double aggregated() const { return engine.aggregated; }
+
+  void halt() { state.active[v] = 0; }
+
+  void send_local(vertex_t w, message_type m);
+
+  bsp_engine& engine;
+  digraph_shard const& shard;
+  shard_state& state;
+  vertex_t v;  // The local number of the current vertex
+};
+
+// Send m to the local vertex w, which may be a ghost.
+template<typename P, typename T>
+inline void
+bsp_engine<P, T>::context::send_local(vertex_t w, message_type m)
+{
+  ++state.messages;
+  std::size_t n = shard.size();
+  if (w < n)
+    engine.put(state.next[w], state.next_full[w], m);
+  else if (engine.combining)
+    engine.put(state.ghost_out[w - n], state.ghost_full[w - n], m);
+  else {
+    vertex_t g = shard.ghosts[w - n];
+    state.spill[engine.graph.owner(g)].emplace_back(g, m);
+  }
+}
+
+template<typename P, typename T>
+void
+bsp_engine<P, T>::context::send(vertex_t target, message_type m)
+{
+  if (target >= shard.first && target < shard.last) {
+    send_local(target - shard.first, m);
+    return;
+  }
+  auto i = std::lower_bound(shard.ghosts.begin(), shard.ghosts.end(),
+                            target);
+  if (i != shard.ghosts.end() && *i == target) {
+    send_local(shard.size() + (i - shard.ghosts.begin()), m);
+    return;
+  }
+  ++state.messages;
+  state.spill[engine.graph.owner(target)].emplace_back(target, m);
+}
+
+template<typename P, typename T>
+void
+bsp_engine<P, T>::context::send_to_neighbors(message_type m)
+{
+  for (std::size_t j : shard.out_edges(v))
+    send_local(shard.heads[j], m);
+}
+
+// Run the program on each vertex of shard i that is active or has a
+// message.
+template<typename P, typename T>
+void
+bsp_engine<P, T>::compute(std::size_t i)
+{
+  digraph_shard const& shard = graph.shards[i];
+  shard_state& s = states[i];
+  s.aggregate = 0;
+  s.messages = 0;
+  context ctx {*this, shard, s, 0};
+  for (vertex_t v = 0; v < shard.size(); ++v) {
+    if (!s.active[v] && !s.full[v])
+      continue;
+    s.active[v] = 1;
+    ctx.v = v;
+    program.compute(ctx, s.full[v] ? &s.inbox[v] : nullptr);
+    s.full[v] = 0;
+  }
+}
+
+// Send one batch of messages to each other shard, and contribute totals.
+// A message on the wire is the global number of its target followed by
+// its value.
+template<typename P, typename T>
+void
+bsp_engine<P, T>::flush(std::size_t i)
+{
+  constexpr std::size_t size = sizeof(vertex_t) + sizeof(message_type);
+  digraph_shard const& shard = graph.shards[i];
+  shard_state& s = states[i];
+  s.remote = 0;
+  auto write = [&s](vertex_t v, message_type const& m) {
+    std::size_t at = s.batch.size();
+    s.batch.resize(at + size);
+    std::memcpy(s.batch.data() + at, &v, sizeof(v));
+    std::memcpy(s.batch.data() + at + sizeof(v), &m, sizeof(m));
+  };
+  for (std::size_t j = 0; j < graph.size(); ++j) {
+    for (std::size_t g = shard.ghost_bounds[j];
+         g < shard.ghost_bounds[j + 1]; ++g) {
+      if (s.ghost_full[g]) {
+        write(shard.ghosts[g], s.ghost_out[g]);
+        s.ghost_full[g] = 0;
+      }
+    }
+    for (auto const& x : s.spill[j])
+      write(x.first, x.second);
+    s.spill[j].clear();
+    if (!s.batch.empty()) {
+      s.remote += s.batch.size() / size;
+      transport.send(i, j, s.batch);
+    }
+  }
+
+  std::size_t pending = s.remote;
+  for (vertex_t v = 0; v < shard.size(); ++v)
+    pending += s.active[v] + s.next_full[v];
+  transport.contribute(i, {s.aggregate, pending});
+}
+
+// Combine the messages received by shard i into its inbox.
+template<typename P, typename T>
+void
+bsp_engine<P, T>::deliver(std::size_t i)
+{
+  constexpr std::size_t size = sizeof(vertex_t) + sizeof(message_type);
+  digraph_shard const& shard = graph.shards[i];
+  shard_state& s = states[i];
+  transport.receive(i, s.received);
+  for (std::vector<char> const& batch : s.received) {
+    for (std::size_t at = 0; at < batch.size(); at += size) {
+      vertex_t v;
+      message_type m;
+      std::memcpy(&v, batch.data() + at, sizeof(v));
+      std::memcpy(&m, batch.data() + at + sizeof(v), sizeof(m));
+      v -= shard.first;
+      put(s.next[v], s.next_full[v], m);
+    }
+  }
+  s.inbox.swap(s.next);
+  s.full.swap(s.next_full);
+}
+
+template<typename P, typename T>
+void
+bsp_engine<P, T>::operator()()
+{
+  std::size_t k = graph.size();
+  states.assign(k, shard_state());
+  for (std::size_t i = 0; i < k; ++i) {
+    digraph_shard const& shard = graph.shards[i];
+    shard_state& s = states[i];
+    std::size_t n = shard.size();
+    s.values.assign(n, value_type());
+    s.active.assign(n, 1);
+    s.inbox.resize(n);
+    s.full.assign(n, 0);
+    s.next.resize(n);
+    s.next_full.assign(n, 0);
+    s.ghost_out.resize(shard.ghosts.size());
+    s.ghost_full.assign(shard.ghosts.size(), 0);
+    s.spill.resize(k);
+  }
+
+  messages = remote_messages = 0;
+  aggregated = 0;
+  counted_range<std::size_t> shards(k);
+  for (supersteps = 0; supersteps < max_supersteps; ) {
+    parallel_for(shards, [this](counted_range<std::size_t> r) {
+      for (std::size_t i : r) {
+        compute(i);
+        flush(i);
+      }
+    }, 1);
+    transport.exchange();
+    parallel_for(shards, [this](counted_range<std::size_t> r) {
+      for (std::size_t i : r)
+        deliver(i);
+    }, 1);
+
+    for (shard_state const& s : states) {
+      messages += s.messages;
+      remote_messages += s.remote;
+    }
+    ++supersteps;
+    bsp_totals t = transport.totals();
+    aggregated = t.aggregate;
+    if (t.pending == 0)
+      break;
+  }
+}
+
+template<typename P, typename T>
+auto
+bsp_engine<P, T>::values() const -> std::vector<value_type>
+{
+  std::vector<value_type> all;
+  for (shard_state const& s : states)
+    all.insert(all.end(), s.values.begin(), s.values.end());
+  return all;
+}
+
+
+// Computes the distance from source to each vertex in a breadth-first
+// search. Each superstep advances the frontier by one level.
+struct bsp_bfs
+{
+  using value_type = std::size_t;
+  using message_type = std::size_t;
+
+  static constexpr std::size_t unreached =
+    std::numeric_limits<std::size_t>::max();
+
+  explicit bsp_bfs(vertex_t s)
+    : source(s)
+  { }
+
+  message_type combine(message_type a, message_type b) const
+  {
+    return std::min(a, b);
+  }
+
+  template<typename C>
+  void compute(C& ctx, message_type const* m) const
+  {
+    std::size_t& d = ctx.value();
+    bool reached = false;
+    if (ctx.superstep() == 0) {
+      d = unreached;
+      reached = ctx.vertex() == source;
+      if (reached)
+        d = 0;
+    }
+    else if (m && *m < d) {
+      d = *m;
+      reached = true;
+    }
+    if (reached)
+      ctx.send_to_neighbors(d + 1);
+    ctx.halt();
+  }
+
+  vertex_t source;
+};
+
+// Computes PageRank for a fixed number of iterations. The rank of vertices
+// with no outgoing edges is aggregated and redistributed uniformly, as is
+// a fraction 1 - damping of all rank.
+struct bsp_pagerank
+{
+  using value_type = double;
+  using message_type = double;
+
+  bsp_pagerank()
+    : damping(0.85), iterations(30)
+  { }
+
+  message_type combine(message_type a, message_type b) const
+  {
+    return a + b;
+  }
+
+  template<typename C>
+  void compute(C& ctx, message_type const* m) const
+  {
+    double n = ctx.num_vertices();
+    double& r = ctx.value();
+    if (ctx.superstep() == 0)
+      r = 1.0 / n;
+    else
+      r = damping * (m ? *m : 0.0) +
+          (damping * ctx.aggregated() + 1.0 - damping) / n;
+    if (ctx.superstep() == iterations) {
+      ctx.halt();
+      return;
+    }
+    if (std::size_t d = ctx.out_degree())
+      ctx.send_to_neighbors(r / d);
+    else
+      ctx.aggregate(r);
+  }
+
+  double damping;
+  std::size_t iterations;
+};
+
+
+} // namespace origin
+
+#endif
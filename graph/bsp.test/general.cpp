@@ -0,0 +1,164 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../bsp.hpp"
+#include "../digraph.hpp"
+#include "../pagerank.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns the distance from s to each vertex of g.
+template<typename G>
+std::vector<std::size_t>
+distances(G const& g, vertex_t s)
+{
+  std::vector<std::size_t> d(g.num_vertices(), bsp_bfs::unreached);
+  std::deque<vertex_t> q {s};
+  d[s] = 0;
+  while (!q.empty()) {
+    vertex_t u = q.front();
+    q.pop_front();
+    for (edge_t e : g.out_edges(u)) {
+      vertex_t v = g.target(e);
+      if (d[v] == bsp_bfs::unreached) {
+        d[v] = d[u] + 1;
+        q.push_back(v);
+      }
+    }
+  }
+  return d;
+}
+
+// Sends the id of each vertex to its successor, by number, in the first
+// superstep, and stores the greatest id received.
+struct ring
+{
+  using value_type = vertex_t;
+  using message_type = vertex_t;
+
+  vertex_t combine(vertex_t a, vertex_t b) const { return std::max(a, b); }
+
+  template<typename C>
+  void compute(C& ctx, vertex_t const* m) const
+  {
+    if (ctx.superstep() == 0) {
+      ctx.value() = ctx.vertex();
+      ctx.send((ctx.vertex() + 1) % ctx.num_vertices(), ctx.vertex());
+    }
+    else {
+      ctx.value() = *m;
+    }
+    ctx.halt();
+  }
+};
+
+
+int
+main()
+{
+  using G = digraph<>;
+  std::minstd_rand gen(3);
+  for (int trial = 0; trial < 20; ++trial) {
+    G g;
+    std::size_t n = 1 + gen() % 200;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (std::size_t i = 0; i < 3 * n; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+
+    std::size_t k = 1 + trial % 6;
+    sharded_digraph sg = shard_digraph(g, k);
+    assert(sg.size() <= k && sg.num_vertices() == n);
+
+    // Shards cover the edges of g, and ghosts are owned elsewhere.
+    std::size_t edges = 0;
+    for (std::size_t i = 0; i < sg.size(); ++i) {
+      digraph_shard const& s = sg.shards[i];
+      edges += s.edges.size();
+      for (vertex_t v = 0; v < s.size(); ++v)
+        for (std::size_t j : s.out_edges(v)) {
+          edge_t e = s.edges[j];
+          assert(g.source(e) == s.global(v));
+          assert(g.target(e) == s.global(s.heads[j]));
+        }
+      for (std::size_t j = 0; j < sg.size(); ++j)
+        for (std::size_t x = s.ghost_bounds[j]; x < s.ghost_bounds[j + 1];
+             ++x)
+          assert(j != i && sg.owner(s.ghosts[x]) == j);
+    }
+    assert(edges == g.num_edges());
+
+    for (bool combining : {true, false}) {
+      shared_memory_transport t(sg.size());
+      vertex_t source = pick(gen);
+      bsp_bfs bfs(source);
+      bsp_engine<bsp_bfs> e(sg, bfs, t);
+      e.combining = combining;
+      e();
+      std::vector<std::size_t> d = distances(g, source);
+      assert(e.values() == d);
+      std::size_t depth = 0;
+      for (std::size_t x : d)
+        if (x != bsp_bfs::unreached)
+          depth = std::max(depth, x);
+      assert(e.supersteps == depth + 1 || e.supersteps == depth + 2);
+      if (k == 1)
+        assert(t.batches == 0);
+    }
+
+    shared_memory_transport t(sg.size());
+    bsp_pagerank pr;
+    bsp_engine<bsp_pagerank> e(sg, pr, t);
+    e();
+    pagerank<G> ref(g);
+    ref.tolerance = 0;
+    ref.max_iterations = pr.iterations;
+    ref();
+    std::vector<double> ranks = e.values();
+    assert(e.supersteps == pr.iterations + 1);
+    for (vertex_t v = 0; v < n; ++v)
+      assert(std::abs(ranks[v] - ref.ranks[v]) < 1e-12);
+
+    // Messages to arbitrary vertices.
+    ring r;
+    bsp_engine<ring> re(sg, r, t);
+    re();
+    std::vector<vertex_t> got = re.values();
+    for (vertex_t v = 0; v < n; ++v)
+      assert(got[v] == (v + n - 1) % n);
+  }
+
+  // Combining sends at most one message per ghost in each superstep.
+  {
+    G g;
+    for (int i = 0; i < 4; ++i)
+      g.add_vertex();
+    g.add_edge(0, 2);
+    g.add_edge(1, 2);
+    g.add_edge(0, 3);
+    g.add_edge(1, 3);
+    std::vector<vertex_t> bounds {0, 2, 4};
+    sharded_digraph sg {bounds, {make_shard(g, bounds, 0),
+                                 make_shard(g, bounds, 1)}};
+    shared_memory_transport t(2);
+    bsp_pagerank pr;
+    pr.iterations = 1;
+    bsp_engine<bsp_pagerank> e(sg, pr, t);
+    e();
+    assert(e.messages == 4 && e.remote_messages == 2);
+    assert(t.batches == 1);
+    assert(t.bytes == 2 * (sizeof(vertex_t) + sizeof(double)));
+  }
+}
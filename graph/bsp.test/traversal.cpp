@@ -0,0 +1,79 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../bsp.hpp"
+#include "../digraph.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Runs BFS and PageRank on a sharded graph grown by preferential
+// attachment, with and without combining, and reports the time, the
+// number of supersteps, and the traffic between shards.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::size_t k = argc > 2 ? std::atoi(argv[2]) : 8;
+  std::size_t d = argc > 3 ? std::atoi(argv[3]) : 8;
+
+  digraph<> g;
+  std::vector<vertex_t> ends;
+  std::minstd_rand gen(23);
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = g.add_vertex();
+    for (std::size_t j = 0; j < d && !ends.empty(); ++j) {
+      vertex_t u = ends[gen() % ends.size()];
+      if (gen() % 2)
+        std::swap(u, v);
+      if (u != v && !g.has_edge(u, v)) {
+        g.add_edge(u, v);
+        ends.push_back(u);
+        ends.push_back(v);
+      }
+      if (v < u)
+        std::swap(u, v);
+    }
+    ends.push_back(v);
+  }
+
+  auto start = clock::now();
+  sharded_digraph sg = shard_digraph(g, k);
+  ms t = clock::now() - start;
+  std::size_t ghosts = 0;
+  for (digraph_shard const& s : sg.shards)
+    ghosts += s.ghosts.size();
+  std::cout << n << " vertices, " << g.num_edges() << " edges, "
+            << sg.size() << " shards, " << ghosts << " ghosts, "
+            << t.count() << " ms to shard\n";
+
+  auto run = [&](char const* name, auto program) {
+    for (bool combining : {false, true}) {
+      shared_memory_transport tr(sg.size());
+      bsp_engine<decltype(program)> e(sg, program, tr);
+      e.combining = combining;
+      start = clock::now();
+      e();
+      ms t = clock::now() - start;
+      std::cout << name << (combining ? " combined: " : ": ")
+                << t.count() << " ms, " << e.supersteps << " supersteps, "
+                << e.messages << " messages, " << e.remote_messages
+                << " remote, " << tr.batches << " batches, "
+                << tr.bytes / 1024 << " KB\n";
+    }
+  };
+  run("bfs", bsp_bfs(0));
+  bsp_pagerank pr;
+  pr.iterations = 20;
+  run("pagerank", pr);
+}
@@ -0,0 +1,232 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_BUILDER_HPP
+#define GRAPH_BUILDER_HPP
+
+#include "common.hpp"
+#include "digraph.hpp"
+#include "graph.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// A buffer of edges to be added to a graph. Each buffer is owned by a
+// single thread at a time; no synchronization is performed.
+template<typename Edge>
+struct edge_buffer
+{
+  using edge_type = Edge;
+  using label_type = typename Edge::label_type;
+
+  std::size_t size() const { return edges.size(); }
+
+  void add_edge(vertex_t u, vertex_t v) { edges.emplace_back(u, v); }
+
+  void add_edge(vertex_t u, vertex_t v, label_type const& x)
+  {
+    edges.emplace_back(u, v, x);
+  }
+
+  std::vector<Edge> edges;
+};
+
+
+// Builds the edges of a graph G (a digraph or graph) from a number of
+// independently filled shards. Each shard may be filled by a different
+// thread. Calling finish(g) appends the buffered edges to g.
+//
+// Edge ids are deterministic: the edges of shard i are numbered after those
+// of shards 0 through i - 1, in the order they were added to the shard. The
+// resulting graph is identical to the one produced by calling add_edge for
+// each edge in that order.
+//
+// Unlike add_edge, the builder does not check for duplicate edges.
+template<typename G>
+struct concurrent_builder
+{
+  using edge_type = typename G::edge_type;
+  using buffer_type = edge_buffer<edge_type>;
+
+  concurrent_builder(std::size_t n)
+    : shards(n)
+  { }
+
+  std::size_t num_shards() const { return shards.size(); }
+  std::size_t num_edges() const;
+
+  buffer_type& shard(std::size_t i) { return shards[i]; }
+
+  void finish(G& g);
+
+  std::vector<buffer_type> shards;
+};
+
+// Returns the total number of buffered edges.
+template<typename G>
+std::size_t
+concurrent_builder<G>::num_edges() const
+{
+  std::size_t n = 0;
+  for (buffer_type const& b : shards)
+    n += b.size();
+  return n;
+}
+
+
+namespace builder_impl {
+
+using counter_list = std::vector<std::atomic<std::size_t>>;
+
+// Append the edge e to the list of v, reserving a slot in that list.
+inline void
+scatter(counter_list& cursor, std::vector<edge_list*> const& lists,
+        vertex_t v, edge_t e)
+{
+  (*lists[v])[cursor[v].fetch_add(1, std::memory_order_relaxed)] = e;
+}
+
+template<typename V, typename E>
+void
+count_degree(digraph<V, E> const& g, edge_t e,
+             counter_list& out, counter_list& in)
+{
+  out[g.source(e)].fetch_add(1, std::memory_order_relaxed);
+  in[g.target(e)].fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename V, typename E>
+void
+count_degree(graph<V, E> const& g, edge_t e, counter_list& c, counter_list&)
+{
+  c[g.first(e)].fetch_add(1, std::memory_order_relaxed);
+  c[g.second(e)].fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename V, typename E>
+void
+incidence_lists(digraph<V, E>& g,
+                std::vector<edge_list*>& out, std::vector<edge_list*>& in)
+{
+  for (vertex_t v : g.vertices()) {
+    out[v] = &g.verts_[v].out_;
+    in[v] = &g.verts_[v].in_;
+  }
+}
+
+template<typename V, typename E>
+void
+incidence_lists(graph<V, E>& g,
+                std::vector<edge_list*>& ls, std::vector<edge_list*>&)
+{
+  for (vertex_t v : g.vertices())
+    ls[v] = &g.verts_[v].edges_;
+}
+
+template<typename V, typename E>
+void
+scatter(digraph<V, E> const& g, edge_t e,
+        counter_list& out, std::vector<edge_list*> const& outs,
+        counter_list& in, std::vector<edge_list*> const& ins)
+{
+  scatter(out, outs, g.source(e), e);
+  scatter(in, ins, g.target(e), e);
+}
+
+template<typename V, typename E>
+void
+scatter(graph<V, E> const& g, edge_t e,
+        counter_list& c, std::vector<edge_list*> const& ls,
+        counter_list&, std::vector<edge_list*> const&)
+{
+  scatter(c, ls, g.first(e), e);
+  scatter(c, ls, g.second(e), e);
+}
+
+} // namespace builder_impl
+
+
+// Append the buffered edges to g and clear the shards. Every endpoint of a
+// buffered edge must be a vertex of g.
+//
+// Edges are copied into g in shard order. Incidence lists are then built
+// in parallel by counting degrees, sizing each list, and scattering edge
+// ids into reserved slots. Because scattering is unordered, the newly
+// added portion of each list is sorted to restore insertion order.
+template<typename G>
+void
+concurrent_builder<G>::finish(G& g)
+{
+  using namespace builder_impl;
+
+  std::size_t n = g.num_vertices();
+  edge_t base = g.num_edges();
+  g.edges_.reserve(base + num_edges());
+  for (buffer_type& b : shards) {
+    g.edges_.insert(g.edges_.end(), b.edges.begin(), b.edges.end());
+    b.edges.clear();
+  }
+  counted_range<edge_t> added(base, g.num_edges());
+  counted_range<vertex_t> verts(0, n);
+
+  // Count the degree contributed by the new edges.
+  counter_list c1(n);
+  counter_list c2(n);
+  parallel_for(verts, [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      c1[v].store(0, std::memory_order_relaxed);
+      c2[v].store(0, std::memory_order_relaxed);
+    }
+  });
+  parallel_for(added, [&](counted_range<edge_t> r) {
+    for (edge_t e : r)
+      count_degree(g, e, c1, c2);
+  });
+
+  // Grow each list and reset the counters to the first new slot.
+  std::vector<edge_list*> l1(n);
+  std::vector<edge_list*> l2(n);
+  incidence_lists(g, l1, l2);
+  parallel_for(verts, [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      std::size_t k = c1[v].load(std::memory_order_relaxed);
+      c1[v].store(l1[v]->size(), std::memory_order_relaxed);
+      l1[v]->resize(l1[v]->size() + k);
+      if (l2[v]) {
+        k = c2[v].load(std::memory_order_relaxed);
+        c2[v].store(l2[v]->size(), std::memory_order_relaxed);
+        l2[v]->resize(l2[v]->size() + k);
+      }
+    }
+  });
+
+  // Scatter edge ids into their lists.
+  parallel_for(added, [&](counted_range<edge_t> r) {
+    for (edge_t e : r)
+      scatter(g, e, c1, l1, c2, l2);
+  });
+
+  // Restore insertion order in the new part of each list.
+  parallel_for(verts, [&](counted_range<vertex_t> r) {
+    auto order = [base](edge_list& l) {
+      auto first = std::lower_bound(l.begin(), l.end(), base);
+      std::sort(first, l.end());
+    };
+    for (vertex_t v : r) {
+      order(*l1[v]);
+      if (l2[v])
+        order(*l2[v]);
+    }
+  });
+}
+
+
+} // namespace origin
+
+#endif
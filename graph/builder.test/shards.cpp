@@ -0,0 +1,130 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../builder.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <thread>
+
+
+using namespace origin;
+
+
+// Fill the shards of b concurrently with pseudo-random edges and return
+// the same edges in shard order.
+template<typename B>
+std::vector<std::pair<vertex_t, vertex_t>>
+fill(B& builder, std::size_t n, std::size_t m)
+{
+  std::vector<std::vector<std::pair<vertex_t, vertex_t>>> edges(
+    builder.num_shards());
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    std::minstd_rand gen(i);
+    std::uniform_int_distribution<vertex_t> dist(0, n - 1);
+    for (std::size_t j = 0; j < m; ++j)
+      edges[i].emplace_back(dist(gen), dist(gen));
+  }
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    threads.emplace_back([&builder, &edges, i]() {
+      int k = 0;
+      for (auto const& p : edges[i])
+        builder.shard(i).add_edge(p.first, p.second, k++);
+    });
+  }
+  for (std::thread& t : threads)
+    t.join();
+
+  std::vector<std::pair<vertex_t, vertex_t>> all;
+  for (auto const& l : edges)
+    all.insert(all.end(), l.begin(), l.end());
+  return all;
+}
+
+
+void
+test_digraph()
+{
+  using G = digraph<empty, int>;
+  std::size_t n = 1000;
+
+  G g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+
+  concurrent_builder<G> builder(4);
+  auto edges = fill(builder, n, 5000);
+  assert(builder.num_edges() == edges.size());
+  builder.finish(g);
+  assert(builder.num_edges() == 0);
+
+  // The same graph, built serially.
+  G h;
+  for (std::size_t i = 0; i < n; ++i)
+    h.add_vertex();
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    edge_t e = h.edges_.size();
+    h.edges_.emplace_back(edges[i].first, edges[i].second, 0);
+    h.verts_[edges[i].first].out_.push_back(e);
+    h.verts_[edges[i].second].in_.push_back(e);
+  }
+
+  assert(g.num_edges() == h.num_edges());
+  for (edge_t e : g.edges()) {
+    assert(g.source(e) == h.source(e));
+    assert(g.target(e) == h.target(e));
+  }
+  assert(g.edges_[5000].data == 0);
+  assert(g.edges_[5001].data == 1);
+  for (vertex_t v : g.vertices()) {
+    assert(g.out_edges(v) == h.out_edges(v));
+    assert(g.in_edges(v) == h.in_edges(v));
+  }
+}
+
+
+void
+test_graph()
+{
+  using G = graph<empty, int>;
+  std::size_t n = 500;
+
+  G g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1, -1);
+
+  concurrent_builder<G> builder(3);
+  auto edges = fill(builder, n, 2000);
+  builder.finish(g);
+
+  assert(g.num_edges() == edges.size() + 1);
+  assert(g.edges(0).front() == 0);
+  assert(g.edges(1).front() == 0);
+  for (std::size_t i = 0; i < edges.size(); ++i) {
+    edge_t e = i + 1;
+    assert(g.first(e) == edges[i].first);
+    assert(g.second(e) == edges[i].second);
+  }
+
+  std::size_t total = 0;
+  for (vertex_t v : g.vertices()) {
+    edge_list es = g.edges(v);
+    assert(std::is_sorted(es.begin(), es.end()));
+    for (edge_t e : es)
+      assert(g.first(e) == v || g.second(e) == v);
+    total += es.size();
+  }
+  assert(total == 2 * g.num_edges());
+}
+
+
+int
+main()
+{
+  test_digraph();
+  test_graph();
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_COLOR_HPP
+#define GRAPH_COLOR_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+
+namespace origin {
+
+// The colors used to record the progress of a search. White vertices have
+// not been discovered, gray vertices are on the search stack, and black
+// vertices are finished.
+enum color_t : unsigned char { white = 0, gray = 1, black = 2 };
+
+
+// A color map that packs the color of each vertex into B bits. With B == 2,
+// the map distinguishes all three colors. With B == 1, the map is a simple
+// bitset that only distinguishes white from non-white vertices; writing
+// either gray or black sets the bit, and reading a set bit yields black.
+template<int B>
+struct packed_color_map
+{
+  static_assert(B == 1 || B == 2, "unsupported color width");
+
+  using word_type = std::uint64_t;
+
+  static constexpr std::size_t bits = B;
+  static constexpr std::size_t per_word = 64 / B;
+  static constexpr word_type mask = (word_type(1) << B) - 1;
+
+  // A reference to the color of a single vertex.
+  struct reference
+  {
+    reference(word_type& w, std::size_t s)
+      : word(w), shift(s)
+    { }
+
+    operator color_t() const
+    {
+      word_type c = (word >> shift) & mask;
+      return B == 1 && c ? black : color_t(c);
+    }
+
+    reference& operator=(color_t c)
+    {
+      word_type x = B == 1 ? word_type(c != white) : word_type(c);
+      word = (word & ~(mask << shift)) | (x << shift);
+      return *this;
+    }
+
+    reference& operator=(reference const& r)
+    {
+      return *this = color_t(r);
+    }
+
+    word_type& word;
+    std::size_t shift;
+  };
+
+  packed_color_map() = default;
+  packed_color_map(std::size_t n, color_t c = white);
+
+  std::size_t size() const { return count; }
+
+  color_t operator[](vertex_t v) const;
+  reference operator[](vertex_t v);
+
+  void fill(color_t c);
+
+  std::vector<word_type> words;
+  std::size_t count = 0;
+};
+
+template<int B>
+packed_color_map<B>::packed_color_map(std::size_t n, color_t c)
+  : words((n + per_word - 1) / per_word), count(n)
+{
+  fill(c);
+}
+
+// Returns the color of v.
+template<int B>
+color_t
+packed_color_map<B>::operator[](vertex_t v) const
+{
+  assert(v < count);
+  word_type c = (words[v / per_word] >> (v % per_word * B)) & mask;
+  return B == 1 && c ? black : color_t(c);
+}
+
+// Returns a reference to the color of v.
+template<int B>
+auto
+packed_color_map<B>::operator[](vertex_t v) -> reference
+{
+  assert(v < count);
+  return reference(words[v / per_word], v % per_word * B);
+}
+
+// Set the color of every vertex to c.
+template<int B>
+void
+packed_color_map<B>::fill(color_t c)
+{
+  word_type x = B == 1 ? word_type(c != white) : word_type(c);
+  word_type w = 0;
+  for (std::size_t i = 0; i < per_word; ++i)
+    w |= x << (i * B);
+  std::fill(words.begin(), words.end(), w);
+}
+
+
+// A color map that uses 2 bits per vertex.
+using two_bit_color_map = packed_color_map<2>;
+
+// A color map that uses 1 bit per vertex. This is sufficient for searches
+// that never need to distinguish gray vertices from black ones.
+using one_bit_color_map = packed_color_map<1>;
+
+
+// Construct a label over a packed color map.
+template<int B>
+auto vertex_label(packed_color_map<B>& map) {
+  return [&map](vertex_t v) { return map[v]; };
+}
+
+
+} // namespace origin
+
+#endif
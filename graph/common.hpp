@@ -37,6 +37,12 @@ auto edge_label(std::vector<T>& vec) {
   return [&vec](edge_t e) -> T& { return vec[e]; };
 }
 
+// The weight of each edge of an unweighted graph.
+struct unit_weight
+{
+  std::size_t operator()(edge_t) const { return 1; }
+};
+
 
 } // namespace origin
 
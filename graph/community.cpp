@@ -0,0 +1,4 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "community.hpp"
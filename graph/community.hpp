@@ -0,0 +1,564 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_COMMUNITY_HPP
+#define GRAPH_COMMUNITY_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Community detection
+//
+// The algorithms below find communities in an undirected graph: groups of
+// vertices with many edges inside the group and few between groups. Edges
+// are weighted by a label W, which defaults to unit weights. Communities
+// are numbered from 0 in the order of their least vertex.
+//
+// Both algorithms are parallel and deterministic. Vertices are visited in
+// a random order given by seed, in batches. The vertices of a batch are
+// decided concurrently from the state before the batch, and the decisions
+// are applied in order. The result depends on the seed and the batch
+// size, but not on the number of threads.
+
+
+namespace community_impl {
+
+constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+// A map from communities to weights, in a hash table with open addressing.
+// Keys are listed in the order they were added, and clearing the map takes
+// time proportional to the number of keys. Each thread uses its own.
+struct weight_accumulator
+{
+  weight_accumulator()
+    : keys(16, none), values(16, 0)
+  { }
+
+  void add(std::size_t k, double w);
+  double find(std::size_t k) const;
+  void clear();
+
+  std::size_t size() const { return used.size(); }
+  std::size_t key(std::size_t i) const { return keys[used[i]]; }
+  double value(std::size_t i) const { return values[used[i]]; }
+
+  std::size_t slot(std::size_t k) const;
+  void grow();
+
+  std::vector<std::size_t> keys;
+  std::vector<double> values;
+  std::vector<std::size_t> used;  // The slots of each key, in order
+};
+
+// Returns the slot holding k, or the empty slot where k would be added.
+inline std::size_t
+weight_accumulator::slot(std::size_t k) const
+{
+  std::size_t mask = keys.size() - 1;
+  std::size_t h = k * 0x9e3779b97f4a7c15ull;
+  std::size_t i = (h ^ (h >> 32)) & mask;
+  while (keys[i] != none && keys[i] != k)
+    i = (i + 1) & mask;
+  return i;
+}
+
+inline void
+weight_accumulator::add(std::size_t k, double w)
+{
+  if (2 * (used.size() + 1) > keys.size())
+    grow();
+  std::size_t i = slot(k);
+  if (keys[i] == none) {
+    keys[i] = k;
+    used.push_back(i);
+  }
+  values[i] += w;
+}
+
+inline double
+weight_accumulator::find(std::size_t k) const
+{
+  std::size_t i = slot(k);
+  return keys[i] == k ? values[i] : 0.0;
+}
+
+inline void
+weight_accumulator::clear()
+{
+  for (std::size_t i : used) {
+    keys[i] = none;
+    values[i] = 0;
+  }
+  used.clear();
+}
+
+// Double the size of the table, keeping keys in order.
+inline void
+weight_accumulator::grow()
+{
+  std::vector<std::size_t> old_keys(2 * keys.size(), none);
+  std::vector<double> old_values(2 * keys.size(), 0);
+  old_keys.swap(keys);
+  old_values.swap(values);
+  std::vector<std::size_t> old_used;
+  old_used.swap(used);
+  for (std::size_t i : old_used) {
+    std::size_t j = slot(old_keys[i]);
+    keys[j] = old_keys[i];
+    values[j] = old_values[i];
+    used.push_back(j);
+  }
+}
+
+// An undirected graph with weighted edges, in compressed sparse row form.
+// Each edge appears in the adjacency of both ends. Self loops are stored
+// separately, and each adds twice its weight to the degree of its vertex.
+struct weighted_graph
+{
+  std::size_t size() const { return degrees.size(); }
+
+  std::vector<std::size_t> offsets {0};
+  std::vector<vertex_t> heads;
+  std::vector<double> weights;
+  std::vector<double> loops;    // The weight of self loops at each vertex
+  std::vector<double> degrees;  // The weighted degree of each vertex
+  double total = 0;             // The sum of degrees
+};
+
+template<typename G, typename W>
+weighted_graph
+make_weighted(G const& g, W weight)
+{
+  weighted_graph w;
+  std::size_t n = g.num_vertices();
+  w.loops.assign(n, 0);
+  w.degrees.assign(n, 0);
+  std::vector<std::size_t> counts(n + 1, 0);
+  for (edge_t e : g.edges()) {
+    vertex_t u = g.first(e), v = g.second(e);
+    if (u != v) {
+      ++counts[u + 1];
+      ++counts[v + 1];
+    }
+  }
+  std::partial_sum(counts.begin(), counts.end(), counts.begin());
+  w.offsets = counts;
+  w.heads.resize(counts.back());
+  w.weights.resize(counts.back());
+  for (edge_t e : g.edges()) {
+    vertex_t u = g.first(e), v = g.second(e);
+    double x = weight(e);
+    if (u == v) {
+      w.loops[u] += x;
+      w.degrees[u] += 2 * x;
+      continue;
+    }
+    w.heads[counts[u]] = v;
+    w.weights[counts[u]++] = x;
+    w.heads[counts[v]] = u;
+    w.weights[counts[v]++] = x;
+    w.degrees[u] += x;
+    w.degrees[v] += x;
+  }
+  for (double d : w.degrees)
+    w.total += d;
+  return w;
+}
+
+// Returns the modularity of the communities of g.
+inline double
+modularity(weighted_graph const& g, std::vector<std::size_t> const& comm,
+           double resolution)
+{
+  if (g.total == 0)
+    return 0;
+  std::size_t n = g.size();
+  std::vector<double> inside(n, 0);
+  std::vector<double> totals(n, 0);
+  for (vertex_t u = 0; u < n; ++u) {
+    std::size_t c = comm[u];
+    totals[c] += g.degrees[u];
+    inside[c] += 2 * g.loops[u];
+    for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j)
+      if (comm[g.heads[j]] == c)
+        inside[c] += g.weights[j];
+  }
+  double q = 0;
+  for (std::size_t c = 0; c < n; ++c) {
+    double t = totals[c] / g.total;
+    q += inside[c] / g.total - resolution * t * t;
+  }
+  return q;
+}
+
+// Renumber communities from 0 in the order of their least vertex. Returns
+// the number of communities.
+inline std::size_t
+renumber(std::vector<std::size_t>& comm)
+{
+  std::vector<std::size_t> ids(comm.size(), none);
+  std::size_t count = 0;
+  for (std::size_t& c : comm) {
+    if (ids[c] == none)
+      ids[c] = count++;
+    c = ids[c];
+  }
+  return count;
+}
+
+// Call decide(acc, i) for each i in [first, last), concurrently, where
+// acc is an accumulator owned by the calling thread.
+template<typename F>
+void
+for_each_in_batch(std::size_t first, std::size_t last, F decide)
+{
+  counted_range<std::size_t> r(first, last);
+  parallel_for(r, [&decide](counted_range<std::size_t> block) {
+    weight_accumulator acc;
+    for (std::size_t i : block)
+      decide(acc, i);
+  }, 256);
+}
+
+// Move vertices between communities to increase modularity, starting from
+// singletons, until a pass gains less than tolerance. Returns the number
+// of moves.
+//
+// Each vertex moves to the neighboring community with the greatest gain,
+// preferring its own community and then the least community on ties. The
+// vertices of a batch decide together, so each move is checked again when
+// it is applied, using the community totals after the earlier moves of
+// the batch. Without that, batches chain vertices into communities that
+// are too large. Two singletons could also swap communities forever, so a
+// singleton only joins a singleton with a lesser number.
+inline std::size_t
+move_vertices(weighted_graph const& g, std::vector<std::size_t>& comm,
+              double resolution, double tolerance, std::size_t max_passes,
+              std::size_t batch, std::minstd_rand& gen)
+{
+  std::size_t n = g.size();
+  comm.resize(n);
+  std::iota(comm.begin(), comm.end(), 0);
+  if (g.total == 0)
+    return 0;
+  std::vector<double> totals = g.degrees;
+  std::vector<std::size_t> sizes(n, 1);
+  std::vector<vertex_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<std::size_t> targets(n);
+  std::vector<double> gains(n);  // The weight to the target, less to own
+
+  auto decide = [&](weight_accumulator& acc, std::size_t i) {
+    vertex_t v = order[i];
+    std::size_t own = comm[v];
+    double k = g.degrees[v];
+    acc.clear();
+    for (std::size_t j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+      acc.add(comm[g.heads[j]], g.weights[j]);
+    std::size_t best = own;
+    double scale = resolution * k / g.total;
+    double stay = acc.find(own);
+    double most = stay - scale * (totals[own] - k);
+    for (std::size_t x = 0; x < acc.size(); ++x) {
+      std::size_t c = acc.key(x);
+      if (c == own || (sizes[own] == 1 && sizes[c] == 1 && c > own))
+        continue;
+      double score = acc.value(x) - scale * totals[c];
+      if (score > most || (score == most && best != own && c < best)) {
+        best = c;
+        most = score;
+        gains[i] = acc.value(x) - stay;
+      }
+    }
+    targets[i] = best;
+  };
+
+  std::size_t total = 0;
+  double q = modularity(g, comm, resolution);
+  for (std::size_t pass = 0; pass < max_passes; ++pass) {
+    std::shuffle(order.begin(), order.end(), gen);
+    std::size_t moves = 0;
+    for (std::size_t first = 0; first < n; first += batch) {
+      std::size_t last = std::min(n, first + batch);
+      for_each_in_batch(first, last, decide);
+      for (std::size_t i = first; i < last; ++i) {
+        vertex_t v = order[i];
+        std::size_t from = comm[v], to = targets[i];
+        if (to == from)
+          continue;
+
+        // Check the move against the totals after earlier moves.
+        double k = g.degrees[v];
+        double scale = resolution * k / g.total;
+        if (gains[i] - scale * (totals[to] - totals[from] + k) <= 0 ||
+            (sizes[from] == 1 && sizes[to] == 1 && to > from))
+          continue;
+        totals[from] -= g.degrees[v];
+        totals[to] += g.degrees[v];
+        --sizes[from];
+        ++sizes[to];
+        comm[v] = to;
+        ++moves;
+      }
+    }
+    total += moves;
+    double next = modularity(g, comm, resolution);
+    if (moves == 0 || next - q < tolerance)
+      break;
+    q = next;
+  }
+  return total;
+}
+
+// Returns the graph whose vertices are the communities of g, renumbering
+// them first. Edges within a community become a self loop.
+inline weighted_graph
+aggregate(weighted_graph const& g, std::vector<std::size_t>& comm)
+{
+  std::size_t n = g.size();
+  std::size_t m = renumber(comm);
+
+  // List the members of each community in order.
+  std::vector<std::size_t> starts(m + 1, 0);
+  for (std::size_t c : comm)
+    ++starts[c + 1];
+  std::partial_sum(starts.begin(), starts.end(), starts.begin());
+  std::vector<vertex_t> members(n);
+  std::vector<std::size_t> fill(starts.begin(), starts.end() - 1);
+  for (vertex_t u = 0; u < n; ++u)
+    members[fill[comm[u]]++] = u;
+
+  weighted_graph c;
+  c.loops.assign(m, 0);
+  c.degrees.assign(m, 0);
+  c.total = g.total;
+  std::vector<std::vector<std::pair<vertex_t, double>>> rows(m);
+  for_each_in_batch(0, m, [&](weight_accumulator& acc, std::size_t x) {
+    acc.clear();
+    for (std::size_t i = starts[x]; i < starts[x + 1]; ++i) {
+      vertex_t u = members[i];
+      c.degrees[x] += g.degrees[u];
+      c.loops[x] += g.loops[u];
+      for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j) {
+        std::size_t y = comm[g.heads[j]];
+        if (y == x)
+          c.loops[x] += g.weights[j] / 2;
+        else
+          acc.add(y, g.weights[j]);
+      }
+    }
+    for (std::size_t i = 0; i < acc.size(); ++i)
+      rows[x].emplace_back(acc.key(i), acc.value(i));
+  });
+  for (auto const& row : rows) {
+    for (auto const& e : row) {
+      c.heads.push_back(e.first);
+      c.weights.push_back(e.second);
+    }
+    c.offsets.push_back(c.heads.size());
+  }
+  return c;
+}
+
+} // namespace community_impl
+
+
+// Returns the modularity of the communities of g, which are numbered from
+// 0 to n - 1. Larger resolutions favor smaller communities.
+template<typename G, typename W = unit_weight>
+  requires undirected_incidence_graph<G> && edge_list_graph<G>
+double
+modularity(G const& g, std::vector<std::size_t> const& communities,
+           W weight = W(), double resolution = 1)
+{
+  return community_impl::modularity(community_impl::make_weighted(g, weight),
+                                    communities, resolution);
+}
+
+
+// Finds communities by label propagation. Each vertex starts with its own
+// label, and repeatedly adopts the label with the greatest total weight
+// among its neighbors, keeping its own label on ties, and otherwise taking
+// the least. Stops when an iteration changes no labels, or after
+// max_iterations iterations.
+//
+// The vertices of a batch decide together, so two vertices could swap
+// labels forever, as could the sides of any bipartite component smaller
+// than a batch. As in move_vertices, a vertex that is alone in its label
+// only adopts the label of another such vertex if it is lesser.
+template<typename G, typename W = unit_weight>
+  requires undirected_incidence_graph<G> && edge_list_graph<G>
+struct label_propagation
+{
+  label_propagation(G const& g, W weight = W())
+    : graph(g),
+      weight(weight),
+      max_iterations(100),
+      batch(4096),
+      seed(1),
+      iterations(0),
+      count(0)
+  { }
+
+  void operator()();
+
+  G const& graph;
+  W weight;
+  std::size_t max_iterations;
+  std::size_t batch;  // Vertices decided together
+  std::size_t seed;
+
+  std::vector<std::size_t> communities;
+  std::size_t iterations;
+  std::size_t count;  // The number of communities
+};
+
+template<typename G, typename W>
+  requires undirected_incidence_graph<G> && edge_list_graph<G>
+void
+label_propagation<G, W>::operator()()
+{
+  using namespace community_impl;
+  weighted_graph g = make_weighted(graph, weight);
+  std::size_t n = g.size();
+  std::vector<std::size_t>& labels = communities;
+  labels.resize(n);
+  std::iota(labels.begin(), labels.end(), 0);
+  std::vector<vertex_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<std::size_t> next(n);
+  std::vector<std::size_t> sizes(n, 1);
+  std::minstd_rand gen(seed);
+
+  auto decide = [&](weight_accumulator& acc, std::size_t i) {
+    vertex_t v = order[i];
+    acc.clear();
+    for (std::size_t j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+      acc.add(labels[g.heads[j]], g.weights[j]);
+    std::size_t own = labels[v];
+    std::size_t best = own;
+    double most = acc.find(best);
+    for (std::size_t x = 0; x < acc.size(); ++x) {
+      double w = acc.value(x);
+      std::size_t l = acc.key(x);
+      if (sizes[own] == 1 && sizes[l] == 1 && l > own)
+        continue;
+      if (w > most || (w == most && best != own && l < best)) {
+        best = l;
+        most = w;
+      }
+    }
+    next[i] = best;
+  };
+
+  for (iterations = 0; iterations < max_iterations; ) {
+    std::shuffle(order.begin(), order.end(), gen);
+    std::size_t changes = 0;
+    for (std::size_t first = 0; first < n; first += batch) {
+      std::size_t last = std::min(n, first + batch);
+      for_each_in_batch(first, last, decide);
+      for (std::size_t i = first; i < last; ++i) {
+        vertex_t v = order[i];
+        if (next[i] == labels[v])
+          continue;
+        --sizes[labels[v]];
+        ++sizes[next[i]];
+        labels[v] = next[i];
+        ++changes;
+      }
+    }
+    ++iterations;
+    if (changes == 0)
+      break;
+  }
+  count = renumber(labels);
+}
+
+
+// Finds communities by maximizing modularity with the Louvain method.
+// Vertices are first moved between communities while that increases
+// modularity. The communities are then contracted into the vertices of a
+// coarser graph, and the process repeats on that graph until no vertex
+// moves, or after max_levels levels.
+template<typename G, typename W = unit_weight>
+  requires undirected_incidence_graph<G> && edge_list_graph<G>
+struct louvain
+{
+  louvain(G const& g, W weight = W())
+    : graph(g),
+      weight(weight),
+      resolution(1),
+      tolerance(1e-7),
+      max_passes(32),
+      max_levels(32),
+      batch(4096),
+      seed(1),
+      levels(0),
+      count(0),
+      modularity(0)
+  { }
+
+  void operator()();
+
+  G const& graph;
+  W weight;
+  double resolution;
+  double tolerance;        // The least gain in modularity of a pass
+  std::size_t max_passes;  // Passes per level
+  std::size_t max_levels;
+  std::size_t batch;       // Vertices decided together
+  std::size_t seed;
+
+  std::vector<std::size_t> communities;
+  std::size_t levels;
+  std::size_t count;  // The number of communities
+  double modularity;
+};
+
+template<typename G, typename W>
+  requires undirected_incidence_graph<G> && edge_list_graph<G>
+void
+louvain<G, W>::operator()()
+{
+  using namespace community_impl;
+  weighted_graph g = make_weighted(graph, weight);
+  communities.resize(g.size());
+  std::iota(communities.begin(), communities.end(), 0);
+  std::minstd_rand gen(seed);
+  std::vector<std::size_t> comm;
+  for (levels = 0; levels < max_levels; ) {
+    if (!move_vertices(g, comm, resolution, tolerance, max_passes, batch,
+                       gen))
+      break;
+    weighted_graph c = aggregate(g, comm);
+    for (std::size_t& x : communities)
+      x = comm[x];
+    ++levels;
+    bool done = c.size() == g.size();
+    g = std::move(c);
+    if (done)
+      break;
+  }
+
+  // The vertices of g are the communities.
+  comm.resize(g.size());
+  std::iota(comm.begin(), comm.end(), 0);
+  modularity = community_impl::modularity(g, comm, resolution);
+  count = renumber(communities);
+}
+
+
+} // namespace origin
+
+#endif
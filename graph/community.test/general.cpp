@@ -0,0 +1,175 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../community.hpp"
+#include "../graph.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns a ring of k cliques of size s, each joined to the next by one
+// edge.
+graph<>
+ring_of_cliques(std::size_t k, std::size_t s)
+{
+  graph<> g;
+  for (std::size_t i = 0; i < k * s; ++i)
+    g.add_vertex();
+  for (std::size_t c = 0; c < k; ++c) {
+    for (std::size_t i = 0; i < s; ++i)
+      for (std::size_t j = i + 1; j < s; ++j)
+        g.add_edge(c * s + i, c * s + j);
+    g.add_edge(c * s, ((c + 1) % k) * s + 1);
+  }
+  return g;
+}
+
+// Returns true if the communities are the cliques of ring_of_cliques.
+bool
+finds_cliques(std::vector<std::size_t> const& comm, std::size_t k,
+              std::size_t s)
+{
+  for (std::size_t v = 0; v < k * s; ++v)
+    if (comm[v] != v / s)
+      return false;
+  return true;
+}
+
+
+int
+main()
+{
+  // Modularity of a known partition. Two triangles joined by an edge have
+  // m = 7, and each side has 3 internal edges and total degree 7.
+  {
+    graph<> g;
+    for (int i = 0; i < 6; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(0, 2);
+    g.add_edge(3, 4);
+    g.add_edge(4, 5);
+    g.add_edge(3, 5);
+    g.add_edge(2, 3);
+    std::vector<std::size_t> comm {0, 0, 0, 1, 1, 1};
+    double q = 2 * (3.0 / 7 - 0.25);
+    assert(std::abs(modularity(g, comm) - q) < 1e-12);
+    std::vector<std::size_t> one(6, 0);
+    assert(std::abs(modularity(g, one)) < 1e-12);
+
+    louvain<graph<>> lv(g);
+    lv();
+    assert(lv.communities == comm);
+    assert(std::abs(lv.modularity - q) < 1e-12);
+
+    label_propagation<graph<>> lp(g);
+    lp();
+    assert(lp.count <= 2);
+  }
+
+  // A ring of cliques is split into its cliques.
+  {
+    graph<> g = ring_of_cliques(12, 6);
+    louvain<graph<>> lv(g);
+    lv();
+    assert(lv.count == 12 && finds_cliques(lv.communities, 12, 6));
+    assert(lv.levels >= 1);
+    assert(std::abs(lv.modularity - modularity(g, lv.communities)) < 1e-9);
+
+    label_propagation<graph<>> lp(g);
+    lp();
+    assert(finds_cliques(lp.communities, 12, 6));
+
+    // Small batches give the same result.
+    louvain<graph<>> small(g);
+    small.batch = 7;
+    small();
+    assert(small.communities == lv.communities);
+  }
+
+  // Weights override structure: heavy edges between the cliques of pairs
+  // join them.
+  {
+    graph<> g = ring_of_cliques(6, 4);
+    std::vector<double> w(g.num_edges(), 1);
+    for (edge_t e = 0; e < g.num_edges(); ++e) {
+      vertex_t a = g.first(e) / 4, b = g.second(e) / 4;
+      if (std::min(a, b) % 2 == 0 && std::max(a, b) == std::min(a, b) + 1)
+        w[e] = 5;
+    }
+    louvain<graph<>, decltype(edge_label(w))> lv(g, edge_label(w));
+    lv();
+    assert(lv.count == 3);
+    for (vertex_t v = 0; v < g.num_vertices(); ++v)
+      assert(lv.communities[v] == v / 8);
+  }
+
+  // A planted partition is recovered, and results depend only on the seed.
+  {
+    graph<> g;
+    std::size_t k = 8, s = 50;
+    for (std::size_t i = 0; i < k * s; ++i)
+      g.add_vertex();
+    std::minstd_rand gen(9);
+    std::uniform_int_distribution<vertex_t> pick(0, k * s - 1);
+    for (std::size_t i = 0; i < 8 * k * s; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (i % 10)
+        v = u / s * s + v % s;
+      if (u != v && !g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    for (std::size_t seed : {1, 2}) {
+      louvain<graph<>> a(g), b(g);
+      a.seed = b.seed = seed;
+      a();
+      b();
+      assert(a.communities == b.communities);
+      assert(a.count == k);
+      for (vertex_t v = 0; v < k * s; ++v)
+        assert(a.communities[v] == v / s);
+
+      label_propagation<graph<>> c(g), d(g);
+      c.seed = d.seed = seed;
+      c();
+      d();
+      assert(c.communities == d.communities);
+      assert(modularity(g, c.communities) > 0.5);
+    }
+  }
+
+  // Bipartite components smaller than a batch do not swap labels forever.
+  {
+    graph<> g;
+    for (int i = 0; i < 8; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    for (vertex_t u = 2; u < 5; ++u)
+      for (vertex_t v = 5; v < 8; ++v)
+        g.add_edge(u, v);
+    label_propagation<graph<>> lp(g);
+    lp();
+    assert(lp.iterations < lp.max_iterations);
+    assert(lp.count == 2);
+    assert(lp.communities[0] == lp.communities[1]);
+    for (vertex_t v = 3; v < 8; ++v)
+      assert(lp.communities[v] == lp.communities[2]);
+  }
+
+  // Graphs without edges are all singletons.
+  {
+    graph<> g;
+    for (int i = 0; i < 5; ++i)
+      g.add_vertex();
+    louvain<graph<>> lv(g);
+    lv();
+    assert(lv.count == 5 && lv.modularity == 0);
+  }
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../community.hpp"
+#include "../graph.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns a value in [lo, hi] drawn from a power law with exponent a.
+double
+power_law(std::minstd_rand& gen, double lo, double hi, double a)
+{
+  std::uniform_real_distribution<double> u(0, 1);
+  double x = std::pow(lo, 1 - a), y = std::pow(hi, 1 - a);
+  return std::pow(x + (y - x) * u(gen), 1 / (1 - a));
+}
+
+// Generates a graph in the style of the LFR benchmark. Degrees and
+// community sizes follow power laws, and a fraction mu of the edges of
+// each vertex leave its community. Edges are made by matching stubs at
+// random, dropping self loops and duplicates.
+graph<>
+lfr(std::size_t n, double mu, std::vector<std::size_t>& truth,
+    std::minstd_rand& gen)
+{
+  graph<> g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  truth.assign(n, 0);
+  std::vector<std::vector<vertex_t>> inner;
+  std::vector<vertex_t> outer;
+  std::size_t c = 0;
+  for (vertex_t v = 0; v < n; ++c) {
+    std::size_t s = power_law(gen, 20, 500, 1.5);
+    inner.emplace_back();
+    for (std::size_t i = 0; i < s && v < n; ++i, ++v) {
+      truth[v] = c;
+      std::size_t d = power_law(gen, 8, 100, 2);
+      std::size_t out = std::round(mu * d);
+      for (std::size_t j = 0; j < d; ++j)
+        (j < out ? outer : inner.back()).push_back(v);
+    }
+  }
+  inner.push_back(outer);
+  for (auto& stubs : inner) {
+    std::shuffle(stubs.begin(), stubs.end(), gen);
+    for (std::size_t i = 0; i + 1 < stubs.size(); i += 2) {
+      vertex_t u = stubs[i], v = stubs[i + 1];
+      if (u != v && !g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+  }
+  return g;
+}
+
+// Returns the normalized mutual information of two partitions.
+double
+nmi(std::vector<std::size_t> const& a, std::vector<std::size_t> const& b)
+{
+  double n = a.size();
+  std::map<std::pair<std::size_t, std::size_t>, double> joint;
+  std::map<std::size_t, double> pa, pb;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    joint[{a[i], b[i]}] += 1;
+    pa[a[i]] += 1;
+    pb[b[i]] += 1;
+  }
+  double mi = 0, ha = 0, hb = 0;
+  for (auto const& x : joint)
+    mi += x.second / n * std::log(n * x.second /
+                                  (pa[x.first.first] * pb[x.first.second]));
+  for (auto const& x : pa)
+    ha -= x.second / n * std::log(x.second / n);
+  for (auto const& x : pb)
+    hb -= x.second / n * std::log(x.second / n);
+  return ha + hb > 0 ? 2 * mi / (ha + hb) : 1;
+}
+
+
+// Runs label propagation and Louvain on LFR-style graphs with increasing
+// mixing, and reports the time, the number of communities, modularity, and
+// agreement with the planted communities.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::minstd_rand gen(41);
+  for (double mu : {0.1, 0.3, 0.5}) {
+    std::vector<std::size_t> truth;
+    graph<> g = lfr(n, mu, truth, gen);
+    std::cout << "mu " << mu << ": " << n << " vertices, " << g.num_edges()
+              << " edges\n";
+
+    label_propagation<graph<>> lp(g);
+    auto start = clock::now();
+    lp();
+    ms t = clock::now() - start;
+    std::cout << "  label propagation: " << t.count() << " ms, "
+              << lp.iterations << " iterations, " << lp.count
+              << " communities, Q " << modularity(g, lp.communities)
+              << ", NMI " << nmi(truth, lp.communities) << '\n';
+
+    louvain<graph<>> lv(g);
+    start = clock::now();
+    lv();
+    t = clock::now() - start;
+    std::cout << "  louvain: " << t.count() << " ms, " << lv.levels
+              << " levels, " << lv.count << " communities, Q "
+              << lv.modularity << ", NMI " << nmi(truth, lv.communities)
+              << '\n';
+  }
+}
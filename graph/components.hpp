@@ -0,0 +1,87 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_COMPONENTS_HPP
+#define GRAPH_COMPONENTS_HPP
+
+#include "common.hpp"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Computes the strongly connected components of the directed graph g using
+// Tarjan's algorithm, and stores the component of each vertex in comp.
+// Returns the number of components.
+//
+// Components are numbered in reverse topological order of the condensed
+// graph: if there is a path from a vertex in component a to a vertex in a
+// different component b, then a > b. The search is iterative, so deep
+// graphs do not overflow the call stack.
+template<typename G>
+std::size_t
+strong_components(G const& g, std::vector<vertex_t>& comp)
+{
+  constexpr vertex_t none = std::numeric_limits<vertex_t>::max();
+
+  std::size_t n = g.num_vertices();
+  comp.assign(n, none);
+  std::vector<vertex_t> index(n, none);
+  std::vector<vertex_t> low(n);
+  std::vector<vertex_t> stack;
+  std::vector<std::pair<vertex_t, std::size_t>> calls;
+  vertex_t clock = 0;
+  std::size_t count = 0;
+
+  for (vertex_t s = 0; s < n; ++s) {
+    if (index[s] != none)
+      continue;
+    calls.emplace_back(s, 0);
+    index[s] = low[s] = clock++;
+    stack.push_back(s);
+    while (!calls.empty()) {
+      vertex_t u = calls.back().first;
+      std::size_t& i = calls.back().second;
+      auto const& out = g.out_edges(u);
+      if (i < out.size()) {
+        vertex_t v = g.target(out[i++]);
+        if (index[v] == none) {
+          index[v] = low[v] = clock++;
+          stack.push_back(v);
+          calls.emplace_back(v, 0);
+        }
+        else if (comp[v] == none && index[v] < low[u]) {
+          // v is on the stack.
+          low[u] = index[v];
+        }
+        continue;
+      }
+
+      // u is finished. If it is the root of a component, pop it.
+      calls.pop_back();
+      if (low[u] == index[u]) {
+        vertex_t v;
+        do {
+          v = stack.back();
+          stack.pop_back();
+          comp[v] = count;
+        } while (v != u);
+        ++count;
+      }
+      if (!calls.empty()) {
+        vertex_t p = calls.back().first;
+        if (low[u] < low[p])
+          low[p] = low[u];
+      }
+    }
+  }
+  return count;
+}
+
+
+} // namespace origin
+
+#endif
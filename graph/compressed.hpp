@@ -0,0 +1,277 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_COMPRESSED_HPP
+#define GRAPH_COMPRESSED_HPP
+
+#include "common.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+
+namespace origin {
+
+// Variable length integers
+//
+// Unsigned integers are written 7 bits at a time, least significant group
+// first. The high bit of each byte is set when more bytes follow, so values
+// less than 128 take a single byte.
+
+// Append the encoding of x to buf.
+inline void
+encode_varint(std::vector<unsigned char>& buf, std::uint64_t x)
+{
+  while (x >= 0x80) {
+    buf.push_back(static_cast<unsigned char>(x | 0x80));
+    x >>= 7;
+  }
+  buf.push_back(static_cast<unsigned char>(x));
+}
+
+// Decode an integer starting at p, and advance p past it.
+inline std::uint64_t
+decode_varint(unsigned char const*& p)
+{
+  std::uint64_t x = *p++;
+  if (x < 0x80)
+    return x;
+  x &= 0x7f;
+  for (int shift = 7; ; shift += 7) {
+    std::uint64_t b = *p++;
+    x |= (b & 0x7f) << shift;
+    if (b < 0x80)
+      return x;
+  }
+}
+
+// Map signed differences to unsigned integers so that values of small
+// magnitude have short encodings.
+inline std::uint64_t
+zigzag(std::int64_t x)
+{
+  return (static_cast<std::uint64_t>(x) << 1) ^ (x >> 63);
+}
+
+inline std::int64_t
+unzigzag(std::uint64_t x)
+{
+  std::int64_t sign = -static_cast<std::int64_t>(x & 1);
+  return static_cast<std::int64_t>(x >> 1) ^ sign;
+}
+
+
+// An iterator over a compressed list of neighbors, which decodes each
+// neighbor as it advances. Iterators are equal when they have the same
+// number of neighbors remaining.
+struct neighbor_iterator
+{
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = vertex_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = vertex_t const*;
+  using reference = vertex_t;
+
+  neighbor_iterator()
+    : pos(nullptr), count(0), value(0)
+  { }
+
+  neighbor_iterator(unsigned char const* p, std::size_t n, vertex_t v)
+    : pos(p), count(n), value(v)
+  { }
+
+  vertex_t operator*() const { return value; }
+
+  neighbor_iterator& operator++()
+  {
+    if (--count)
+      value += decode_varint(pos);
+    return *this;
+  }
+
+  neighbor_iterator operator++(int)
+  {
+    neighbor_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(neighbor_iterator const& x) const
+  {
+    return count == x.count;
+  }
+
+  bool operator!=(neighbor_iterator const& x) const
+  {
+    return count != x.count;
+  }
+
+  unsigned char const* pos; // The encoding of the next neighbor
+  std::size_t count;        // The number of neighbors remaining
+  vertex_t value;           // The current neighbor
+};
+
+
+// The neighbors of a vertex in a compressed graph.
+struct neighbor_range
+{
+  neighbor_iterator begin() const { return first; }
+  neighbor_iterator end() const { return neighbor_iterator(); }
+
+  bool empty() const { return first.count == 0; }
+  std::size_t size() const { return first.count; }
+
+  neighbor_iterator first;
+};
+
+
+// A read-only directed graph whose adjacency is compressed. The outgoing
+// neighbors of each vertex are sorted and stored as a byte sequence:
+//
+//    degree, zigzag(first - v), gap, gap, ...
+//
+// where each number is a varint and each gap is the difference between
+// consecutive neighbors. Neighbors of real graphs tend to be close to
+// each other, so most gaps take one or two bytes. Together with one offset
+// per vertex, this is a small fraction of the 32 bytes per edge used by
+// the edge set and incidence lists of digraph.
+//
+// Edges are not identified and edge labels are not stored. Parallel edges
+// are kept, and encode as a gap of 0.
+struct compressed_digraph
+{
+  using vertex_range = counted_range<vertex_t>;
+
+  compressed_digraph() = default;
+
+  template<typename G>
+  explicit compressed_digraph(G const& g);
+
+  // Vertex list
+  bool is_null() const { return num_vertices() == 0; }
+  std::size_t num_vertices() const { return offsets.size() - 1; }
+  vertex_range vertices() const { return vertex_range(num_vertices()); }
+
+  // Edge list
+  bool is_empty() const { return num_edges() == 0; }
+  std::size_t num_edges() const { return edges; }
+
+  // Adjacency
+  neighbor_range out_neighbors(vertex_t v) const;
+  std::size_t out_degree(vertex_t v) const;
+  bool has_edge(vertex_t u, vertex_t v) const;
+
+  // Returns the number of bytes used by the adjacency and offsets.
+  std::size_t bytes() const
+  {
+    return data.size() + offsets.size() * sizeof(std::size_t);
+  }
+
+  std::vector<std::size_t> offsets { 0 }; // The encoding of v starts here
+  std::vector<unsigned char> data;
+  std::size_t edges = 0;
+};
+
+// Compress the out edges of g, which must have out_edges and target.
+// Vertices are encoded in parallel in chunks that are then concatenated.
+template<typename G>
+compressed_digraph::compressed_digraph(G const& g)
+  : edges(g.num_edges())
+{
+  constexpr std::size_t chunk = 4096;
+  std::size_t n = g.num_vertices();
+  std::size_t nchunks = (n + chunk - 1) / chunk;
+  std::vector<std::vector<unsigned char>> bufs(nchunks);
+  offsets.resize(n + 1);
+  parallel_for_dynamic(counted_range<vertex_t>(n),
+                       [&](counted_range<vertex_t> r) {
+    std::vector<vertex_t> adj;
+    for (vertex_t v : r) {
+      std::vector<unsigned char>& buf = bufs[v / chunk];
+      offsets[v] = buf.size(); // Relative to the chunk
+      adj.clear();
+      for (auto e : g.out_edges(v))
+        adj.push_back(g.target(e));
+      std::sort(adj.begin(), adj.end());
+      encode_varint(buf, adj.size());
+      if (adj.empty())
+        continue;
+      encode_varint(buf, zigzag(std::int64_t(adj[0]) - std::int64_t(v)));
+      for (std::size_t i = 1; i < adj.size(); ++i)
+        encode_varint(buf, adj[i] - adj[i - 1]);
+    }
+  }, chunk);
+
+  // Make offsets absolute and concatenate the chunks.
+  std::size_t base = 0;
+  for (std::size_t c = 0; c < nchunks; ++c) {
+    std::size_t last = std::min(n, (c + 1) * chunk);
+    for (vertex_t v = c * chunk; v < last; ++v)
+      offsets[v] += base;
+    base += bufs[c].size();
+  }
+  offsets[n] = base;
+  data.reserve(base);
+  for (auto& buf : bufs) {
+    data.insert(data.end(), buf.begin(), buf.end());
+    std::vector<unsigned char>().swap(buf);
+  }
+}
+
+// Returns the sorted outgoing neighbors of v.
+inline neighbor_range
+compressed_digraph::out_neighbors(vertex_t v) const
+{
+  unsigned char const* p = data.data() + offsets[v];
+  std::size_t n = decode_varint(p);
+  if (n == 0)
+    return {};
+  vertex_t first = v + unzigzag(decode_varint(p));
+  return {neighbor_iterator(p, n, first)};
+}
+
+// Returns the out degree of v.
+inline std::size_t
+compressed_digraph::out_degree(vertex_t v) const
+{
+  unsigned char const* p = data.data() + offsets[v];
+  return decode_varint(p);
+}
+
+// Returns true if the edge (u, v) exists. This decodes the neighbors of u
+// up to v.
+inline bool
+compressed_digraph::has_edge(vertex_t u, vertex_t v) const
+{
+  for (vertex_t w : out_neighbors(u)) {
+    if (w >= v)
+      return w == v;
+  }
+  return false;
+}
+
+
+// Call f(v) for each outgoing neighbor of u in increasing order.
+template<typename F>
+void
+for_each_out_neighbor(compressed_digraph const& g, vertex_t u, F f)
+{
+  unsigned char const* p = g.data.data() + g.offsets[u];
+  std::size_t n = decode_varint(p);
+  if (n == 0)
+    return;
+  vertex_t v = u + unzigzag(decode_varint(p));
+  f(v);
+  while (--n) {
+    v += decode_varint(p);
+    f(v);
+  }
+}
+
+
+} // namespace origin
+
+#endif
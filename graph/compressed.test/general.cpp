@@ -0,0 +1,76 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../compressed.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  // Round trip integers through their encodings.
+  std::vector<unsigned char> buf;
+  std::uint64_t xs[] {0, 1, 127, 128, 300, 16383, 16384, 1ull << 40, ~0ull};
+  for (std::uint64_t x : xs)
+    encode_varint(buf, x);
+  assert(buf.size() == 1 + 1 + 1 + 2 + 2 + 2 + 3 + 6 + 10);
+  unsigned char const* p = buf.data();
+  for (std::uint64_t x : xs)
+    assert(decode_varint(p) == x);
+  assert(p == buf.data() + buf.size());
+  for (std::int64_t x : {0l, 1l, -1l, 1000l, -1000l})
+    assert(unzigzag(zigzag(x)) == x);
+  assert(zigzag(-1) == 1 && zigzag(1) == 2);
+
+  // Neighbors far before and after each vertex, loops, and vertices with
+  // no outgoing edges.
+  digraph<> g;
+  std::size_t n = 20000;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(7);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  for (int i = 0; i < 100000; ++i) {
+    vertex_t u = pick(gen) / 2, v = pick(gen);
+    if (!g.has_edge(u, v))
+      g.add_edge(u, v);
+  }
+  if (!g.has_edge(0, 0))
+    g.add_edge(0, 0);
+
+  compressed_digraph c(g);
+  assert(c.num_vertices() == n);
+  assert(c.num_edges() == g.num_edges());
+  std::size_t m = 0;
+  for (vertex_t u : g.vertices()) {
+    std::vector<vertex_t> expect;
+    for (edge_t e : g.out_edges(u))
+      expect.push_back(g.target(e));
+    std::sort(expect.begin(), expect.end());
+
+    std::vector<vertex_t> got(c.out_neighbors(u).begin(),
+                              c.out_neighbors(u).end());
+    assert(got == expect);
+    assert(c.out_degree(u) == expect.size());
+    assert(c.out_neighbors(u).size() == expect.size());
+
+    got.clear();
+    for_each_out_neighbor(c, u, [&got](vertex_t v) { got.push_back(v); });
+    assert(got == expect);
+
+    for (vertex_t v : expect)
+      assert(c.has_edge(u, v));
+    m += expect.size();
+  }
+  assert(m == c.num_edges());
+  assert(c.has_edge(0, 0));
+  assert(c.out_neighbors(n - 1).empty());
+  assert(!c.has_edge(n - 1, 0));
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../compressed.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Returns the number of edges examined by breadth-first searches from
+// every unvisited vertex, where neighbors(u, f) calls f on each neighbor.
+template<typename F>
+std::size_t
+traverse(std::size_t n, F neighbors)
+{
+  std::vector<char> seen(n, 0);
+  std::vector<vertex_t> queue;
+  queue.reserve(n);
+  std::size_t edges = 0;
+  for (vertex_t s = 0; s < n; ++s) {
+    if (seen[s])
+      continue;
+    seen[s] = 1;
+    queue.clear();
+    queue.push_back(s);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      neighbors(queue[i], [&](vertex_t v) {
+        ++edges;
+        if (!seen[v]) {
+          seen[v] = 1;
+          queue.push_back(v);
+        }
+      });
+    }
+  }
+  return edges;
+}
+
+
+// Compares traversal of a digraph with traversal of its compression. Most
+// edges of the generated graph connect nearby vertices, as in web and
+// road graphs whose vertices are numbered by a locality order; the rest
+// are uniformly random.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::size_t d = argc > 2 ? std::atoi(argv[2]) : 8;
+  double local = argc > 3 ? std::atof(argv[3]) : 0.9;
+
+  digraph<> g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(29);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::geometric_distribution<vertex_t> near(0.05);
+  std::bernoulli_distribution coin(local);
+  for (vertex_t u = 0; u < n; ++u) {
+    for (std::size_t i = 0; i < d; ++i) {
+      vertex_t v = coin(gen) ? (u + 1 + near(gen)) % n : pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+  }
+
+  auto start = clock::now();
+  compressed_digraph c(g);
+  ms t0 = clock::now() - start;
+
+  double m = c.num_edges();
+  std::cout << n << " vertices, " << c.num_edges() << " edges\n";
+  std::cout << "compress: " << t0.count() << " ms\n";
+  std::cout << "digraph: " << 8 * 32 << " bits/edge\n";
+  std::cout << "compressed: " << 8 * c.bytes() / m << " bits/edge ("
+            << 8 * c.data.size() / m << " without offsets)\n";
+
+  auto time = [&](char const* name, auto neighbors) {
+    auto start = clock::now();
+    std::size_t k = traverse(n, neighbors);
+    ms t = clock::now() - start;
+    std::cout << name << ": " << t.count() << " ms, "
+              << k / t.count() / 1e3 << " M edges/s\n";
+  };
+  time("digraph out_edges", [&g](vertex_t u, auto f) {
+    for (edge_t e : g.out_edges(u))
+      f(g.target(e));
+  });
+  time("compressed out_neighbors", [&c](vertex_t u, auto f) {
+    for (vertex_t v : c.out_neighbors(u))
+      f(v);
+  });
+  time("compressed for_each_out_neighbor", [&c](vertex_t u, auto f) {
+    for_each_out_neighbor(c, u, f);
+  });
+}
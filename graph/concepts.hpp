@@ -0,0 +1,160 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_CONCEPTS_HPP
+#define GRAPH_CONCEPTS_HPP
+
+#include "common.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+
+namespace origin {
+
+// Graph concepts
+//
+// These concepts describe the interfaces that generic algorithms use, so
+// that a type that does not provide them is rejected where the algorithm
+// is named, rather than deep inside its instantiation. Each concept states
+// only syntactic requirements. The complexity of each operation is part of
+// its documentation; unless noted, operations should take constant time.
+//
+//    vertex_list_graph           num_vertices() and a range vertices().
+//                                Vertices are identified by values in
+//                                [0, num_vertices()), which algorithms use
+//                                to size their labels.
+//    edge_list_graph             A range edges().
+//    directed_graph              source(e) and target(e).
+//    undirected_graph            first(e), second(e), and opposite(e, v).
+//    incidence_graph             A directed graph with ranges out_edges(v)
+//                                and out_degree(v).
+//    bidirectional_graph         An incidence graph with in_edges(v) and
+//                                in_degree(v).
+//    undirected_incidence_graph  An undirected graph with edges(v) and
+//                                degree(v).
+//    adjacency_graph             A range of vertices out_neighbors(v).
+//    edge_query_graph            has_edge(u, v), which may be linear in the
+//                                degree of u.
+//
+// A graph may model adjacency_graph without identifying its edges, as the
+// compressed graph does. Algorithms that only follow edges prefer
+// out_neighbors when it is available, since it avoids looking up the
+// target of each edge.
+
+
+// A type whose elements, given by begin and end, convert to T.
+template<typename R, typename T>
+concept bool range_of = requires(R const& r) {
+  { *std::begin(r) } -> T;
+  { std::end(r) };
+};
+
+template<typename G>
+concept bool vertex_list_graph = requires(G const& g) {
+  { g.num_vertices() } -> std::size_t;
+  requires range_of<decltype(g.vertices()), vertex_t>;
+};
+
+template<typename G>
+concept bool edge_list_graph = requires(G const& g) {
+  requires range_of<decltype(g.edges()), edge_t>;
+};
+
+template<typename G>
+concept bool directed_graph = requires(G const& g, edge_t e) {
+  { g.source(e) } -> vertex_t;
+  { g.target(e) } -> vertex_t;
+};
+
+template<typename G>
+concept bool undirected_graph = requires(G const& g, edge_t e, vertex_t v) {
+  { g.first(e) } -> vertex_t;
+  { g.second(e) } -> vertex_t;
+  { g.opposite(e, v) } -> vertex_t;
+};
+
+template<typename G>
+concept bool incidence_graph =
+  directed_graph<G> && requires(G const& g, vertex_t v) {
+    requires range_of<decltype(g.out_edges(v)), edge_t>;
+    { g.out_degree(v) } -> std::size_t;
+  };
+
+template<typename G>
+concept bool bidirectional_graph =
+  incidence_graph<G> && requires(G const& g, vertex_t v) {
+    requires range_of<decltype(g.in_edges(v)), edge_t>;
+    { g.in_degree(v) } -> std::size_t;
+  };
+
+template<typename G>
+concept bool undirected_incidence_graph =
+  undirected_graph<G> && requires(G const& g, vertex_t v) {
+    requires range_of<decltype(g.edges(v)), edge_t>;
+    { g.degree(v) } -> std::size_t;
+  };
+
+template<typename G>
+concept bool adjacency_graph = requires(G const& g, vertex_t v) {
+  requires range_of<decltype(g.out_neighbors(v)), vertex_t>;
+};
+
+template<typename G>
+concept bool edge_query_graph = requires(G const& g, vertex_t u, vertex_t v) {
+  { g.has_edge(u, v) } -> bool;
+};
+
+
+// Label concepts
+//
+// A vertex property maps vertices to values, as do the functions returned
+// by vertex_label. A relation compares two values of some type.
+
+template<typename L>
+concept bool vertex_property = requires(L l, vertex_t v) {
+  { l(v) };
+};
+
+template<typename L>
+concept bool edge_property = requires(L l, edge_t e) {
+  { l(e) };
+};
+
+// The type of the value of a vertex property.
+template<typename L>
+using vertex_value_type =
+  std::decay_t<decltype(std::declval<L&>()(vertex_t()))>;
+
+// The type of the value of an edge property.
+template<typename L>
+using edge_value_type =
+  std::decay_t<decltype(std::declval<L&>()(edge_t()))>;
+
+template<typename R, typename T>
+concept bool relation = requires(R r, T const& a, T const& b) {
+  { r(a, b) } -> bool;
+};
+
+// Call f(v, e) for each edge e leaving u, where v is the other end of e.
+// Directed graphs follow outgoing edges.
+template<typename G, typename F>
+  requires incidence_graph<G> || undirected_incidence_graph<G>
+inline void
+for_each_successor(G const& g, vertex_t u, F f)
+{
+  if constexpr (incidence_graph<G>) {
+    for (edge_t e : g.out_edges(u))
+      f(g.target(e), e);
+  }
+  else {
+    for (edge_t e : g.edges(u))
+      f(g.opposite(e, u), e);
+  }
+}
+
+
+} // namespace origin
+
+#endif
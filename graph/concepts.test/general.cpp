@@ -0,0 +1,77 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../compressed.hpp"
+#include "../view.hpp"
+#include "../dfs.hpp"
+#include "../queue.hpp"
+
+#include <cassert>
+#include <functional>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns true if directed_dfs can be instantiated for G.
+template<typename G>
+constexpr bool searchable() { return false; }
+
+template<typename G>
+  requires requires { typename directed_dfs<G>; }
+constexpr bool searchable() { return true; }
+
+
+int
+main()
+{
+  using D = digraph<>;
+  using U = graph<>;
+
+  static_assert(vertex_list_graph<D> && edge_list_graph<D>);
+  static_assert(bidirectional_graph<D> && edge_query_graph<D>);
+  static_assert(!adjacency_graph<D> && !undirected_graph<D>);
+
+  static_assert(vertex_list_graph<U> && undirected_incidence_graph<U>);
+  static_assert(!incidence_graph<U> && !directed_graph<U>);
+
+  static_assert(vertex_list_graph<compressed_digraph>);
+  static_assert(adjacency_graph<compressed_digraph>);
+  static_assert(!incidence_graph<compressed_digraph>);
+
+  static_assert(bidirectional_graph<reverse_view<D>>);
+  static_assert(bidirectional_graph<filtered_view<D>>);
+  static_assert(undirected_incidence_graph<undirected_view<D>>);
+
+  static_assert(searchable<D>() && searchable<compressed_digraph>());
+  static_assert(!searchable<U>() && !searchable<int>());
+
+  std::vector<int> values {3, 1, 2};
+  auto value = vertex_label(values);
+  static_assert(vertex_property<decltype(value)>);
+  static_assert(relation<std::less<int>, vertex_value_type<decltype(value)>>);
+  compare_vertex_label<decltype(value), std::less<int>> comp(value);
+  assert(comp(1, 0) && !comp(0, 2));
+
+  // A search of a compressed graph follows its neighbors directly, and
+  // agrees with a search of the graph it was built from.
+  D g;
+  for (int i = 0; i < 6; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1);
+  g.add_edge(1, 2);
+  g.add_edge(2, 0);
+  g.add_edge(3, 4);
+  g.add_edge(0, 4);
+  compressed_digraph c(g);
+
+  directed_dfs<D> d1(g);
+  d1();
+  directed_dfs<compressed_digraph> d2(c);
+  d2();
+  assert(d1.parents == d2.parents);
+  assert(d1.times.post_times == d2.times.post_times);
+}
@@ -0,0 +1,604 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_CONCURRENT_HPP
+#define GRAPH_CONCURRENT_HPP
+
+#include "utility.hpp"
+#include "common.hpp"
+#include "digraph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+namespace origin {
+
+// A sequence whose elements never move. Storage is allocated in segments
+// whose sizes double, so appending never relocates existing elements and
+// references to them remain valid for the lifetime of the sequence.
+//
+// Only one thread may append to the sequence. Other threads may access any
+// element whose construction happens before (e.g., is published by a
+// release store) the access.
+template<typename T, std::size_t B = 64>
+struct segmented_vector
+{
+  static_assert((B & (B - 1)) == 0, "segment size must be a power of 2");
+
+  static constexpr std::size_t max_segments = 48;
+
+  segmented_vector()
+    : segments(), count(0)
+  { }
+
+  segmented_vector(segmented_vector const&) = delete;
+  segmented_vector& operator=(segmented_vector const&) = delete;
+
+  ~segmented_vector();
+
+  std::size_t size() const { return count; }
+
+  T const& operator[](std::size_t n) const;
+  T& operator[](std::size_t n);
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args);
+
+  // Returns the segment containing the nth element and its offset
+  // within that segment.
+  static std::size_t segment(std::size_t n);
+  static std::size_t offset(std::size_t n, std::size_t k);
+
+  T* segments[max_segments];
+  std::size_t count;
+};
+
+template<typename T, std::size_t B>
+segmented_vector<T, B>::~segmented_vector()
+{
+  for (std::size_t i = 0; i < count; ++i)
+    (*this)[i].~T();
+  for (T* s : segments)
+    ::operator delete(s);
+}
+
+template<typename T, std::size_t B>
+inline std::size_t
+segmented_vector<T, B>::segment(std::size_t n)
+{
+  // Segment k holds B * 2^k elements starting at B * (2^k - 1).
+  std::size_t x = n / B + 1;
+  return 63 - __builtin_clzll(x);
+}
+
+template<typename T, std::size_t B>
+inline std::size_t
+segmented_vector<T, B>::offset(std::size_t n, std::size_t k)
+{
+  return n - B * ((std::size_t(1) << k) - 1);
+}
+
+template<typename T, std::size_t B>
+inline T const&
+segmented_vector<T, B>::operator[](std::size_t n) const
+{
+  std::size_t k = segment(n);
+  return segments[k][offset(n, k)];
+}
+
+template<typename T, std::size_t B>
+inline T&
+segmented_vector<T, B>::operator[](std::size_t n)
+{
+  std::size_t k = segment(n);
+  return segments[k][offset(n, k)];
+}
+
+// Construct a new element at the end of the sequence.
+template<typename T, std::size_t B>
+template<typename... Args>
+T&
+segmented_vector<T, B>::emplace_back(Args&&... args)
+{
+  std::size_t k = segment(count);
+  assert(k < max_segments);
+  if (!segments[k]) {
+    void* p = ::operator new(sizeof(T) * (B << k));
+    segments[k] = static_cast<T*>(p);
+  }
+  T* p = segments[k] + offset(count, k);
+  new (p) T(std::forward<Args>(args)...);
+  ++count;
+  return *p;
+}
+
+
+// An append-only list of edges that never moves. The list is a chain of
+// blocks whose capacities double. Edges must be appended in increasing
+// order, which allows readers to truncate the list at a snapshot bound.
+//
+// Only one thread may append to the list. Readers observe the appended
+// prefix through the size of the list.
+struct stable_edge_list
+{
+  struct block
+  {
+    std::size_t capacity;
+    block* next;
+    edge_t items[1];
+  };
+
+  static block* make_block(std::size_t n);
+
+  stable_edge_list()
+    : head(nullptr), tail(nullptr), used(0), count(0)
+  { }
+
+  stable_edge_list(stable_edge_list const&) = delete;
+  stable_edge_list& operator=(stable_edge_list const&) = delete;
+
+  ~stable_edge_list();
+
+  void push_back(edge_t e);
+
+  // An iterator over the edges of a list that are less than a bound.
+  struct iterator
+  {
+    using value_type = edge_t;
+    using reference = edge_t;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    iterator()
+      : blk(nullptr), pos(0), left(0), bound(0)
+    { }
+
+    iterator(block const* b, std::size_t n, edge_t x)
+      : blk(b), pos(0), left(n), bound(x)
+    { }
+
+    bool at_end() const { return left == 0 || blk->items[pos] >= bound; }
+
+    edge_t operator*() const { return blk->items[pos]; }
+
+    iterator& operator++()
+    {
+      --left;
+      if (left && ++pos == blk->capacity) {
+        blk = blk->next;
+        pos = 0;
+      }
+      return *this;
+    }
+
+    iterator operator++(int) { auto x = *this; ++*this; return x; }
+
+    bool operator==(iterator const& i) const
+    {
+      if (at_end() || i.at_end())
+        return at_end() == i.at_end();
+      return blk == i.blk && pos == i.pos;
+    }
+
+    bool operator!=(iterator const& i) const { return !(*this == i); }
+
+    block const* blk;
+    std::size_t pos;
+    std::size_t left;
+    edge_t bound;
+  };
+
+  // The edges of a list that are less than a bound.
+  struct range
+  {
+    iterator begin() const { return first; }
+    iterator end() const { return iterator(); }
+
+    bool empty() const { return first.at_end(); }
+    std::size_t size() const;
+
+    iterator first;
+  };
+
+  range edges(edge_t bound) const;
+
+  block* head;                    // First block (readers)
+  block* tail;                    // Last block (writer only)
+  std::size_t used;               // Items in the last block (writer only)
+  std::atomic<std::size_t> count; // Number of published items
+};
+
+inline auto
+stable_edge_list::make_block(std::size_t n) -> block*
+{
+  void* p = ::operator new(sizeof(block) + (n - 1) * sizeof(edge_t));
+  block* b = static_cast<block*>(p);
+  b->capacity = n;
+  b->next = nullptr;
+  return b;
+}
+
+inline
+stable_edge_list::~stable_edge_list()
+{
+  while (head) {
+    block* b = head;
+    head = head->next;
+    ::operator delete(b);
+  }
+}
+
+// Append e to the list. The edge is visible to readers that subsequently
+// acquire the size of the list.
+inline void
+stable_edge_list::push_back(edge_t e)
+{
+  assert(!tail || e > tail->items[used - 1]);
+  if (!tail) {
+    head = tail = make_block(4);
+    used = 0;
+  }
+  else if (used == tail->capacity) {
+    block* b = make_block(tail->capacity * 2);
+    tail->next = b;
+    tail = b;
+    used = 0;
+  }
+  tail->items[used++] = e;
+  count.store(count.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+}
+
+// Returns the edges in the list that are less than bound. The head is only
+// read once an item is published, since the writer sets it for the first.
+inline auto
+stable_edge_list::edges(edge_t bound) const -> range
+{
+  std::size_t n = count.load(std::memory_order_acquire);
+  if (n == 0)
+    return range{iterator()};
+  return range{iterator(head, n, bound)};
+}
+
+// Returns the number of edges in the range. Whole blocks are skipped when
+// possible, so this is logarithmic in the length of the list.
+inline std::size_t
+stable_edge_list::range::size() const
+{
+  iterator i = first;
+  std::size_t n = 0;
+  while (!i.at_end()) {
+    std::size_t rest = std::min(i.left, i.blk->capacity - i.pos);
+    if (i.blk->items[i.pos + rest - 1] < i.bound) {
+      n += rest;
+      i.left -= rest;
+      if (i.left) {
+        i.blk = i.blk->next;
+        i.pos = 0;
+      }
+    }
+    else {
+      edge_t const* p = i.blk->items + i.pos;
+      n += std::lower_bound(p, p + rest, i.bound) - p;
+      break;
+    }
+  }
+  return n;
+}
+
+
+// A vertex of a concurrent digraph.
+template<typename T = empty>
+struct stable_vertex
+{
+  stable_vertex() = default;
+
+  stable_vertex(T const& t)
+    : out_(), in_(), data(t)
+  { }
+
+  stable_edge_list out_;
+  stable_edge_list in_;
+  T data;
+};
+
+// An unlabeled vertex of a concurrent digraph.
+template<>
+struct stable_vertex<empty>
+{
+  stable_vertex() = default;
+
+  stable_vertex(empty const&)
+    : out_(), in_()
+  { }
+
+  stable_edge_list out_;
+  stable_edge_list in_;
+};
+
+
+template<typename V, typename E>
+struct digraph_snapshot;
+
+
+// A directed graph that allows a single writer to grow the graph while
+// any number of readers traverse it without locking.
+//
+// Vertices, edges, and incidence lists are stored in append-only storage
+// that never moves. Modifications are not visible to readers until the
+// writer calls publish(). Readers obtain an immutable view of the most
+// recently published graph by calling snapshot(). Because storage is never
+// reclaimed, snapshots remain valid for the lifetime of the graph.
+//
+// Only the size of the latest published graph is kept. The vertex and edge
+// counts are published together under a sequence lock: the sequence number
+// is odd while the writer updates them, and readers retry if it changes
+// while they read.
+template<typename V = empty, typename E = empty>
+struct concurrent_digraph
+{
+  using vertex_type = stable_vertex<V>;
+  using vertex_set = segmented_vector<vertex_type>;
+
+  using edge_type = directed_edge<E>;
+  using edge_set = segmented_vector<edge_type>;
+
+  using snapshot_type = digraph_snapshot<V, E>;
+
+  concurrent_digraph();
+
+  // Writer interface
+  std::size_t num_vertices() const { return verts_.size(); }
+  std::size_t num_edges() const { return edges_.size(); }
+
+  vertex_t add_vertex();
+  vertex_t add_vertex(V const&);
+
+  edge_t add_edge(vertex_t, vertex_t);
+  edge_t add_edge(vertex_t, vertex_t, E const&);
+
+  void publish();
+
+  // Reader interface
+  snapshot_type snapshot() const;
+
+  vertex_set verts_;
+  edge_set edges_;
+
+  // The size of the published graph.
+  std::atomic<std::size_t> sequence_;
+  std::atomic<std::size_t> published_vertices_;
+  std::atomic<std::size_t> published_edges_;
+};
+
+template<typename V, typename E>
+concurrent_digraph<V, E>::concurrent_digraph()
+  : sequence_(0), published_vertices_(0), published_edges_(0)
+{ }
+
+template<typename V, typename E>
+vertex_t
+concurrent_digraph<V, E>::add_vertex()
+{
+  verts_.emplace_back();
+  return verts_.size() - 1;
+}
+
+template<typename V, typename E>
+vertex_t
+concurrent_digraph<V, E>::add_vertex(V const& v)
+{
+  verts_.emplace_back(v);
+  return verts_.size() - 1;
+}
+
+template<typename V, typename E>
+edge_t
+concurrent_digraph<V, E>::add_edge(vertex_t u, vertex_t v)
+{
+  assert(u < num_vertices() && v < num_vertices());
+  edges_.emplace_back(u, v);
+  edge_t e = edges_.size() - 1;
+  verts_[u].out_.push_back(e);
+  verts_[v].in_.push_back(e);
+  return e;
+}
+
+template<typename V, typename E>
+edge_t
+concurrent_digraph<V, E>::add_edge(vertex_t u, vertex_t v, E const& x)
+{
+  assert(u < num_vertices() && v < num_vertices());
+  edges_.emplace_back(u, v, x);
+  edge_t e = edges_.size() - 1;
+  verts_[u].out_.push_back(e);
+  verts_[v].in_.push_back(e);
+  return e;
+}
+
+// Make all previous modifications visible to readers.
+template<typename V, typename E>
+void
+concurrent_digraph<V, E>::publish()
+{
+  std::size_t seq = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(seq + 1, std::memory_order_relaxed);
+  published_vertices_.store(num_vertices(), std::memory_order_release);
+  published_edges_.store(num_edges(), std::memory_order_release);
+  sequence_.store(seq + 2, std::memory_order_release);
+}
+
+// Returns a view of the most recently published graph. If a count was
+// stored by a later publish, the acquire that reads it also sees the odd
+// sequence number stored before it, so the read is retried.
+template<typename V, typename E>
+auto
+concurrent_digraph<V, E>::snapshot() const -> snapshot_type
+{
+  while (true) {
+    std::size_t seq = sequence_.load(std::memory_order_acquire);
+    if (seq % 2)
+      continue;
+    std::size_t nv = published_vertices_.load(std::memory_order_acquire);
+    std::size_t ne = published_edges_.load(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == seq)
+      return snapshot_type(*this, nv, ne);
+  }
+}
+
+
+// An immutable view of a concurrent digraph, as of some call to publish().
+// Snapshots are cheap to copy and may be used concurrently with the writer.
+template<typename V = empty, typename E = empty>
+struct digraph_snapshot
+{
+  using graph_type = concurrent_digraph<V, E>;
+
+  using vertex_iterator = counted_iterator<vertex_t>;
+  using vertex_range = counted_range<vertex_t>;
+
+  using edge_iterator = counted_iterator<edge_t>;
+  using edge_range = counted_range<edge_t>;
+
+  using incidence_range = stable_edge_list::range;
+
+  digraph_snapshot(graph_type const& g, std::size_t nv, std::size_t ne)
+    : graph(&g), nv(nv), ne(ne)
+  { }
+
+  // Vertex list
+  bool is_null() const { return nv == 0; }
+  std::size_t num_vertices() const { return nv; }
+
+  vertex_range vertices() const { return vertex_range(nv); }
+  vertex_iterator begin_vertices() const { return vertex_iterator(0); }
+  vertex_iterator end_vertices() const { return vertex_iterator(nv); }
+
+  // Edge list
+  bool is_empty() const { return ne == 0; }
+  std::size_t num_edges() const { return ne; }
+
+  edge_range edges() const { return edge_range(ne); }
+  edge_iterator begin_edges() const { return edge_iterator(0); }
+  edge_iterator end_edges() const { return edge_iterator(ne); }
+
+  // Incidence list
+  incidence_range out_edges(vertex_t v) const;
+  incidence_range in_edges(vertex_t v) const;
+
+  std::size_t out_degree(vertex_t v) const;
+  std::size_t in_degree(vertex_t v) const;
+  std::size_t degree(vertex_t v) const;
+
+  edge_iterator find_edge(vertex_t, vertex_t) const;
+  bool has_edge(vertex_t, vertex_t) const;
+  edge_t edge(vertex_t, vertex_t) const;
+
+  vertex_t source(edge_t e) const;
+  vertex_t target(edge_t e) const;
+
+  graph_type const* graph;
+  std::size_t nv;
+  std::size_t ne;
+};
+
+// Returns the outgoing edges of v.
+template<typename V, typename E>
+auto
+digraph_snapshot<V, E>::out_edges(vertex_t v) const -> incidence_range
+{
+  assert(v < nv);
+  return graph->verts_[v].out_.edges(ne);
+}
+
+// Returns the incoming edges of v.
+template<typename V, typename E>
+auto
+digraph_snapshot<V, E>::in_edges(vertex_t v) const -> incidence_range
+{
+  assert(v < nv);
+  return graph->verts_[v].in_.edges(ne);
+}
+
+// Returns the out degree of v. This is logarithmic in the degree of v.
+template<typename V, typename E>
+std::size_t
+digraph_snapshot<V, E>::out_degree(vertex_t v) const
+{
+  return out_edges(v).size();
+}
+
+// Returns the in degree of v. This is logarithmic in the degree of v.
+template<typename V, typename E>
+std::size_t
+digraph_snapshot<V, E>::in_degree(vertex_t v) const
+{
+  return in_edges(v).size();
+}
+
+// Returns the (total) degree of v.
+template<typename V, typename E>
+std::size_t
+digraph_snapshot<V, E>::degree(vertex_t v) const
+{
+  return out_degree(v) + in_degree(v);
+}
+
+// Returns an iterator to the edge (u, v) if it exists. Otherwise, returns
+// end_edges().
+template<typename V, typename E>
+auto
+digraph_snapshot<V, E>::find_edge(vertex_t u, vertex_t v) const
+  -> edge_iterator
+{
+  for (edge_t e : out_edges(u)) {
+    if (target(e) == v)
+      return begin_edges() + e;
+  }
+  return end_edges();
+}
+
+// Returns true if the edge (u, v) exists.
+template<typename V, typename E>
+bool
+digraph_snapshot<V, E>::has_edge(vertex_t u, vertex_t v) const
+{
+  return find_edge(u, v) != end_edges();
+}
+
+// Assuming (u, v) exists, returns that edge.
+template<typename V, typename E>
+edge_t
+digraph_snapshot<V, E>::edge(vertex_t u, vertex_t v) const
+{
+  assert(has_edge(u, v));
+  return *find_edge(u, v);
+}
+
+// In the edge (u, v), returns u.
+template<typename V, typename E>
+vertex_t
+digraph_snapshot<V, E>::source(edge_t e) const
+{
+  assert(e < ne);
+  return graph->edges_[e].source();
+}
+
+// In the edge (u, v), returns v.
+template<typename V, typename E>
+vertex_t
+digraph_snapshot<V, E>::target(edge_t e) const
+{
+  assert(e < ne);
+  return graph->edges_[e].target();
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,126 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../concurrent.hpp"
+#include "../dfs.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+
+using namespace origin;
+
+
+using G = concurrent_digraph<int, int>;
+using S = G::snapshot_type;
+
+
+// Verify that a snapshot is internally consistent.
+void
+check(S const& s)
+{
+  std::size_t out = 0;
+  std::size_t in = 0;
+  for (vertex_t v : s.vertices()) {
+    for (edge_t e : s.out_edges(v)) {
+      assert(e < s.num_edges());
+      assert(s.source(e) == v);
+      ++out;
+    }
+    for (edge_t e : s.in_edges(v)) {
+      assert(e < s.num_edges());
+      assert(s.target(e) == v);
+      ++in;
+    }
+    assert(s.out_degree(v) + s.in_degree(v) == s.degree(v));
+  }
+  assert(out == s.num_edges());
+  assert(in == s.num_edges());
+  for (edge_t e : s.edges()) {
+    assert(s.source(e) < s.num_vertices());
+    assert(s.target(e) < s.num_vertices());
+    assert(s.graph->edges_[e].data == int(e));
+  }
+}
+
+
+int
+main()
+{
+  segmented_vector<int, 4> seq;
+  for (int i = 0; i < 1000; ++i)
+    seq.emplace_back(i);
+  for (int i = 0; i < 1000; ++i)
+    assert(seq[i] == i);
+  int* p = &seq[3];
+
+  G g;
+  assert(g.snapshot().is_null());
+
+  // Unpublished changes are not visible.
+  g.add_vertex(0);
+  g.add_vertex(1);
+  g.add_edge(0, 1, 0);
+  assert(g.snapshot().is_null());
+  g.publish();
+  S s0 = g.snapshot();
+  assert(s0.num_vertices() == 2);
+  assert(s0.num_edges() == 1);
+  assert(s0.has_edge(0, 1));
+  assert(!s0.has_edge(1, 0));
+
+  // Later edges do not appear in earlier snapshots.
+  g.add_edge(1, 0, 1);
+  for (int i = 0; i < 40; ++i)
+    g.add_edge(0, 0, 2 + i);
+  g.publish();
+  assert(s0.out_degree(0) == 1);
+  assert(s0.out_degree(1) == 0);
+  assert(!s0.has_edge(1, 0));
+  S s1 = g.snapshot();
+  assert(s1.out_degree(0) == 41);
+  assert(s1.in_degree(0) == 41);
+  assert(s1.has_edge(1, 0));
+  check(s0);
+  check(s1);
+
+  // A writer grows the graph while readers search it.
+  const int n = 20000;
+  std::atomic<bool> done(false);
+  std::thread writer([&g, &done]() {
+    for (int i = 2; i < n; ++i) {
+      vertex_t v = g.add_vertex(i);
+      g.add_edge(v - 1, v, g.num_edges());
+      g.add_edge(v, v / 2, g.num_edges());
+      if (i % 64 == 0)
+        g.publish();
+    }
+    g.publish();
+    done = true;
+  });
+
+  auto read = [&g, &done]() {
+    std::size_t last = 0;
+    while (!done) {
+      S s = g.snapshot();
+      assert(s.num_edges() >= last);
+      last = s.num_edges();
+      check(s);
+
+      directed_dfs<S const, two_bit_color_map, no_timestamps> dfs(s);
+      dfs.search(vertex_label(dfs.colors), vertex_label(dfs.parents));
+    }
+  };
+  std::thread r1(read);
+  std::thread r2(read);
+
+  writer.join();
+  r1.join();
+  r2.join();
+
+  S s = g.snapshot();
+  assert(s.num_vertices() == n);
+  check(s);
+  assert(*p == 3);
+}
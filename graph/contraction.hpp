@@ -0,0 +1,575 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_CONTRACTION_HPP
+#define GRAPH_CONTRACTION_HPP
+
+#include "common.hpp"
+#include "dijkstra.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+
+namespace origin {
+
+// A list of weighted arcs for each vertex, stored contiguously.
+template<typename T>
+struct arc_array
+{
+  std::size_t num_vertices() const { return offsets.size() - 1; }
+  std::size_t num_arcs() const { return heads.size(); }
+
+  // Returns the indexes of the arcs of v.
+  counted_range<std::size_t> arcs(vertex_t v) const
+  {
+    return {offsets[v], offsets[v + 1]};
+  }
+
+  std::vector<std::size_t> offsets;
+  std::vector<vertex_t> heads;
+  std::vector<T> weights;
+};
+
+
+// A contraction hierarchy over a weighted directed graph. Every vertex has
+// a rank, which is the order in which it was contracted. The hierarchy
+// stores, for each vertex v, the upward arcs (v, w) leaving v and the
+// upward arcs (u, v) entering v, where u and w outrank v. These include
+// the shortcuts added during contraction.
+//
+// A hierarchy is produced by contraction_builder and queried with
+// contraction_query. It can be saved and loaded so that preprocessing can
+// be done once, offline.
+template<typename T>
+struct contraction_hierarchy
+{
+  using weight_type = T;
+
+  std::size_t num_vertices() const { return ranks.size(); }
+  std::size_t num_arcs() const { return up.num_arcs() + down.num_arcs(); }
+
+  bool save(std::ostream& os) const;
+  bool load(std::istream& is);
+
+  std::vector<std::size_t> ranks; // The contraction order
+  arc_array<T> up;                // Upward arcs (v, w), stored with v
+  arc_array<T> down;              // Upward arcs (u, v), stored with v
+  std::size_t shortcuts;          // The number of arcs not in the graph
+};
+
+
+namespace contraction_impl {
+
+constexpr char magic[8] = {'o', 'r', 'i', 'g', 'i', 'n', 'c', 'h'};
+
+template<typename T>
+void
+write(std::ostream& os, std::vector<T> const& v)
+{
+  std::uint64_t n = v.size();
+  os.write(reinterpret_cast<char const*>(&n), sizeof(n));
+  os.write(reinterpret_cast<char const*>(v.data()), n * sizeof(T));
+}
+
+template<typename T>
+bool
+read(std::istream& is, std::vector<T>& v)
+{
+  std::uint64_t n;
+  if (!is.read(reinterpret_cast<char*>(&n), sizeof(n)))
+    return false;
+  v.resize(n);
+  return bool(is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T)));
+}
+
+} // namespace contraction_impl
+
+
+// Write the hierarchy to os in a binary format. The format is specific to
+// the weight type and the platform that wrote it. Returns false if the
+// write failed.
+template<typename T>
+bool
+contraction_hierarchy<T>::save(std::ostream& os) const
+{
+  using namespace contraction_impl;
+  static_assert(std::is_trivially_copyable<T>::value,
+                "weights must be trivially copyable");
+
+  std::uint64_t header[] = {sizeof(T), sizeof(vertex_t), shortcuts};
+  os.write(magic, sizeof(magic));
+  os.write(reinterpret_cast<char const*>(header), sizeof(header));
+  write(os, ranks);
+  for (arc_array<T> const* a : {&up, &down}) {
+    write(os, a->offsets);
+    write(os, a->heads);
+    write(os, a->weights);
+  }
+  return bool(os);
+}
+
+// Read a hierarchy from is. Returns false if the input is not a hierarchy
+// written for the same weight type or cannot be read.
+template<typename T>
+bool
+contraction_hierarchy<T>::load(std::istream& is)
+{
+  using namespace contraction_impl;
+
+  char m[sizeof(magic)];
+  std::uint64_t header[3];
+  if (!is.read(m, sizeof(m)) || !std::equal(m, m + sizeof(m), magic))
+    return false;
+  if (!is.read(reinterpret_cast<char*>(header), sizeof(header)))
+    return false;
+  if (header[0] != sizeof(T) || header[1] != sizeof(vertex_t))
+    return false;
+  shortcuts = header[2];
+  if (!read(is, ranks))
+    return false;
+  for (arc_array<T>* a : {&up, &down}) {
+    if (!read(is, a->offsets) || !read(is, a->heads))
+      return false;
+    if (!read(is, a->weights))
+      return false;
+    if (a->offsets.size() != ranks.size() + 1)
+      return false;
+  }
+  return true;
+}
+
+
+// Builds a contraction hierarchy for a graph whose edges are weighted by
+// a label W with non-negative values.
+//
+// Vertices are contracted in rounds. Each round contracts an independent
+// set of vertices whose priorities are smaller than those of all their
+// neighbors. The priority of a vertex is its edge difference (the number
+// of shortcuts its contraction would add minus the number of arcs it would
+// remove) plus the number of its neighbors already contracted. Witness
+// searches and priority updates within a round are done in parallel.
+//
+// Witness searches are limited to witness_limit settled vertices. A search
+// that reaches the limit adds a shortcut that may not be needed, which
+// never affects the correctness of queries. The searches used to estimate
+// priorities are limited to estimate_limit settled vertices.
+template<typename G, typename W>
+struct contraction_builder
+{
+  using weight_type = label_value_t<W, edge_t>;
+  using hierarchy_type = contraction_hierarchy<weight_type>;
+
+  struct arc
+  {
+    vertex_t v;
+    weight_type w;
+  };
+
+  using arc_list = std::vector<arc>;
+
+  contraction_builder(G const& g, W weight)
+    : graph(g), weight(weight), witness_limit(500), estimate_limit(20)
+  { }
+
+  hierarchy_type operator()();
+
+  template<typename F>
+  void contract(vertex_t v, search_state<weight_type>& state,
+                std::size_t limit, F emit) const;
+
+  long priority(vertex_t v, search_state<weight_type>& state) const;
+  bool is_local_minimum(vertex_t v) const;
+
+  void remove(arc_list& list, vertex_t v);
+  void insert(arc_list& list, vertex_t v, weight_type w);
+
+  template<typename F>
+  void for_each_block(counted_range<std::size_t> r, F f);
+
+  G const& graph;
+  W weight;
+  std::size_t witness_limit;
+  std::size_t estimate_limit;
+
+  // Contraction state.
+  std::vector<arc_list> outs;
+  std::vector<arc_list> ins;
+  std::vector<long> priorities;
+  std::vector<long> neighbors; // Contracted neighbors
+  std::vector<char> selected;
+
+  // Search states that can be shared by blocks of parallel work.
+  std::vector<std::unique_ptr<search_state<weight_type>>> states;
+  std::mutex lock;
+};
+
+// Call f(r, state) for blocks of r in parallel, giving each block its own
+// search state.
+template<typename G, typename W>
+template<typename F>
+void
+contraction_builder<G, W>::for_each_block(counted_range<std::size_t> r, F f)
+{
+  std::size_t n = graph.num_vertices();
+  parallel_for(r, [this, n, &f](counted_range<std::size_t> block) {
+    std::unique_ptr<search_state<weight_type>> state;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (states.empty()) {
+        state.reset(new search_state<weight_type>(n));
+      }
+      else {
+        state = std::move(states.back());
+        states.pop_back();
+      }
+    }
+    f(block, *state);
+    std::lock_guard<std::mutex> guard(lock);
+    states.push_back(std::move(state));
+  }, 64);
+}
+
+// Compute the shortcuts needed to contract v, calling emit(u, w, d) for
+// each. The search ignores v and vertices selected for contraction in the
+// current round, so shortcuts are never omitted because of witnesses that
+// are being removed.
+template<typename G, typename W>
+template<typename F>
+void
+contraction_builder<G, W>::contract(vertex_t v,
+                                    search_state<weight_type>& state,
+                                    std::size_t limit,
+                                    F emit) const
+{
+  auto excluded = [this, v](vertex_t x) { return x == v || selected[x]; };
+
+  weight_type longest = 0;
+  for (arc const& b : outs[v])
+    longest = std::max(longest, b.w);
+
+  for (arc const& a : ins[v]) {
+    vertex_t u = a.v;
+    weight_type bound = a.w + longest;
+
+    // Search for witnesses from u, stopping when every target is settled.
+    auto is_target = [this, v, u](vertex_t x) {
+      return x != u && std::any_of(outs[v].begin(), outs[v].end(),
+                                   [x](arc const& b) { return b.v == x; });
+    };
+    std::size_t targets = std::count_if(outs[v].begin(), outs[v].end(),
+                                        [u](arc const& b) { return b.v != u; });
+    state.reset();
+    state.relax(u, u, weight_type(0), weight_type(0));
+    std::size_t settled = 0;
+    while (!state.queue.is_empty() && settled < limit && targets) {
+      vertex_t x = state.queue.top();
+      weight_type dx = state.distances[x];
+      if (dx > bound)
+        break;
+      state.queue.pop();
+      ++settled;
+      if (is_target(x))
+        --targets;
+      for (arc const& b : outs[x]) {
+        if (!excluded(b.v))
+          state.relax(b.v, x, dx + b.w, weight_type(0));
+      }
+    }
+
+    for (arc const& b : outs[v]) {
+      vertex_t w = b.v;
+      if (w == u)
+        continue;
+      weight_type via = a.w + b.w;
+      if (!state.reached(w) || state.distances[w] > via)
+        emit(u, w, via);
+    }
+  }
+}
+
+// Returns the priority of v. Smaller priorities are contracted first.
+template<typename G, typename W>
+long
+contraction_builder<G, W>::priority(vertex_t v,
+                                    search_state<weight_type>& state) const
+{
+  long added = 0;
+  auto count = [&added](vertex_t, vertex_t, weight_type) { ++added; };
+  contract(v, state, estimate_limit, count);
+  long removed = ins[v].size() + outs[v].size();
+  return added - removed + neighbors[v];
+}
+
+// Returns true if v precedes all of its neighbors in the contraction order.
+// Ties are broken by vertex id.
+template<typename G, typename W>
+bool
+contraction_builder<G, W>::is_local_minimum(vertex_t v) const
+{
+  auto before = [this](vertex_t x, vertex_t y) {
+    return std::tie(priorities[x], x) < std::tie(priorities[y], y);
+  };
+  for (arc const& a : outs[v]) {
+    if (!before(v, a.v))
+      return false;
+  }
+  for (arc const& a : ins[v]) {
+    if (!before(v, a.v))
+      return false;
+  }
+  return true;
+}
+
+// Remove the arc to or from v in list.
+template<typename G, typename W>
+void
+contraction_builder<G, W>::remove(arc_list& list, vertex_t v)
+{
+  auto iter = std::find_if(list.begin(), list.end(), [v](arc const& a) {
+    return a.v == v;
+  });
+  assert(iter != list.end());
+  *iter = list.back();
+  list.pop_back();
+}
+
+// Add an arc to or from v with weight w, or reduce the weight of an
+// existing arc.
+template<typename G, typename W>
+void
+contraction_builder<G, W>::insert(arc_list& list, vertex_t v, weight_type w)
+{
+  for (arc& a : list) {
+    if (a.v == v) {
+      a.w = std::min(a.w, w);
+      return;
+    }
+  }
+  list.push_back(arc{v, w});
+}
+
+template<typename G, typename W>
+auto
+contraction_builder<G, W>::operator()() -> hierarchy_type
+{
+  std::size_t n = graph.num_vertices();
+  hierarchy_type h;
+  h.ranks.assign(n, 0);
+  h.shortcuts = 0;
+
+  // Build the working graph, ignoring loops.
+  outs.assign(n, arc_list());
+  ins.assign(n, arc_list());
+  for (edge_t e : graph.edges()) {
+    vertex_t u = graph.source(e);
+    vertex_t v = graph.target(e);
+    assert(weight(e) >= weight_type(0));
+    if (u != v) {
+      insert(outs[u], v, weight(e));
+      insert(ins[v], u, weight(e));
+    }
+  }
+  std::size_t original = 0;
+  for (arc_list const& l : outs)
+    original += l.size();
+
+  neighbors.assign(n, 0);
+  selected.assign(n, 0);
+  priorities.assign(n, 0);
+  for_each_block({0, n}, [this](counted_range<std::size_t> r,
+                                search_state<weight_type>& state) {
+    for (vertex_t v : r)
+      priorities[v] = priority(v, state);
+  });
+
+  // The frozen arcs of contracted vertices are their upward arcs.
+  std::vector<arc_list> ups(n);
+  std::vector<arc_list> downs(n);
+
+  std::vector<vertex_t> remaining(n);
+  for (vertex_t v = 0; v < n; ++v)
+    remaining[v] = v;
+  std::vector<vertex_t> round;
+  std::vector<vertex_t> affected;
+  std::vector<std::vector<std::tuple<vertex_t, vertex_t, weight_type>>> added;
+  std::size_t rank = 0;
+  while (!remaining.empty()) {
+    // Select an independent set of vertices to contract.
+    round.clear();
+    for (vertex_t v : remaining) {
+      if (is_local_minimum(v)) {
+        round.push_back(v);
+        selected[v] = 1;
+      }
+    }
+    assert(!round.empty());
+
+    // Find the shortcuts for each selected vertex.
+    added.assign(round.size(), {});
+    for_each_block({0, round.size()}, [&](counted_range<std::size_t> r,
+                                          search_state<weight_type>& state) {
+      for (std::size_t i : r) {
+        auto emit = [&](vertex_t u, vertex_t w, weight_type d) {
+          added[i].emplace_back(u, w, d);
+        };
+        contract(round[i], state, witness_limit, emit);
+      }
+    });
+
+    // Remove the selected vertices and add their shortcuts.
+    affected.clear();
+    for (std::size_t i = 0; i < round.size(); ++i) {
+      vertex_t v = round[i];
+      h.ranks[v] = rank++;
+      for (arc const& a : outs[v]) {
+        remove(ins[a.v], v);
+        ++neighbors[a.v];
+        affected.push_back(a.v);
+      }
+      for (arc const& a : ins[v]) {
+        remove(outs[a.v], v);
+        ++neighbors[a.v];
+        affected.push_back(a.v);
+      }
+      for (auto const& s : added[i]) {
+        insert(outs[std::get<0>(s)], std::get<1>(s), std::get<2>(s));
+        insert(ins[std::get<1>(s)], std::get<0>(s), std::get<2>(s));
+      }
+      ups[v] = std::move(outs[v]);
+      downs[v] = std::move(ins[v]);
+      outs[v].clear();
+      ins[v].clear();
+    }
+    for (vertex_t v : round)
+      selected[v] = 2;
+    remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                   [this](vertex_t v) {
+                                     return selected[v] == 2;
+                                   }),
+                    remaining.end());
+    for (vertex_t v : round)
+      selected[v] = 0;
+
+    // Update the priorities of the neighbors of contracted vertices.
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()),
+                   affected.end());
+    for_each_block({0, affected.size()}, [&](counted_range<std::size_t> r,
+                                             search_state<weight_type>& s) {
+      for (std::size_t i : r)
+        priorities[affected[i]] = priority(affected[i], s);
+    });
+  }
+
+  // Store the upward arcs contiguously.
+  auto pack = [n](std::vector<arc_list> const& lists,
+                  arc_array<weight_type>& a) {
+    a.offsets.assign(n + 1, 0);
+    for (vertex_t v = 0; v < n; ++v)
+      a.offsets[v + 1] = a.offsets[v] + lists[v].size();
+    a.heads.resize(a.offsets[n]);
+    a.weights.resize(a.offsets[n]);
+    for (vertex_t v = 0; v < n; ++v) {
+      std::size_t i = a.offsets[v];
+      for (arc const& x : lists[v]) {
+        a.heads[i] = x.v;
+        a.weights[i] = x.w;
+        ++i;
+      }
+    }
+  };
+  pack(ups, h.up);
+  pack(downs, h.down);
+  h.shortcuts = h.num_arcs() - original;
+  return h;
+}
+
+
+// Answers shortest path queries on a contraction hierarchy. A query runs a
+// Dijkstra search upward from the source and another upward (over reversed
+// arcs) from the target. Each search stops once its smallest key is no
+// less than the shortest path found so far.
+template<typename T>
+struct contraction_query
+{
+  using weight_type = T;
+  using hierarchy_type = contraction_hierarchy<T>;
+
+  static constexpr weight_type infinity = search_state<weight_type>::infinity;
+
+  contraction_query(hierarchy_type const& h)
+    : hierarchy(h),
+      forward(h.num_vertices()),
+      backward(h.num_vertices()),
+      settled(0)
+  { }
+
+  weight_type operator()(vertex_t s, vertex_t t);
+
+  bool step(search_state<T>& self, search_state<T>& other,
+            arc_array<T> const& arcs, weight_type& best);
+
+  hierarchy_type const& hierarchy;
+  search_state<T> forward;
+  search_state<T> backward;
+  std::size_t settled;
+};
+
+// Settle the next vertex of one search. Returns false if that search is
+// finished.
+template<typename T>
+bool
+contraction_query<T>::step(search_state<T>& self, search_state<T>& other,
+                           arc_array<T> const& arcs, weight_type& best)
+{
+  if (self.queue.is_empty())
+    return false;
+  vertex_t u = self.queue.top();
+  weight_type du = self.distances[u];
+  if (best != infinity && du >= best) {
+    self.queue.clear();
+    return false;
+  }
+  self.queue.pop();
+  ++settled;
+  if (other.reached(u))
+    best = std::min(best, du + other.distances[u]);
+  for (std::size_t i : arcs.arcs(u))
+    self.relax(arcs.heads[i], u, du + arcs.weights[i], weight_type(0));
+  return true;
+}
+
+// Returns the distance from s to t, or infinity if t is unreachable.
+template<typename T>
+auto
+contraction_query<T>::operator()(vertex_t s, vertex_t t) -> weight_type
+{
+  forward.reset();
+  backward.reset();
+  settled = 0;
+  forward.relax(s, s, weight_type(0), weight_type(0));
+  backward.relax(t, t, weight_type(0), weight_type(0));
+  weight_type best = infinity;
+  bool f = true;
+  bool b = true;
+  while (f || b) {
+    if (f)
+      f = step(forward, backward, hierarchy.up, best);
+    if (b)
+      b = step(backward, forward, hierarchy.down, best);
+  }
+  return best;
+}
+
+
+} // namespace origin
+
+#endif
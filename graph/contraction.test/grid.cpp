@@ -0,0 +1,92 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../contraction.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Measures preprocessing and query times for contraction hierarchies on a
+// grid with random edge weights, and compares queries to bidirectional
+// Dijkstra.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+
+  std::size_t side = argc > 1 ? std::atoi(argv[1]) : 200;
+  int queries = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+  using G = digraph<>;
+  G g;
+  std::vector<int> weights;
+  std::minstd_rand gen(1);
+  std::uniform_int_distribution<int> cost(10, 20);
+  for (std::size_t i = 0; i < side * side; ++i)
+    g.add_vertex();
+  auto id = [side](std::size_t x, std::size_t y) { return y * side + x; };
+  auto link = [&](vertex_t u, vertex_t v) {
+    int c = cost(gen);
+    g.add_edge(u, v);
+    g.add_edge(v, u);
+    weights.push_back(c);
+    weights.push_back(c);
+  };
+  for (std::size_t y = 0; y < side; ++y) {
+    for (std::size_t x = 0; x < side; ++x) {
+      if (x + 1 < side)
+        link(id(x, y), id(x + 1, y));
+      if (y + 1 < side)
+        link(id(x, y), id(x, y + 1));
+    }
+  }
+  auto weight = edge_label(weights);
+
+  auto start = clock::now();
+  contraction_builder<G, decltype(weight)> build(g, weight);
+  contraction_hierarchy<int> ch = build();
+  std::chrono::duration<double> pre = clock::now() - start;
+  std::cout << "grid " << side << 'x' << side << ", "
+            << g.num_edges() << " edges\n"
+            << "preprocessing: " << pre.count() << " s, "
+            << ch.shortcuts << " shortcuts\n";
+
+  std::uniform_int_distribution<vertex_t> pick(0, g.num_vertices() - 1);
+  std::vector<std::pair<vertex_t, vertex_t>> pairs;
+  for (int i = 0; i < queries; ++i)
+    pairs.emplace_back(pick(gen), pick(gen));
+
+  auto run = [&](char const* name, auto query) {
+    std::size_t settled = 0;
+    long check = 0;
+    auto start = clock::now();
+    for (auto const& p : pairs) {
+      auto r = query(p.first, p.second);
+      settled += r.first;
+      check += r.second;
+    }
+    std::chrono::duration<double, std::micro> t = clock::now() - start;
+    std::cout << name
+              << ": settled/query " << settled / pairs.size()
+              << ", us/query " << t.count() / pairs.size()
+              << ", checksum " << check << '\n';
+  };
+
+  contraction_query<int> query(ch);
+  run("contraction", [&](vertex_t s, vertex_t t) {
+    int d = query(s, t);
+    return std::make_pair(query.settled, d);
+  });
+  bidirectional_dijkstra<G, decltype(weight)> bidi(g, weight);
+  run("bidirectional", [&](vertex_t s, vertex_t t) {
+    int d = bidi(s, t);
+    return std::make_pair(bidi.settled, d);
+  });
+}
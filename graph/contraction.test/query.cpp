@@ -0,0 +1,75 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../contraction.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  using G = digraph<>;
+  G g;
+  std::minstd_rand gen(7);
+  std::size_t n = 400;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::uniform_int_distribution<int> cost(1, 50);
+  std::vector<int> costs;
+  for (std::size_t i = 0; i < 3 * n; ++i) {
+    vertex_t a = pick(gen), b = pick(gen);
+    if (!g.has_edge(a, b)) {
+      g.add_edge(a, b);
+      costs.push_back(cost(gen));
+    }
+  }
+  auto weight = edge_label(costs);
+
+  contraction_builder<G, decltype(weight)> build(g, weight);
+  contraction_hierarchy<int> ch = build();
+  assert(ch.num_vertices() == n);
+
+  // Ranks are a permutation of the vertices.
+  std::vector<bool> seen(n);
+  for (std::size_t r : ch.ranks) {
+    assert(r < n && !seen[r]);
+    seen[r] = true;
+  }
+
+  // Arcs always lead upward.
+  for (vertex_t v = 0; v < n; ++v) {
+    for (std::size_t i : ch.up.arcs(v))
+      assert(ch.ranks[ch.up.heads[i]] > ch.ranks[v]);
+    for (std::size_t i : ch.down.arcs(v))
+      assert(ch.ranks[ch.down.heads[i]] > ch.ranks[v]);
+  }
+
+  // Save and reload the hierarchy.
+  std::stringstream ss;
+  assert(ch.save(ss));
+  contraction_hierarchy<int> copy;
+  assert(copy.load(ss));
+  assert(copy.ranks == ch.ranks);
+  assert(copy.shortcuts == ch.shortcuts);
+  contraction_hierarchy<double> wrong;
+  std::stringstream again(ss.str());
+  assert(!wrong.load(again));
+
+  // Queries agree with Dijkstra.
+  dijkstra_search<G, decltype(weight)> dijkstra(g, weight);
+  contraction_query<int> query(copy);
+  for (vertex_t s = 0; s < n; s += 7) {
+    dijkstra(s);
+    for (vertex_t t = 0; t < n; ++t)
+      assert(query(s, t) == dijkstra.state.distances[t]);
+  }
+}
@@ -0,0 +1,214 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_CORE_HPP
+#define GRAPH_CORE_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+
+namespace origin {
+
+// Core decomposition
+//
+// The k-core of an undirected graph is its largest subgraph in which every
+// vertex has at least k neighbors. The core number of a vertex is the
+// greatest k for which it is in the k-core, and the degeneracy of the graph
+// is the greatest core number.
+//
+// Removing vertices in a degeneracy order leaves each vertex with at most
+// its core number of neighbors when it is removed. Orienting edges along
+// the order therefore bounds out-degrees by the degeneracy, which bounds
+// the work of clique and triangle algorithms (see orient in triangles.hpp).
+//
+// Self loops are ignored. Parallel edges are counted separately, as are
+// the two directions of a digraph viewed through undirected_view.
+struct core_numbers
+{
+  std::vector<std::size_t> cores;  // The core number of each vertex
+  std::vector<vertex_t> order;     // Vertices in degeneracy order
+  std::vector<std::size_t> ranks;  // The position of each vertex in order
+  std::size_t degeneracy = 0;
+};
+
+// A vertex predicate that accepts the vertices of the k-core, for use with
+// filter_vertices or as a vertex label.
+struct in_core
+{
+  in_core(std::vector<std::size_t> const& cores, std::size_t k)
+    : cores(&cores), k(k)
+  { }
+
+  bool operator()(vertex_t v) const { return (*cores)[v] >= k; }
+
+  std::vector<std::size_t> const* cores;
+  std::size_t k;
+};
+
+
+// Returns the number of incident edges of v, not counting self loops.
+template<typename G>
+std::size_t
+loopless_degree(G const& g, vertex_t v)
+{
+  std::size_t d = g.degree(v);
+  for (edge_t e : g.edges(v))
+    d -= g.opposite(e, v) == v;
+  return d;
+}
+
+// Computes the core numbers of g in O(V + E) time using the algorithm of
+// Batagelj and Zaversnik. Vertices are kept in an array sorted by current
+// degree, with the start of each degree recorded in bins. The vertex of
+// least degree is removed next, and each neighbor of greater degree is
+// moved to the front of its bin before that bin is shrunk by one.
+template<typename G>
+  requires undirected_incidence_graph<G>
+core_numbers
+core_decomposition(G const& g)
+{
+  std::size_t n = g.num_vertices();
+  core_numbers r;
+  std::vector<std::size_t>& degrees = r.cores;
+  std::vector<vertex_t>& order = r.order;
+  std::vector<std::size_t>& ranks = r.ranks;
+  degrees.resize(n);
+  std::size_t most = 0;
+  for (vertex_t v = 0; v < n; ++v) {
+    degrees[v] = loopless_degree(g, v);
+    most = std::max(most, degrees[v]);
+  }
+
+  // Sort vertices by degree.
+  std::vector<std::size_t> bins(most + 2, 0);
+  for (vertex_t v = 0; v < n; ++v)
+    ++bins[degrees[v] + 1];
+  for (std::size_t d = 1; d < bins.size(); ++d)
+    bins[d] += bins[d - 1];
+  order.resize(n);
+  ranks.resize(n);
+  for (vertex_t v = 0; v < n; ++v) {
+    ranks[v] = bins[degrees[v]]++;
+    order[ranks[v]] = v;
+  }
+  for (std::size_t d = most; d > 0; --d)
+    bins[d] = bins[d - 1];
+  bins[0] = 0;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = order[i];
+    for (edge_t e : g.edges(v)) {
+      vertex_t u = g.opposite(e, v);
+      if (degrees[u] <= degrees[v])
+        continue;
+      std::size_t d = degrees[u];
+      vertex_t w = order[bins[d]];
+      if (u != w) {
+        std::swap(order[ranks[u]], order[bins[d]]);
+        std::swap(ranks[u], ranks[w]);
+      }
+      ++bins[d];
+      --degrees[u];
+    }
+  }
+  r.degeneracy = n ? degrees[order[n - 1]] : 0;
+  return r;
+}
+
+// Computes the core numbers of g by peeling in parallel. For each k in
+// increasing order, the vertices of degree at most k are removed in rounds.
+// The vertices of a round are removed concurrently, and their neighbors
+// whose degree falls to k join the next round. Degrees are decremented
+// atomically.
+//
+// Each round scans only the edges of its vertices, and each value of k
+// scans the remaining vertices once, so the cost is O(V + E) plus the
+// remaining vertices at each distinct core number. Rounds are sorted, so
+// the degeneracy order is deterministic.
+template<typename G>
+  requires undirected_incidence_graph<G>
+core_numbers
+parallel_core_decomposition(G const& g, std::size_t grain = 1024)
+{
+  std::size_t n = g.num_vertices();
+  core_numbers r;
+  r.cores.resize(n);
+  r.order.reserve(n);
+  std::vector<std::atomic<long>> degrees(n);
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> vs) {
+    for (vertex_t v : vs)
+      degrees[v].store(loopless_degree(g, v), std::memory_order_relaxed);
+  });
+
+  std::vector<vertex_t> remaining(n);
+  for (vertex_t v = 0; v < n; ++v)
+    remaining[v] = v;
+  std::vector<vertex_t> round;
+  std::vector<std::vector<vertex_t>> found;
+  long k = 0;
+  while (!remaining.empty()) {
+    // Drop removed vertices, find the least degree among the others, and
+    // take the first round.
+    long least = std::numeric_limits<long>::max();
+    std::size_t kept = 0;
+    for (vertex_t v : remaining) {
+      if (degrees[v].load(std::memory_order_relaxed) >= 0)
+        remaining[kept++] = v;
+    }
+    remaining.resize(kept);
+    for (vertex_t v : remaining)
+      least = std::min(least, degrees[v].load(std::memory_order_relaxed));
+    k = std::max(k, least);
+    round.clear();
+    for (vertex_t v : remaining)
+      if (degrees[v].load(std::memory_order_relaxed) <= k)
+        round.push_back(v);
+
+    while (!round.empty()) {
+      // Removed vertices have negative degree.
+      for (vertex_t v : round) {
+        degrees[v].store(-1, std::memory_order_relaxed);
+        r.cores[v] = k;
+        r.order.push_back(v);
+      }
+      // Each block appends the vertices it finds to its own list.
+      counted_range<std::size_t> all(round.size());
+      found.assign(concurrency(), {});
+      std::atomic<std::size_t> next(0);
+      parallel_for(all, [&](counted_range<std::size_t> is) {
+        std::vector<vertex_t>& out = found[next++];
+        for (std::size_t i : is) {
+          vertex_t v = round[i];
+          for (edge_t e : g.edges(v)) {
+            std::atomic<long>& d = degrees[g.opposite(e, v)];
+            if (d.load(std::memory_order_relaxed) > k &&
+                d.fetch_sub(1, std::memory_order_relaxed) == k + 1)
+              out.push_back(g.opposite(e, v));
+          }
+        }
+      }, grain);
+      round.clear();
+      for (auto const& out : found)
+        round.insert(round.end(), out.begin(), out.end());
+      std::sort(round.begin(), round.end());
+    }
+  }
+
+  r.ranks.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    r.ranks[r.order[i]] = i;
+  r.degeneracy = n ? r.cores[r.order[n - 1]] : 0;
+  return r;
+}
+
+
+} // namespace origin
+
+#endif
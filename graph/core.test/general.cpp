@@ -0,0 +1,152 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../core.hpp"
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../triangles.hpp"
+#include "../view.hpp"
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns the core numbers of g by repeatedly removing the vertices of
+// degree less than k, for each k.
+template<typename G>
+std::vector<std::size_t>
+brute_force(G const& g)
+{
+  std::size_t n = g.num_vertices();
+  std::vector<std::size_t> cores(n, 0);
+  for (std::size_t k = 1; ; ++k) {
+    std::vector<char> alive(n, 1);
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (vertex_t v = 0; v < n; ++v) {
+        if (!alive[v])
+          continue;
+        std::size_t d = 0;
+        for (edge_t e : g.edges(v)) {
+          vertex_t u = g.opposite(e, v);
+          d += u != v && alive[u];
+        }
+        if (d < k) {
+          alive[v] = 0;
+          changed = true;
+        }
+      }
+    }
+    bool any = false;
+    for (vertex_t v = 0; v < n; ++v)
+      if (alive[v]) {
+        cores[v] = k;
+        any = true;
+      }
+    if (!any)
+      return cores;
+  }
+}
+
+// Check that r is a core decomposition of g.
+template<typename G>
+void
+check(G const& g, core_numbers const& r, std::vector<std::size_t> const& c)
+{
+  std::size_t n = g.num_vertices();
+  assert(r.cores == c);
+  assert(r.order.size() == n && r.ranks.size() == n);
+  std::size_t most = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = r.order[i];
+    assert(r.ranks[v] == i);
+    most = std::max(most, c[v]);
+    if (i > 0)
+      assert(c[r.order[i - 1]] <= c[v]);
+
+    // At most core(v) neighbors follow v.
+    std::size_t later = 0;
+    for (edge_t e : g.edges(v)) {
+      vertex_t u = g.opposite(e, v);
+      later += u != v && r.ranks[u] > i;
+    }
+    assert(later <= c[v]);
+  }
+  assert(r.degeneracy == most);
+}
+
+
+int
+main()
+{
+  // A 4-clique with a tail and an isolated vertex.
+  {
+    graph<> g;
+    for (int i = 0; i < 7; ++i)
+      g.add_vertex();
+    for (vertex_t u = 0; u < 4; ++u)
+      for (vertex_t v = u + 1; v < 4; ++v)
+        g.add_edge(u, v);
+    g.add_edge(3, 4);
+    g.add_edge(4, 5);
+    g.add_edge(5, 5);
+    std::vector<std::size_t> c {3, 3, 3, 3, 1, 1, 0};
+    check(g, core_decomposition(g), c);
+    check(g, parallel_core_decomposition(g), c);
+    assert(core_decomposition(g).degeneracy == 3);
+  }
+
+  std::minstd_rand gen(17);
+  for (int trial = 0; trial < 30; ++trial) {
+    graph<> g;
+    std::size_t n = 1 + gen() % 120;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    std::size_t m = gen() % (4 * n);
+    for (std::size_t i = 0; i < m; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    std::vector<std::size_t> c = brute_force(g);
+    core_numbers r = core_decomposition(g);
+    check(g, r, c);
+    check(g, parallel_core_decomposition(g, 1 + trial % 4), c);
+
+    // The degeneracy order gives the same triangles as the degree order,
+    // with out-degrees bounded by the degeneracy.
+    oriented_graph h = orient(g, r.order);
+    assert(count_triangles(h) == count_triangles(g));
+    for (std::uint32_t x = 0; x < n; ++x)
+      assert(h.out_degree(x) <= r.degeneracy);
+  }
+
+  // The cores of a digraph, through its undirected view, filter the
+  // digraph.
+  {
+    digraph<> g;
+    for (int i = 0; i < 5; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 0);
+    g.add_edge(2, 3);
+    g.add_edge(3, 4);
+    core_numbers r = core_decomposition(undirected(g));
+    assert((r.cores == std::vector<std::size_t> {2, 2, 2, 1, 1}));
+    auto core = filter_vertices(g, in_core(r.cores, 2));
+    std::size_t edges = 0;
+    for (vertex_t v = 0; v < 5; ++v)
+      for (edge_t e : core.out_edges(v)) {
+        assert(core.target(e) < 3);
+        ++edges;
+      }
+    assert(edges == 3);
+  }
+}
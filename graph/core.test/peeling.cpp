@@ -0,0 +1,83 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../core.hpp"
+#include "../graph.hpp"
+#include "../triangles.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Compares sequential and parallel core decomposition on a graph grown by
+// preferential attachment, and triangle counting with the degree and
+// degeneracy orientations.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::size_t d = argc > 2 ? std::atoi(argv[2]) : 8;
+
+  graph<> g;
+  std::vector<vertex_t> ends;
+  std::minstd_rand gen(29);
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = g.add_vertex();
+    for (std::size_t j = 0; j < d && !ends.empty(); ++j) {
+      vertex_t u = ends[gen() % ends.size()];
+      if (u != v && !g.has_edge(u, v)) {
+        g.add_edge(u, v);
+        ends.push_back(u);
+        ends.push_back(v);
+      }
+    }
+    ends.push_back(v);
+  }
+  std::cout << n << " vertices, " << g.num_edges() << " edges\n";
+
+  auto start = clock::now();
+  core_numbers a = core_decomposition(g);
+  ms t = clock::now() - start;
+  std::cout << "batagelj-zaversnik: " << t.count() << " ms, degeneracy "
+            << a.degeneracy << '\n';
+
+  start = clock::now();
+  core_numbers b = parallel_core_decomposition(g);
+  t = clock::now() - start;
+  std::cout << "parallel peeling: " << t.count() << " ms, "
+            << (a.cores == b.cores ? "same cores" : "DIFFERENT cores")
+            << '\n';
+
+  std::size_t k = a.degeneracy / 2;
+  std::size_t kept = 0;
+  for (std::size_t c : a.cores)
+    kept += c >= k;
+  std::cout << k << "-core: " << kept << " vertices\n";
+
+  auto triangles = [&](char const* name, oriented_graph const& h, ms t) {
+    std::size_t most = 0;
+    for (std::uint32_t r = 0; r < h.num_vertices(); ++r)
+      most = std::max(most, h.out_degree(r));
+    auto start = clock::now();
+    std::size_t count = count_triangles(h);
+    ms c = clock::now() - start;
+    std::cout << name << ": orient " << t.count() << " ms, count "
+              << c.count() << " ms, " << count << " triangles, max out "
+              << most << '\n';
+  };
+  start = clock::now();
+  oriented_graph h = orient_by_degree(g);
+  triangles("degree order", h, clock::now() - start);
+  start = clock::now();
+  h = orient(g, a.order);
+  triangles("degeneracy order", h, clock::now() - start);
+}
@@ -5,148 +5,200 @@
 #define GRAPH_DFS_HPP
 
 #include "common.hpp"
+#include "color.hpp"
+#include "concepts.hpp"
+
+#include <cstdint>
+#include <limits>
 
 
 namespace origin {
 
-// A basic DFS implementation for directed graphs.
-template<typename G>
+// Records the discovery (pre) and finishing (post) times of vertices in a
+// depth-first search. The timestamp type T determines the width of each
+// entry; a search generates two events per vertex, so T must be able to
+// represent twice the number of vertices.
+template<typename T = std::size_t>
+struct dfs_timestamps
+{
+  using time_type = T;
+
+  static constexpr T none = std::numeric_limits<T>::max();
+
+  dfs_timestamps(std::size_t n)
+    : pre_times(n, none), post_times(n, none), clock(0)
+  {
+    assert(n <= none / 2);
+  }
+
+  void discover(vertex_t v) { pre_times[v] = clock++; }
+  void finish(vertex_t v) { post_times[v] = clock++; }
+
+  std::vector<T> pre_times;
+  std::vector<T> post_times;
+  T clock;
+};
+
+
+// Used to indicate that a search does not record timestamps.
+struct no_timestamps
+{
+  no_timestamps(std::size_t)
+  { }
+
+  void discover(vertex_t) { }
+  void finish(vertex_t) { }
+};
+
+
+// A basic DFS implementation for directed graphs. The color map C must
+// distinguish gray from black vertices in order to classify edges. The
+// timestamp recorder T may be no_timestamps when discovery and finishing
+// times are not needed.
+//
+// The search follows out_neighbors when the graph provides it, and
+// otherwise the targets of out_edges.
+template<typename G,
+         typename C = two_bit_color_map,
+         typename T = dfs_timestamps<>>
+  requires vertex_list_graph<G> && (adjacency_graph<G> || incidence_graph<G>)
 struct directed_dfs
 {
   directed_dfs(G& g)
-    : graph(g), 
-      colors(graph.num_vertices(), 0),
-      pre_times(graph.num_vertices(), -1),
-      post_times(graph.num_vertices(), -1),
-      parents(graph.num_vertices()),
-      clock(0)
+    : graph(g),
+      colors(graph.num_vertices(), white),
+      times(graph.num_vertices()),
+      parents(graph.num_vertices())
   { }
 
   void operator()()
   {
     auto color = vertex_label(colors);
-    auto pre = vertex_label(pre_times);
-    auto post = vertex_label(post_times);
     auto parent = vertex_label(parents);
 
     // Extra initialization.
     for (vertex_t v : graph.vertices())
       parent(v) = v;
-    
-    search(color, pre, post, parent);
+
+    search(color, parent);
   }
 
-  template<typename L1, typename L2>
-  void search(L1 color, L1 pre, L1 post, L2 parent)
+  template<vertex_property L1, vertex_property L2>
+  void search(L1 color, L2 parent)
   {
     for (vertex_t v : graph.vertices()) {
-      if (color(v) == 0)
-        explore(v, color, pre, post, parent);
+      if (color(v) == white)
+        explore(v, color, parent);
     }
   }
 
-  template<typename L1, typename L2>
-  void explore(vertex_t u, L1 color, L1 pre, L1 post, L2 parent)
+  template<vertex_property L1, vertex_property L2>
+  void explore(vertex_t u, L1 color, L2 parent)
   {
-    color(u) = 1;     // color u gray (on stack)
-    pre(u) = clock++;
+    color(u) = gray;  // color u gray (on stack)
+    times.discover(u);
 
-    for (edge_t e : graph.out_edges(u)) {
-      vertex_t v = graph.target(e);
-      if (color(v) == 0) {
-        // (u, v) is a tree edge
-        parent(v) = u;
-        explore(v, color, pre, post, parent);
-      }
-      else if (color(v) == 1) {
-        // (u, v) is a back edge
-      }
-      else {
-        // (u, v) is a cross or forward edge
-      }
+    if constexpr (adjacency_graph<G>) {
+      for (vertex_t v : graph.out_neighbors(u))
+        visit(u, v, color, parent);
     }
+    else {
+      for (edge_t e : graph.out_edges(u))
+        visit(u, graph.target(e), color, parent);
+    }
+
+    times.finish(u);
+    color(u) = black; // color u black (done).
+  }
 
-    post(u) = clock++;
-    color(u) = 2; // color u black (done).
+  template<vertex_property L1, vertex_property L2>
+  void visit(vertex_t u, vertex_t v, L1 color, L2 parent)
+  {
+    if (color(v) == white) {
+      // (u, v) is a tree edge
+      parent(v) = u;
+      explore(v, color, parent);
+    }
+    else if (color(v) == gray) {
+      // (u, v) is a back edge
+    }
+    else {
+      // (u, v) is a cross or forward edge
+    }
   }
 
   G& graph;
-  std::vector<int> colors;
-  std::vector<int> pre_times;
-  std::vector<int> post_times;
+  C colors;
+  T times;
   std::vector<vertex_t> parents;
-  int clock;
 };
 
 
 // A basic DFS implementation for undirected graphs.
 //
-// TODO: If undirected graphs don't have forward or cross edges, then
-// what's the purpose of maintaining an extra state in order to recover
-// that information? Consider reducing colors to a simple
-template<typename G>
+// Undirected graphs have no forward or cross edges, so the search only
+// needs to know whether a vertex has been discovered. The default color
+// map is a bitset.
+template<typename G,
+         typename C = one_bit_color_map,
+         typename T = dfs_timestamps<>>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
 struct undirected_dfs
 {
   undirected_dfs(G& g)
-    : graph(g), 
-      colors(graph.num_vertices(), 0),
-      pre_times(graph.num_vertices(), -1),
-      post_times(graph.num_vertices(), -1),
-      parents(graph.num_vertices()),
-      clock(0)
+    : graph(g),
+      colors(graph.num_vertices(), white),
+      times(graph.num_vertices()),
+      parents(graph.num_vertices())
   { }
 
   void operator()()
   {
     auto color = vertex_label(colors);
-    auto pre = vertex_label(pre_times);
-    auto post = vertex_label(post_times);
     auto parent = vertex_label(parents);
 
     // Extra initialization.
     for (vertex_t v : graph.vertices())
       parent(v) = v;
-    
-    search(color, pre, post, parent);
+
+    search(color, parent);
   }
 
-  template<typename L1, typename L2>
-  void search(L1 color, L1 pre, L1 post, L2 parent)
+  template<vertex_property L1, vertex_property L2>
+  void search(L1 color, L2 parent)
   {
     for (vertex_t v : graph.vertices()) {
-      if (color(v) == 0)
-        explore(v, color, pre, post, parent);
+      if (color(v) == white)
+        explore(v, color, parent);
     }
   }
 
-  template<typename L1, typename L2>
-  void explore(vertex_t u, L1 color, L1 pre, L1 post, L2 parent)
+  template<vertex_property L1, vertex_property L2>
+  void explore(vertex_t u, L1 color, L2 parent)
   {
-    color(u) = 1;     // color u gray (on stack)
-    pre(u) = clock++;
+    color(u) = gray;  // color u gray (on stack)
+    times.discover(u);
 
     for (edge_t e : graph.edges(u)) {
       vertex_t v = graph.opposite(e, u);
-      if (color(v) == 0) {
+      if (color(v) == white) {
         // (u, v) is a tree edge
         parent(v) = u;
-        explore(v, color, pre, post, parent);
+        explore(v, color, parent);
       }
       else {
         // (u, v) is a back edge
       }
     }
 
-    post(u) = clock++;
-    color(u) = 2; // color u black (done)
+    times.finish(u);
+    color(u) = black; // color u black (done)
   }
 
   G& graph;
-  std::vector<int> colors;
-  std::vector<int> pre_times;
-  std::vector<int> post_times;
+  C colors;
+  T times;
   std::vector<vertex_t> parents;
-  int clock;
 };
 
 
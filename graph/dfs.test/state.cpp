@@ -0,0 +1,82 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../dfs.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  // Packed color maps.
+  two_bit_color_map c2(100);
+  for (vertex_t v = 0; v < 100; ++v)
+    c2[v] = color_t(v % 3);
+  for (vertex_t v = 0; v < 100; ++v)
+    assert(c2[v] == color_t(v % 3));
+  assert(c2.words.size() == 4);
+
+  one_bit_color_map c1(100);
+  c1[3] = gray;
+  c1[64] = black;
+  assert(c1[3] == black);
+  assert(c1[64] == black);
+  assert(c1[4] == white);
+  assert(c1.words.size() == 2);
+
+  using G = digraph<char, int>;
+  G g;
+  vertex_t v[] {
+    g.add_vertex('a'), // 0
+    g.add_vertex('b'), // 1
+    g.add_vertex('c'), // 2
+    g.add_vertex('d'), // 3
+  };
+  g.add_edge(v[0], v[1], 0); // a -> b
+  g.add_edge(v[1], v[2], 1); // b -> c
+  g.add_edge(v[0], v[3], 2); // a -> d
+
+  // Narrow timestamps.
+  directed_dfs<G, two_bit_color_map, dfs_timestamps<std::uint32_t>> d1(g);
+  d1();
+  assert(d1.times.pre_times[0] == 0);
+  assert(d1.times.pre_times[1] == 1);
+  assert(d1.times.pre_times[2] == 2);
+  assert(d1.times.post_times[2] == 3);
+  assert(d1.times.post_times[1] == 4);
+  assert(d1.times.pre_times[3] == 5);
+  assert(d1.times.post_times[3] == 6);
+  assert(d1.times.post_times[0] == 7);
+
+  // No timestamps, byte colors.
+  directed_dfs<G, std::vector<color_t>, no_timestamps> d2(g);
+  d2();
+  assert(d2.parents[0] == 0);
+  assert(d2.parents[1] == 0);
+  assert(d2.parents[2] == 1);
+  assert(d2.parents[3] == 0);
+  for (vertex_t x : g.vertices())
+    assert(d2.colors[x] == black);
+
+  // Undirected search over a bitset.
+  using U = graph<char, int>;
+  U h;
+  h.add_vertex('a');
+  h.add_vertex('b');
+  h.add_vertex('c');
+  h.add_edge(0, 1, 0);
+  h.add_edge(2, 1, 1);
+  undirected_dfs<U, one_bit_color_map, no_timestamps> d3(h);
+  d3();
+  assert(d3.parents[0] == 0);
+  assert(d3.parents[1] == 0);
+  assert(d3.parents[2] == 1);
+}
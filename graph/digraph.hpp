@@ -17,6 +17,8 @@ namespace origin {
 template<typename T = empty>
 struct directed_vertex
 {
+  using label_type = T;
+
   directed_vertex() = default;
 
   directed_vertex(T const& t)
@@ -38,6 +40,34 @@ struct directed_vertex
   T data;
 };
 
+// An unlabeled vertex stores only its incidence lists.
+template<>
+struct directed_vertex<empty>
+{
+  using label_type = empty;
+
+  directed_vertex() = default;
+
+  directed_vertex(empty const&)
+    : out_(), in_()
+  { }
+
+  bool is_source() const { return in_degree() == 0; }
+  bool is_sing() const { return out_degree() == 0; }
+
+  edge_list const& out_edges() const { return out_; }
+  edge_list const& in_edges() const { return in_; }
+
+  std::size_t out_degree() const { return out_.size(); }
+  std::size_t in_degree() const { return in_.size(); }
+  std::size_t degree() const { return out_degree() + in_degree(); }
+
+  edge_list out_;
+  edge_list in_;
+};
+
+static_assert(sizeof(directed_vertex<>) == 2 * sizeof(edge_list), "");
+
 
 // Edges
 
@@ -46,6 +76,8 @@ struct directed_vertex
 template<typename T = empty>
 struct directed_edge
 {
+  using label_type = T;
+
   // TODO: Value-initialize the data element or not? We currently do not.
   directed_edge(vertex_t u, vertex_t v)
     : ends_{u, v}
@@ -62,6 +94,28 @@ struct directed_edge
   T data;
 };
 
+// An unlabeled edge stores only its endpoints.
+template<>
+struct directed_edge<empty>
+{
+  using label_type = empty;
+
+  directed_edge(vertex_t u, vertex_t v)
+    : ends_{u, v}
+  { }
+
+  directed_edge(vertex_t u, vertex_t v, empty const&)
+    : ends_{u, v}
+  { }
+
+  vertex_t source() const { return ends_[0]; }
+  vertex_t target() const { return ends_[1]; }
+
+  vertex_t ends_[2];
+};
+
+static_assert(sizeof(directed_edge<>) == 2 * sizeof(vertex_t), "");
+
 
 // Graph
 
@@ -104,8 +158,8 @@ struct digraph
   edge_iterator end_edges() const;
 
   // Incidence list
-  edge_list out_edges(vertex_t) const;
-  edge_list in_edges(vertex_t) const;
+  edge_list const& out_edges(vertex_t) const;
+  edge_list const& in_edges(vertex_t) const;
 
   std::size_t out_degree(vertex_t) const;
   std::size_t in_degree(vertex_t) const;
@@ -217,7 +271,7 @@ digraph<V, E>::end_edges() const -> edge_iterator
 
 // Returns the list of outgoing edges for v.
 template<typename V, typename E>
-edge_list 
+edge_list const&
 digraph<V, E>::out_edges(vertex_t v) const 
 { 
   return verts_[v].out_edges(); 
@@ -225,7 +279,7 @@ digraph<V, E>::out_edges(vertex_t v) const
 
 // Returns the list incoming edges to v.
 template<typename V, typename E>
-edge_list 
+edge_list const&
 digraph<V, E>::in_edges(vertex_t v) const 
 { 
   return verts_[v].in_edges(); 
@@ -0,0 +1,71 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// The layout of an unlabeled edge before directed_edge was specialized for
+// empty labels.
+struct padded_edge
+{
+  vertex_t ends_[2];
+  empty data;
+};
+
+
+// Scans the edge set of unlabeled and labeled digraphs, and of an array of
+// padded records, summing the endpoints of each edge.
+template<typename Edge>
+void
+scan(char const* name, std::vector<Edge> const& edges, int reps)
+{
+  using clock = std::chrono::steady_clock;
+
+  auto start = clock::now();
+  std::size_t sum = 0;
+  for (int i = 0; i < reps; ++i) {
+    for (Edge const& e : edges)
+      sum += e.ends_[0] + e.ends_[1];
+  }
+  std::chrono::duration<double, std::nano> t = clock::now() - start;
+  double m = double(edges.size()) * reps;
+  std::cout << name << ": " << sizeof(Edge) << " bytes/edge, "
+            << t.count() / m << " ns/edge, "
+            << sizeof(Edge) * m / t.count() << " GB/s (" << sum << ")\n";
+}
+
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 1 << 20;
+  std::size_t m = argc > 2 ? std::atoi(argv[2]) : 1 << 23;
+  int reps = argc > 3 ? std::atoi(argv[3]) : 10;
+
+  std::minstd_rand gen(3);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::vector<directed_edge<>> plain;
+  std::vector<directed_edge<int>> labeled;
+  std::vector<padded_edge> padded;
+  plain.reserve(m);
+  labeled.reserve(m);
+  padded.reserve(m);
+  for (std::size_t i = 0; i < m; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    plain.emplace_back(u, v);
+    labeled.emplace_back(u, v, int(i));
+    padded.push_back({{u, v}, {}});
+  }
+
+  scan("digraph<>", plain, reps);
+  scan("padded", padded, reps);
+  scan("digraph<empty, int>", labeled, reps);
+}
@@ -0,0 +1,356 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_DIJKSTRA_HPP
+#define GRAPH_DIJKSTRA_HPP
+
+#include "common.hpp"
+#include "queue.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// The value type of the label L applied to keys of type K.
+template<typename L, typename K>
+using label_value_t = std::decay_t<decltype(std::declval<L&>()(K()))>;
+
+
+// The per-vertex state of a shortest path search. Only vertices that have
+// been reached are recorded in the touched list, so the state can be reset
+// in time proportional to the size of the previous search.
+template<typename T>
+struct search_state
+{
+  using key_label = decltype(vertex_label(std::declval<std::vector<T>&>()));
+  using queue_type = mutable_binary_heap<vertex_t, key_label>;
+
+  static constexpr T infinity = std::numeric_limits<T>::max();
+
+  search_state(std::size_t n)
+    : distances(n, infinity),
+      keys(n, infinity),
+      parents(n),
+      touched(),
+      queue(n, vertex_label(keys))
+  {
+    for (vertex_t v = 0; v < n; ++v)
+      parents[v] = v;
+  }
+
+  search_state(search_state const&) = delete;
+  search_state& operator=(search_state const&) = delete;
+
+  bool reached(vertex_t v) const { return distances[v] != infinity; }
+
+  void reset();
+  bool relax(vertex_t v, vertex_t u, T d, T h);
+
+  std::vector<T> distances; // Best known distance from the root
+  std::vector<T> keys;      // Queue priority (distance plus estimate)
+  std::vector<vertex_t> parents;
+  std::vector<vertex_t> touched;
+  queue_type queue;
+};
+
+template<typename T>
+void
+search_state<T>::reset()
+{
+  for (vertex_t v : touched) {
+    distances[v] = infinity;
+    keys[v] = infinity;
+    parents[v] = v;
+  }
+  touched.clear();
+  queue.clear();
+}
+
+// Record that v is reached from u at distance d, with an estimated h
+// remaining to the goal. If that improves the distance to v, v is (re-)
+// queued and this returns true.
+template<typename T>
+bool
+search_state<T>::relax(vertex_t v, vertex_t u, T d, T h)
+{
+  if (!reached(v))
+    touched.push_back(v);
+  else if (d >= distances[v])
+    return false;
+  distances[v] = d;
+  parents[v] = u;
+  if (queue.contains(v)) {
+    queue.update(v, d + h);
+  }
+  else {
+    keys[v] = d + h;
+    queue.push(v);
+  }
+  return true;
+}
+
+
+// Computes the shortest paths from a source vertex in a graph whose edges
+// are weighted by a label W with non-negative values. When given a target,
+// the search stops as soon as the target is settled.
+//
+// The search can be run repeatedly; each run only resets the vertices that
+// were reached by the previous one.
+template<typename G, typename W>
+struct dijkstra_search
+{
+  using weight_type = label_value_t<W, edge_t>;
+
+  static constexpr weight_type infinity = search_state<weight_type>::infinity;
+
+  dijkstra_search(G const& g, W weight)
+    : graph(g), weight(weight), state(g.num_vertices()), settled(0)
+  { }
+
+  void operator()(vertex_t s);
+  weight_type operator()(vertex_t s, vertex_t t);
+
+  void search(vertex_t s, vertex_t t);
+
+  std::vector<vertex_t> path(vertex_t t) const;
+
+  G const& graph;
+  W weight;
+  search_state<weight_type> state;
+  std::size_t settled; // Vertices removed from the queue
+};
+
+// Compute the distances to all vertices reachable from s.
+template<typename G, typename W>
+void
+dijkstra_search<G, W>::operator()(vertex_t s)
+{
+  search(s, graph.num_vertices());
+}
+
+// Returns the distance from s to t, or infinity if t is unreachable.
+template<typename G, typename W>
+auto
+dijkstra_search<G, W>::operator()(vertex_t s, vertex_t t) -> weight_type
+{
+  search(s, t);
+  return state.distances[t];
+}
+
+template<typename G, typename W>
+void
+dijkstra_search<G, W>::search(vertex_t s, vertex_t t)
+{
+  state.reset();
+  settled = 0;
+  state.relax(s, s, weight_type(0), weight_type(0));
+  while (!state.queue.is_empty()) {
+    vertex_t u = state.queue.top();
+    state.queue.pop();
+    ++settled;
+    if (u == t)
+      break;
+    weight_type du = state.distances[u];
+    for (edge_t e : graph.out_edges(u)) {
+      assert(weight(e) >= weight_type(0));
+      state.relax(graph.target(e), u, du + weight(e), weight_type(0));
+    }
+  }
+}
+
+// Returns the vertices on the shortest path to t, which must be reachable.
+template<typename G, typename W>
+std::vector<vertex_t>
+dijkstra_search<G, W>::path(vertex_t t) const
+{
+  assert(state.reached(t));
+  std::vector<vertex_t> p {t};
+  while (state.parents[t] != t)
+    p.push_back(t = state.parents[t]);
+  std::reverse(p.begin(), p.end());
+  return p;
+}
+
+
+// A point-to-point search that is guided by a heuristic label H, which
+// estimates the distance from each vertex to the target. The heuristic must
+// be admissible (never overestimate the distance), or the search may not
+// find a shortest path. When the heuristic is also consistent, no vertex
+// is settled more than once.
+template<typename G, typename W, typename H>
+struct astar_search
+{
+  using weight_type = label_value_t<W, edge_t>;
+
+  static constexpr weight_type infinity = search_state<weight_type>::infinity;
+
+  astar_search(G const& g, W weight, H estimate)
+    : graph(g),
+      weight(weight),
+      estimate(estimate),
+      state(g.num_vertices()),
+      settled(0)
+  { }
+
+  weight_type operator()(vertex_t s, vertex_t t);
+
+  std::vector<vertex_t> path(vertex_t t) const;
+
+  G const& graph;
+  W weight;
+  H estimate;
+  search_state<weight_type> state;
+  std::size_t settled;
+};
+
+// Returns the distance from s to t, or infinity if t is unreachable.
+template<typename G, typename W, typename H>
+auto
+astar_search<G, W, H>::operator()(vertex_t s, vertex_t t) -> weight_type
+{
+  state.reset();
+  settled = 0;
+  state.relax(s, s, weight_type(0), estimate(s));
+  while (!state.queue.is_empty()) {
+    vertex_t u = state.queue.top();
+    state.queue.pop();
+    ++settled;
+    if (u == t)
+      break;
+    weight_type du = state.distances[u];
+    for (edge_t e : graph.out_edges(u)) {
+      assert(weight(e) >= weight_type(0));
+      vertex_t v = graph.target(e);
+      state.relax(v, u, du + weight(e), estimate(v));
+    }
+  }
+  return state.distances[t];
+}
+
+// Returns the vertices on the shortest path to t, which must be reachable.
+template<typename G, typename W, typename H>
+std::vector<vertex_t>
+astar_search<G, W, H>::path(vertex_t t) const
+{
+  assert(state.reached(t));
+  std::vector<vertex_t> p {t};
+  while (state.parents[t] != t)
+    p.push_back(t = state.parents[t]);
+  std::reverse(p.begin(), p.end());
+  return p;
+}
+
+
+// A point-to-point search that alternates between a forward search from
+// the source over out edges and a backward search from the target over in
+// edges. The search stops when the sum of the smallest keys in both queues
+// is no less than the shortest path found so far.
+template<typename G, typename W>
+struct bidirectional_dijkstra
+{
+  using weight_type = label_value_t<W, edge_t>;
+
+  static constexpr weight_type infinity = search_state<weight_type>::infinity;
+
+  bidirectional_dijkstra(G const& g, W weight)
+    : graph(g),
+      weight(weight),
+      forward(g.num_vertices()),
+      backward(g.num_vertices()),
+      meet(0),
+      settled(0)
+  { }
+
+  weight_type operator()(vertex_t s, vertex_t t);
+
+  std::vector<vertex_t> path() const;
+
+  G const& graph;
+  W weight;
+  search_state<weight_type> forward;
+  search_state<weight_type> backward;
+  vertex_t meet;       // A vertex on the shortest path
+  weight_type best;    // The length of the shortest path
+  std::size_t settled;
+};
+
+// Returns the distance from s to t, or infinity if t is unreachable.
+template<typename G, typename W>
+auto
+bidirectional_dijkstra<G, W>::operator()(vertex_t s, vertex_t t)
+  -> weight_type
+{
+  forward.reset();
+  backward.reset();
+  settled = 0;
+  forward.relax(s, s, weight_type(0), weight_type(0));
+  backward.relax(t, t, weight_type(0), weight_type(0));
+  best = s == t ? weight_type(0) : infinity;
+  meet = s;
+
+  auto& fq = forward.queue;
+  auto& bq = backward.queue;
+  while (!fq.is_empty() && !bq.is_empty()) {
+    weight_type df = forward.distances[fq.top()];
+    weight_type db = backward.distances[bq.top()];
+    if (best != infinity && df + db >= best)
+      break;
+
+    ++settled;
+    if (df <= db) {
+      vertex_t u = fq.top();
+      fq.pop();
+      for (edge_t e : graph.out_edges(u)) {
+        vertex_t v = graph.target(e);
+        weight_type d = df + weight(e);
+        forward.relax(v, u, d, weight_type(0));
+        if (backward.reached(v) && d + backward.distances[v] < best) {
+          best = d + backward.distances[v];
+          meet = v;
+        }
+      }
+    }
+    else {
+      vertex_t u = bq.top();
+      bq.pop();
+      for (edge_t e : graph.in_edges(u)) {
+        vertex_t v = graph.source(e);
+        weight_type d = db + weight(e);
+        backward.relax(v, u, d, weight_type(0));
+        if (forward.reached(v) && d + forward.distances[v] < best) {
+          best = d + forward.distances[v];
+          meet = v;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+// Returns the vertices on the shortest path found by the last search,
+// which must have succeeded.
+template<typename G, typename W>
+std::vector<vertex_t>
+bidirectional_dijkstra<G, W>::path() const
+{
+  assert(best != infinity);
+  std::vector<vertex_t> p {meet};
+  vertex_t v = meet;
+  while (forward.parents[v] != v)
+    p.push_back(v = forward.parents[v]);
+  std::reverse(p.begin(), p.end());
+  v = meet;
+  while (backward.parents[v] != v)
+    p.push_back(v = backward.parents[v]);
+  return p;
+}
+
+
+} // namespace origin
+
+#endif
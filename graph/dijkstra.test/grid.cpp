@@ -0,0 +1,102 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../dijkstra.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Compares unidirectional, bidirectional, and A* search on a grid with
+// random edge weights, which approximates a road network. The heuristic
+// is the Manhattan distance, scaled by the smallest edge weight.
+int
+main(int argc, char* argv[])
+{
+  std::size_t side = argc > 1 ? std::atoi(argv[1]) : 300;
+  int queries = argc > 2 ? std::atoi(argv[2]) : 100;
+
+  using G = digraph<>;
+  G g;
+  std::vector<int> weights;
+  std::minstd_rand gen(1);
+  std::uniform_int_distribution<int> cost(10, 20);
+  for (std::size_t i = 0; i < side * side; ++i)
+    g.add_vertex();
+  auto id = [side](std::size_t x, std::size_t y) { return y * side + x; };
+  for (std::size_t y = 0; y < side; ++y) {
+    for (std::size_t x = 0; x < side; ++x) {
+      if (x + 1 < side) {
+        int c = cost(gen);
+        g.add_edge(id(x, y), id(x + 1, y));
+        g.add_edge(id(x + 1, y), id(x, y));
+        weights.push_back(c);
+        weights.push_back(c);
+      }
+      if (y + 1 < side) {
+        int c = cost(gen);
+        g.add_edge(id(x, y), id(x, y + 1));
+        g.add_edge(id(x, y + 1), id(x, y));
+        weights.push_back(c);
+        weights.push_back(c);
+      }
+    }
+  }
+  auto weight = edge_label(weights);
+
+  std::uniform_int_distribution<vertex_t> pick(0, g.num_vertices() - 1);
+  std::vector<std::pair<vertex_t, vertex_t>> pairs;
+  for (int i = 0; i < queries; ++i)
+    pairs.emplace_back(pick(gen), pick(gen));
+
+  vertex_t target = 0;
+  auto estimate = [side, &target](vertex_t v) {
+    long dx = long(v % side) - long(target % side);
+    long dy = long(v / side) - long(target / side);
+    return int(10 * (std::labs(dx) + std::labs(dy)));
+  };
+
+  dijkstra_search<G, decltype(weight)> uni(g, weight);
+  bidirectional_dijkstra<G, decltype(weight)> bidi(g, weight);
+  astar_search<G, decltype(weight), decltype(estimate)> astar(g, weight,
+                                                              estimate);
+
+  auto run = [&](char const* name, auto query) {
+    using clock = std::chrono::steady_clock;
+    std::size_t settled = 0;
+    long check = 0;
+    auto start = clock::now();
+    for (auto const& p : pairs) {
+      target = p.second;
+      auto r = query(p.first, p.second);
+      settled += r.first;
+      check += r.second;
+    }
+    std::chrono::duration<double, std::micro> t = clock::now() - start;
+    std::cout << name
+              << ": settled/query " << settled / pairs.size()
+              << ", us/query " << t.count() / pairs.size()
+              << ", checksum " << check << '\n';
+  };
+
+  std::cout << "grid " << side << 'x' << side << ", "
+            << g.num_edges() << " edges, " << queries << " queries\n";
+  run("dijkstra", [&](vertex_t s, vertex_t t) {
+    int d = uni(s, t);
+    return std::make_pair(uni.settled, d);
+  });
+  run("bidirectional", [&](vertex_t s, vertex_t t) {
+    int d = bidi(s, t);
+    return std::make_pair(bidi.settled, d);
+  });
+  run("astar", [&](vertex_t s, vertex_t t) {
+    int d = astar(s, t);
+    return std::make_pair(astar.settled, d);
+  });
+}
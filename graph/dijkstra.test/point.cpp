@@ -0,0 +1,97 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../dijkstra.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  using G = digraph<char, int>;
+  G g;
+  vertex_t v[] {
+    g.add_vertex('a'), // 0
+    g.add_vertex('b'), // 1
+    g.add_vertex('c'), // 2
+    g.add_vertex('d'), // 3
+    g.add_vertex('e'), // 4
+    g.add_vertex('f')  // 5
+  };
+  std::vector<int> weights;
+  auto add = [&](vertex_t u, vertex_t v, int w) {
+    g.add_edge(u, v, weights.size());
+    weights.push_back(w);
+  };
+  add(v[0], v[1], 7);  // a -> b
+  add(v[0], v[2], 9);  // a -> c
+  add(v[0], v[5], 14); // a -> f
+  add(v[1], v[2], 10); // b -> c
+  add(v[1], v[3], 15); // b -> d
+  add(v[2], v[3], 11); // c -> d
+  add(v[2], v[5], 2);  // c -> f
+  add(v[3], v[4], 6);  // d -> e
+  add(v[5], v[4], 9);  // f -> e
+  auto weight = edge_label(weights);
+
+  dijkstra_search<G, decltype(weight)> dijkstra(g, weight);
+  dijkstra(v[0]);
+  assert(dijkstra.state.distances[4] == 20);
+  assert(dijkstra.state.distances[3] == 20);
+  assert((dijkstra.path(4) == std::vector<vertex_t>{0, 2, 5, 4}));
+
+  bidirectional_dijkstra<G, decltype(weight)> bidi(g, weight);
+  assert(bidi(v[0], v[4]) == 20);
+  assert((bidi.path() == std::vector<vertex_t>{0, 2, 5, 4}));
+  assert(bidi(v[4], v[0]) == bidi.infinity);
+  assert(bidi(v[1], v[1]) == 0);
+
+  std::vector<int> zeros(g.num_vertices(), 0);
+  auto estimate = vertex_label(zeros);
+  astar_search<G, decltype(weight), decltype(estimate)> astar(g, weight, estimate);
+  assert(astar(v[0], v[4]) == 20);
+  assert((astar.path(4) == std::vector<vertex_t>{0, 2, 5, 4}));
+  assert(astar(v[5], v[0]) == astar.infinity);
+
+  // Compare searches on a random graph.
+  using R = digraph<>;
+  R r;
+  std::minstd_rand gen(42);
+  std::size_t n = 300;
+  for (std::size_t i = 0; i < n; ++i)
+    r.add_vertex();
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::uniform_int_distribution<int> cost(1, 100);
+  std::vector<int> costs;
+  for (std::size_t i = 0; i < 4 * n; ++i) {
+    vertex_t a = pick(gen), b = pick(gen);
+    if (a != b && !r.has_edge(a, b)) {
+      r.add_edge(a, b);
+      costs.push_back(cost(gen));
+    }
+  }
+  auto w = edge_label(costs);
+  dijkstra_search<R, decltype(w)> d1(r, w);
+  bidirectional_dijkstra<R, decltype(w)> d2(r, w);
+  for (int i = 0; i < 100; ++i) {
+    vertex_t s = pick(gen), t = pick(gen);
+    int x = d1(s, t);
+    int y = d2(s, t);
+    assert(x == y);
+    if (y != d2.infinity) {
+      std::vector<vertex_t> p = d2.path();
+      assert(p.front() == s && p.back() == t);
+      int len = 0;
+      for (std::size_t j = 1; j < p.size(); ++j)
+        len += costs[r.edge(p[j - 1], p[j])];
+      assert(len == y);
+    }
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_DISJOINT_SET_HPP
+#define GRAPH_DISJOINT_SET_HPP
+
+#include "common.hpp"
+
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// A partition of the vertices 0..n into disjoint sets, which supports
+// union by rank and find with path halving.
+struct disjoint_sets
+{
+  disjoint_sets(std::size_t n)
+    : parents(n), ranks(n, 0), count(n)
+  {
+    for (vertex_t v = 0; v < n; ++v)
+      parents[v] = v;
+  }
+
+  std::size_t size() const { return parents.size(); }
+  std::size_t num_sets() const { return count; }
+
+  vertex_t find(vertex_t v);
+  vertex_t root(vertex_t v) const;
+  bool join(vertex_t u, vertex_t v);
+
+  std::vector<vertex_t> parents;
+  std::vector<unsigned char> ranks;
+  std::size_t count;
+};
+
+// Returns the representative of the set containing v, compressing the
+// path to the representative.
+inline vertex_t
+disjoint_sets::find(vertex_t v)
+{
+  while (parents[v] != v) {
+    parents[v] = parents[parents[v]];
+    v = parents[v];
+  }
+  return v;
+}
+
+// Returns the representative of the set containing v without modifying
+// the structure. This can be called concurrently with other reads.
+inline vertex_t
+disjoint_sets::root(vertex_t v) const
+{
+  while (parents[v] != v)
+    v = parents[v];
+  return v;
+}
+
+// Merge the sets containing u and v. Returns false if they are already
+// in the same set.
+inline bool
+disjoint_sets::join(vertex_t u, vertex_t v)
+{
+  u = find(u);
+  v = find(v);
+  if (u == v)
+    return false;
+  if (ranks[u] < ranks[v])
+    std::swap(u, v);
+  parents[v] = u;
+  if (ranks[u] == ranks[v])
+    ++ranks[u];
+  --count;
+  return true;
+}
+
+
+} // namespace origin
+
+#endif
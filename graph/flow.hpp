@@ -0,0 +1,528 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_FLOW_HPP
+#define GRAPH_FLOW_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Maximum flow
+//
+// A flow network is a directed graph with a capacity label on its edges.
+// The residual graph is not built. Instead, the residual arcs leaving a
+// vertex u are the outgoing edges of u, whose residual capacity is their
+// unused capacity, followed by the incoming edges of u, whose residual
+// capacity is the flow on them that can be cancelled. Arc i of u refers
+// to out_edges(u)[i] when i < out_degree(u), and to the corresponding
+// incoming edge otherwise. Self loops never carry flow.
+//
+// Capacities must be non-negative. Flows are exact for integral
+// capacities.
+
+
+// An arc of the residual graph: an edge of the network, traversed forward
+// along its direction or backward against it.
+struct residual_arc
+{
+  edge_t edge;
+  bool forward;
+};
+
+
+// The state shared by the flow algorithms: the network, the flow on each
+// edge, and the value of the flow. After a flow from s to t is computed,
+// the minimum cut separates the vertices reachable from s in the residual
+// graph from the rest.
+template<typename G, typename C>
+  requires bidirectional_graph<G> && edge_property<C>
+struct flow_network
+{
+  using value_type = edge_value_type<C>;
+
+  flow_network(G const& g, C cap)
+    : graph(g), capacity(cap), flows(g.num_edges(), 0), value(0), source(0)
+  { }
+
+  // Residual graph
+  std::size_t num_arcs(vertex_t u) const
+  {
+    return graph.out_degree(u) + graph.in_degree(u);
+  }
+
+  residual_arc arc(vertex_t u, std::size_t i) const
+  {
+    edge_list const& out = graph.out_edges(u);
+    if (i < out.size())
+      return {out[i], true};
+    return {graph.in_edges(u)[i - out.size()], false};
+  }
+
+  vertex_t head(residual_arc a) const
+  {
+    return a.forward ? graph.target(a.edge) : graph.source(a.edge);
+  }
+
+  value_type residual(residual_arc a) const
+  {
+    return a.forward ? capacity(a.edge) - flows[a.edge] : flows[a.edge];
+  }
+
+  void push(residual_arc a, value_type x)
+  {
+    if (a.forward)
+      flows[a.edge] += x;
+    else
+      flows[a.edge] -= x;
+  }
+
+  // Minimum cut
+  std::vector<char> source_side() const;
+  std::vector<edge_t> cut_edges() const;
+
+  // Resets the flow to zero.
+  void reset(vertex_t s);
+
+  G const& graph;
+  C capacity;
+  std::vector<value_type> flows;
+  value_type value;
+  vertex_t source;
+};
+
+template<typename G, typename C>
+  requires bidirectional_graph<G> && edge_property<C>
+void
+flow_network<G, C>::reset(vertex_t s)
+{
+  std::fill(flows.begin(), flows.end(), value_type(0));
+  flows.resize(graph.num_edges(), value_type(0));
+  value = 0;
+  source = s;
+}
+
+// Returns the vertices reachable from the source in the residual graph.
+template<typename G, typename C>
+  requires bidirectional_graph<G> && edge_property<C>
+std::vector<char>
+flow_network<G, C>::source_side() const
+{
+  std::vector<char> side(graph.num_vertices(), 0);
+  std::vector<vertex_t> queue {source};
+  side[source] = 1;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    vertex_t u = queue[i];
+    for (std::size_t j = 0, k = num_arcs(u); j < k; ++j) {
+      residual_arc a = arc(u, j);
+      vertex_t v = head(a);
+      if (!side[v] && residual(a) > value_type(0)) {
+        side[v] = 1;
+        queue.push_back(v);
+      }
+    }
+  }
+  return side;
+}
+
+// Returns the edges from the source side of the minimum cut to the other
+// side. Their capacities sum to the value of the flow.
+template<typename G, typename C>
+  requires bidirectional_graph<G> && edge_property<C>
+std::vector<edge_t>
+flow_network<G, C>::cut_edges() const
+{
+  std::vector<char> side = source_side();
+  std::vector<edge_t> cut;
+  for (edge_t e : graph.edges()) {
+    if (side[graph.source(e)] && !side[graph.target(e)])
+      cut.push_back(e);
+  }
+  return cut;
+}
+
+
+// Computes a maximum flow by the highest-label push-relabel algorithm.
+//
+// Each vertex has a label (height) that bounds its residual distance to
+// the sink, or to the source plus n once it can no longer reach the sink.
+// Active vertices, which have excess flow, are discharged highest label
+// first by pushing excess along admissible arcs to vertices one label
+// lower, and relabeling when no arc is admissible. Two heuristics avoid
+// most relabels:
+//
+//  - Gap: when no vertex has label h < n, vertices with labels between h
+//    and n cannot reach the sink, and are lifted to n + 1 at once.
+//  - Global relabeling: after every n relabels, labels are set to exact
+//    residual distances by breadth-first search from the sink and then
+//    from the source.
+//
+// Excess that cannot reach the sink returns to the source, so the result
+// is a flow, not only a preflow.
+template<typename G, typename C>
+struct push_relabel_max_flow : flow_network<G, C>
+{
+  using base = flow_network<G, C>;
+  using value_type = typename base::value_type;
+
+  push_relabel_max_flow(G const& g, C cap)
+    : base(g, cap), relabels(0), global_relabels(0), gaps(0)
+  { }
+
+  value_type operator()(vertex_t s, vertex_t t);
+
+  void discharge(vertex_t u);
+  void relabel(vertex_t u);
+  void gap(std::size_t h);
+  void global_relabel();
+  void activate(vertex_t v);
+
+  vertex_t sink;
+  std::vector<std::size_t> labels;
+  std::vector<value_type> excess;
+  std::vector<std::size_t> current;     // The next arc to try
+  std::vector<std::size_t> counts;      // The number of vertices per label
+  std::vector<std::vector<vertex_t>> active;  // Active vertices by label
+  std::size_t highest;                  // Bound on active labels
+  std::size_t work;                     // Relabels since the last update
+
+  std::size_t relabels;
+  std::size_t global_relabels;
+  std::size_t gaps;
+};
+
+template<typename G, typename C>
+auto
+push_relabel_max_flow<G, C>::operator()(vertex_t s, vertex_t t)
+  -> value_type
+{
+  std::size_t n = this->graph.num_vertices();
+  this->reset(s);
+  sink = t;
+  if (s == t)
+    return 0;
+  labels.assign(n, 0);
+  excess.assign(n, 0);
+  current.assign(n, 0);
+  active.assign(2 * n + 1, {});
+  highest = 0;
+  work = 0;
+
+  // Saturate the edges leaving the source.
+  for (edge_t e : this->graph.out_edges(s)) {
+    residual_arc a {e, true};
+    vertex_t v = this->head(a);
+    value_type x = this->residual(a);
+    if (v == s || x == value_type(0))
+      continue;
+    this->push(a, x);
+    excess[v] += x;
+    excess[s] -= x;
+  }
+  global_relabel();
+
+  while (true) {
+    while (highest > 0 && active[highest].empty())
+      --highest;
+    if (active[highest].empty())
+      break;
+    vertex_t u = active[highest].back();
+    active[highest].pop_back();
+    if (labels[u] != highest || excess[u] == value_type(0))
+      continue; // A stale entry
+    discharge(u);
+    if (work >= n)
+      global_relabel();
+  }
+  this->value = excess[t];
+  return this->value;
+}
+
+// Push the excess of u along admissible arcs, relabeling u as needed.
+template<typename G, typename C>
+void
+push_relabel_max_flow<G, C>::discharge(vertex_t u)
+{
+  std::size_t n = this->graph.num_vertices();
+  std::size_t k = this->num_arcs(u);
+  while (excess[u] > value_type(0)) {
+    if (current[u] == k) {
+      relabel(u);
+      if (labels[u] >= 2 * n)
+        return;
+      continue;
+    }
+    residual_arc a = this->arc(u, current[u]);
+    vertex_t v = this->head(a);
+    value_type r = this->residual(a);
+    if (r > value_type(0) && labels[u] == labels[v] + 1) {
+      value_type x = std::min(excess[u], r);
+      this->push(a, x);
+      excess[u] -= x;
+      if (excess[v] == value_type(0))
+        activate(v);
+      excess[v] += x;
+    }
+    else {
+      ++current[u];
+    }
+  }
+}
+
+// Lift u to one more than the lowest label reachable by a residual arc.
+template<typename G, typename C>
+void
+push_relabel_max_flow<G, C>::relabel(vertex_t u)
+{
+  std::size_t n = this->graph.num_vertices();
+  std::size_t h = labels[u];
+  std::size_t low = 2 * n;
+  for (std::size_t i = 0, k = this->num_arcs(u); i < k; ++i) {
+    residual_arc a = this->arc(u, i);
+    if (this->residual(a) > value_type(0))
+      low = std::min(low, labels[this->head(a)] + 1);
+  }
+  ++relabels;
+  ++work;
+  current[u] = 0;
+  if (--counts[h] == 0 && h < n) {
+    // No vertex is left at h, so nothing above it can reach the sink.
+    labels[u] = std::max(low, n + 1);
+    gap(h);
+  }
+  else {
+    labels[u] = low;
+  }
+  if (labels[u] < 2 * n) {
+    ++counts[labels[u]];
+    highest = std::max(highest, labels[u]);
+  }
+}
+
+// Lift the vertices with labels between h and n to n + 1.
+template<typename G, typename C>
+void
+push_relabel_max_flow<G, C>::gap(std::size_t h)
+{
+  std::size_t n = this->graph.num_vertices();
+  ++gaps;
+  for (vertex_t v = 0; v < n; ++v) {
+    if (h < labels[v] && labels[v] < n) {
+      --counts[labels[v]];
+      labels[v] = n + 1;
+      ++counts[n + 1];
+      current[v] = 0;
+      if (excess[v] > value_type(0) && v != sink)
+        active[n + 1].push_back(v);
+    }
+  }
+  highest = std::max(highest, n + 1);
+}
+
+// Set labels to residual distances to the sink, or to n plus residual
+// distances to the source for vertices that cannot reach the sink, and
+// rebuild the active lists.
+template<typename G, typename C>
+void
+push_relabel_max_flow<G, C>::global_relabel()
+{
+  std::size_t n = this->graph.num_vertices();
+  vertex_t s = this->source;
+  ++global_relabels;
+  work = 0;
+  labels.assign(n, 2 * n);
+  labels[sink] = 0;
+  labels[s] = n;
+
+  // Search backward: u precedes v if the residual arc (u, v) has capacity.
+  std::vector<vertex_t> queue;
+  auto search = [&](vertex_t r) {
+    queue.assign(1, r);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      vertex_t v = queue[i];
+      std::size_t d = labels[v] + 1;
+      for (edge_t e : this->graph.out_edges(v)) {
+        vertex_t u = this->graph.target(e);
+        if (labels[u] == 2 * n && this->flows[e] > value_type(0)) {
+          labels[u] = d;
+          queue.push_back(u);
+        }
+      }
+      for (edge_t e : this->graph.in_edges(v)) {
+        vertex_t u = this->graph.source(e);
+        if (labels[u] == 2 * n &&
+            this->capacity(e) - this->flows[e] > value_type(0)) {
+          labels[u] = d;
+          queue.push_back(u);
+        }
+      }
+    }
+  };
+  search(sink);
+  search(s);
+
+  counts.assign(2 * n + 1, 0);
+  for (auto& list : active)
+    list.clear();
+  highest = 0;
+  for (vertex_t v = 0; v < n; ++v) {
+    current[v] = 0;
+    if (labels[v] < 2 * n)
+      ++counts[labels[v]];
+    if (v != s && v != sink && excess[v] > value_type(0))
+      activate(v);
+  }
+}
+
+template<typename G, typename C>
+void
+push_relabel_max_flow<G, C>::activate(vertex_t v)
+{
+  if (v == this->source || v == sink)
+    return;
+  active[labels[v]].push_back(v);
+  highest = std::max(highest, labels[v]);
+}
+
+
+// Computes a maximum flow by Dinic's algorithm. Each phase labels vertices
+// by their residual distance from the source, and then saturates the level
+// graph with a blocking flow found by depth-first search. The search
+// resumes from the last arc tried at each vertex and abandons vertices
+// that cannot reach the sink. There are at most n phases.
+template<typename G, typename C>
+struct dinic_max_flow : flow_network<G, C>
+{
+  using base = flow_network<G, C>;
+  using value_type = typename base::value_type;
+
+  static constexpr std::size_t none = std::size_t(-1);
+
+  dinic_max_flow(G const& g, C cap)
+    : base(g, cap), phases(0)
+  { }
+
+  value_type operator()(vertex_t s, vertex_t t);
+
+  bool levelize(vertex_t t);
+  value_type blocking_flow(vertex_t t);
+
+  std::vector<std::size_t> levels;
+  std::vector<std::size_t> current;
+  std::vector<std::pair<vertex_t, residual_arc>> path;
+  std::size_t phases;
+};
+
+template<typename G, typename C>
+auto
+dinic_max_flow<G, C>::operator()(vertex_t s, vertex_t t) -> value_type
+{
+  this->reset(s);
+  if (s == t)
+    return 0;
+  phases = 0;
+  while (levelize(t)) {
+    ++phases;
+    current.assign(this->graph.num_vertices(), 0);
+    this->value += blocking_flow(t);
+  }
+  return this->value;
+}
+
+// Compute the residual distance of each vertex from the source. Returns
+// true if the sink is reachable.
+template<typename G, typename C>
+bool
+dinic_max_flow<G, C>::levelize(vertex_t t)
+{
+  levels.assign(this->graph.num_vertices(), none);
+  std::vector<vertex_t> queue {this->source};
+  levels[this->source] = 0;
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    vertex_t u = queue[i];
+    for (std::size_t j = 0, k = this->num_arcs(u); j < k; ++j) {
+      residual_arc a = this->arc(u, j);
+      vertex_t v = this->head(a);
+      if (levels[v] == none && this->residual(a) > value_type(0)) {
+        levels[v] = levels[u] + 1;
+        queue.push_back(v);
+      }
+    }
+  }
+  return levels[t] != none;
+}
+
+// Saturate the level graph by repeatedly finding paths to the sink and
+// pushing their bottleneck capacity. After each push, the search resumes
+// from the tail of the first saturated arc. Returns the flow pushed.
+template<typename G, typename C>
+auto
+dinic_max_flow<G, C>::blocking_flow(vertex_t t) -> value_type
+{
+  value_type total = 0;
+  path.clear();
+  vertex_t u = this->source;
+  while (true) {
+    if (u == t) {
+      value_type x = this->residual(path.front().second);
+      for (auto const& p : path)
+        x = std::min(x, this->residual(p.second));
+      for (auto const& p : path)
+        this->push(p.second, x);
+      total += x;
+      std::size_t i = 0;
+      while (this->residual(path[i].second) > value_type(0))
+        ++i;
+      u = path[i].first;
+      path.resize(i);
+      continue;
+    }
+
+    std::size_t k = this->num_arcs(u);
+    while (current[u] < k) {
+      residual_arc a = this->arc(u, current[u]);
+      vertex_t v = this->head(a);
+      if (levels[v] == levels[u] + 1 && this->residual(a) > value_type(0))
+        break;
+      ++current[u];
+    }
+    if (current[u] < k) {
+      // Advance.
+      residual_arc a = this->arc(u, current[u]);
+      path.emplace_back(u, a);
+      u = this->head(a);
+    }
+    else {
+      // Retreat. No path to the sink passes through u.
+      levels[u] = none;
+      if (path.empty())
+        return total;
+      u = path.back().first;
+      path.pop_back();
+      ++current[u];
+    }
+  }
+}
+
+
+// Returns the value of a maximum flow from s to t in g, whose edges have
+// the given capacities.
+template<typename G, typename C>
+  requires bidirectional_graph<G> && edge_property<C>
+edge_value_type<C>
+max_flow(G const& g, C capacity, vertex_t s, vertex_t t)
+{
+  push_relabel_max_flow<G, C> flow(g, capacity);
+  return flow(s, t);
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../flow.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+
+using namespace origin;
+
+using G = digraph<empty, long>;
+
+
+// Reads a maximum flow problem in the DIMACS format, with lines
+//
+//    p max <vertices> <arcs>
+//    n <vertex> s|t
+//    a <source> <target> <capacity>
+//
+// Vertices are numbered from 1. Parallel arcs are merged.
+void
+read_dimacs(std::istream& is, G& g, vertex_t& s, vertex_t& t)
+{
+  std::string line;
+  while (std::getline(is, line)) {
+    std::istringstream ss(line);
+    char kind;
+    if (!(ss >> kind))
+      continue;
+    if (kind == 'p') {
+      std::string type;
+      std::size_t n, m;
+      ss >> type >> n >> m;
+      for (std::size_t i = 0; i < n; ++i)
+        g.add_vertex();
+    }
+    else if (kind == 'n') {
+      vertex_t v;
+      char which;
+      ss >> v >> which;
+      (which == 's' ? s : t) = v - 1;
+    }
+    else if (kind == 'a') {
+      vertex_t u, v;
+      long c;
+      ss >> u >> v >> c;
+      if (g.has_edge(u - 1, v - 1))
+        g.edges_[g.edge(u - 1, v - 1)].data += c;
+      else
+        g.add_edge(u - 1, v - 1, c);
+    }
+  }
+}
+
+// Generates an instance in the style of the GENRMF generator: b frames of
+// a x a grids. Grid edges in both directions have capacity c2 * a * a, and
+// each vertex has an edge to a random vertex of the next frame with a
+// random capacity in [c1, c2]. The source is a corner of the first frame
+// and the sink is the opposite corner of the last.
+void
+generate_rmf(G& g, vertex_t& s, vertex_t& t, std::size_t a, std::size_t b,
+             long c1, long c2)
+{
+  std::minstd_rand gen(13);
+  std::uniform_int_distribution<long> cap(c1, c2);
+  std::uniform_int_distribution<vertex_t> pick(0, a * a - 1);
+  for (std::size_t i = 0; i < a * a * b; ++i)
+    g.add_vertex();
+  auto id = [a](std::size_t f, std::size_t x, std::size_t y) {
+    return f * a * a + x * a + y;
+  };
+  long big = c2 * long(a * a);
+  for (std::size_t f = 0; f < b; ++f) {
+    for (std::size_t x = 0; x < a; ++x)
+      for (std::size_t y = 0; y < a; ++y) {
+        vertex_t u = id(f, x, y);
+        if (x + 1 < a) {
+          g.add_edge(u, id(f, x + 1, y), big);
+          g.add_edge(id(f, x + 1, y), u, big);
+        }
+        if (y + 1 < a) {
+          g.add_edge(u, id(f, x, y + 1), big);
+          g.add_edge(id(f, x, y + 1), u, big);
+        }
+        if (f + 1 < b) {
+          vertex_t v = (f + 1) * a * a + pick(gen);
+          g.add_edge(u, v, cap(gen));
+        }
+      }
+  }
+  s = id(0, 0, 0);
+  t = id(b - 1, a - 1, a - 1);
+}
+
+// Solves a DIMACS instance given as the first argument, or a generated
+// one, with push-relabel and with Dinic's algorithm.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  G g;
+  vertex_t s = 0, t = 0;
+  if (argc > 1 && std::string(argv[1]) != "rmf") {
+    std::ifstream in(argv[1]);
+    read_dimacs(in, g, s, t);
+  }
+  else {
+    std::size_t a = argc > 2 ? std::atoi(argv[2]) : 32;
+    std::size_t b = argc > 3 ? std::atoi(argv[3]) : 32;
+    generate_rmf(g, s, t, a, b, 1, 10000);
+  }
+  std::cout << g.num_vertices() << " vertices, " << g.num_edges()
+            << " edges\n";
+  auto cap = [&g](edge_t e) { return g.edges_[e].data; };
+
+  push_relabel_max_flow<G, decltype(cap)> pr(g, cap);
+  auto start = clock::now();
+  long v1 = pr(s, t);
+  ms t1 = clock::now() - start;
+  std::cout << "push-relabel: " << t1.count() << " ms, flow " << v1
+            << ", " << pr.relabels << " relabels, " << pr.gaps << " gaps, "
+            << pr.global_relabels << " global relabels\n";
+
+  dinic_max_flow<G, decltype(cap)> dinic(g, cap);
+  start = clock::now();
+  long v2 = dinic(s, t);
+  ms t2 = clock::now() - start;
+  std::cout << "dinic: " << t2.count() << " ms, flow " << v2 << ", "
+            << dinic.phases << " phases\n";
+
+  start = clock::now();
+  std::size_t cut = pr.cut_edges().size();
+  ms t3 = clock::now() - start;
+  std::cout << "min cut: " << t3.count() << " ms, " << cut << " edges\n";
+  return v1 == v2 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../flow.hpp"
+
+#include <cassert>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Check that the flow respects capacities and is conserved at every
+// vertex other than s and t, that its value leaves s, and that the
+// minimum cut has the same capacity.
+template<typename F>
+void
+check(F const& flow, vertex_t s, vertex_t t)
+{
+  auto const& g = flow.graph;
+  std::vector<long> net(g.num_vertices(), 0);
+  for (edge_t e : g.edges()) {
+    assert(0 <= flow.flows[e] && flow.flows[e] <= flow.capacity(e));
+    net[g.source(e)] -= flow.flows[e];
+    net[g.target(e)] += flow.flows[e];
+  }
+  for (vertex_t v : g.vertices()) {
+    if (v == s)
+      assert(net[v] == -flow.value);
+    else if (v == t)
+      assert(net[v] == flow.value);
+    else
+      assert(net[v] == 0);
+  }
+
+  std::vector<char> side = flow.source_side();
+  assert(side[s] && !side[t]);
+  long cut = 0;
+  for (edge_t e : flow.cut_edges()) {
+    assert(flow.flows[e] == flow.capacity(e));
+    cut += flow.capacity(e);
+  }
+  assert(cut == flow.value);
+}
+
+int
+main()
+{
+  using G = digraph<empty, long>;
+
+  // The network of Cormen et al., with a maximum flow of 23.
+  {
+    G g;
+    for (int i = 0; i < 6; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1, 16);
+    g.add_edge(0, 2, 13);
+    g.add_edge(2, 1, 4);
+    g.add_edge(1, 3, 12);
+    g.add_edge(3, 2, 9);
+    g.add_edge(2, 4, 14);
+    g.add_edge(4, 3, 7);
+    g.add_edge(3, 5, 20);
+    g.add_edge(4, 5, 4);
+    auto cap = [&g](edge_t e) { return g.edges_[e].data; };
+
+    push_relabel_max_flow<G, decltype(cap)> pr(g, cap);
+    assert(pr(0, 5) == 23);
+    check(pr, 0, 5);
+    std::vector<char> side = pr.source_side();
+    assert((side == std::vector<char>{1, 1, 1, 0, 1, 0}));
+
+    dinic_max_flow<G, decltype(cap)> dinic(g, cap);
+    assert(dinic(0, 5) == 23);
+    check(dinic, 0, 5);
+
+    assert(max_flow(g, cap, 5, 0) == 0);
+    assert(max_flow(g, cap, 2, 3) == 11);
+  }
+
+  // Random networks, where both algorithms agree.
+  std::minstd_rand gen(41);
+  for (int trial = 0; trial < 50; ++trial) {
+    std::size_t n = 2 + gen() % 40;
+    std::size_t m = gen() % (4 * n);
+    G g;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (std::size_t i = 0; i < m; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v, gen() % 20);
+    }
+    auto cap = [&g](edge_t e) { return g.edges_[e].data; };
+    vertex_t s = pick(gen), t = pick(gen);
+    if (s == t)
+      continue;
+
+    push_relabel_max_flow<G, decltype(cap)> pr(g, cap);
+    dinic_max_flow<G, decltype(cap)> dinic(g, cap);
+    long a = pr(s, t);
+    long b = dinic(s, t);
+    assert(a == b);
+    check(pr, s, t);
+    check(dinic, s, t);
+  }
+}
@@ -0,0 +1,285 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_FOR_EACH_HPP
+#define GRAPH_FOR_EACH_HPP
+
+#include "common.hpp"
+#include "gather.hpp"
+#include "parallel.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+
+namespace origin {
+
+// Parallel iteration
+//
+// The algorithms below apply a function to each vertex or edge of a graph
+// in parallel. Elements are split into contiguous parts, and parts are
+// assigned to threads according to a schedule:
+//
+//    static_schedule    One part of about equal size per thread.
+//    dynamic_schedule   Parts of grain elements, claimed by threads as they
+//                       finish earlier parts.
+//    edge_schedule      Parts of vertices whose degrees (plus one for the
+//                       vertex) sum to about grain, claimed dynamically.
+//
+// The static schedule has the least overhead. The dynamic schedule is
+// better when the cost per element varies. The edge schedule is better
+// when the cost of a vertex is proportional to its degree, as for skewed
+// degree distributions. For edges, the edge schedule is the same as the
+// dynamic schedule.
+//
+// The function may be called concurrently from different threads, and
+// elements are visited in no particular order. Reductions combine the
+// result of each part in order, so they are deterministic for a given
+// schedule and number of threads.
+enum schedule_t : unsigned char
+{
+  static_schedule,
+  dynamic_schedule,
+  edge_schedule
+};
+
+
+namespace for_each_impl {
+
+// Split [0, n) into parts for the static or dynamic schedule.
+inline vertex_partition
+uniform_parts(std::size_t n, schedule_t s, std::size_t grain)
+{
+  std::size_t k = (n + grain - 1) / grain;
+  if (s == static_schedule)
+    k = std::min(k, concurrency());
+  vertex_partition p;
+  for (std::size_t i = 0; i <= k; ++i)
+    p.bounds.push_back(k ? n * i / k : 0);
+  return p;
+}
+
+// Split the vertices of g into parts for the schedule s. The work for
+// each vertex under the edge schedule is given by degree(v).
+template<typename G, typename D>
+vertex_partition
+vertex_parts(G const& g, schedule_t s, std::size_t grain, D degree)
+{
+  if (s != edge_schedule)
+    return uniform_parts(g.num_vertices(), s, grain);
+  std::size_t total = g.num_vertices() + g.num_edges();
+  std::size_t k = std::max<std::size_t>(1, total / grain);
+  return partition_vertices(g, k, [degree](vertex_t v) {
+    return 1 + degree(v);
+  });
+}
+
+// Call f(i) for each part of p according to s. If pool is not null, parts
+// are executed by its threads, and the schedule only determines the parts.
+template<typename F>
+void
+run_parts(thread_pool* pool, vertex_partition const& p, schedule_t s, F f)
+{
+  auto body = [&f](counted_range<std::size_t> r) {
+    for (std::size_t i : r)
+      f(i);
+  };
+  if (pool)
+    parallel_for(*pool, p.parts(), body, 1);
+  else if (s == static_schedule)
+    parallel_for(p.parts(), body, 1);
+  else
+    parallel_for_dynamic(p.parts(), body, 1);
+}
+
+// Combine the results of map over each part of p, and then combine the
+// results of the parts in order.
+template<typename T, typename M, typename C>
+T
+reduce_parts(thread_pool* pool, vertex_partition const& p, schedule_t s,
+             M map, T zero, C combine)
+{
+  std::vector<T> partial(p.size(), zero);
+  run_parts(pool, p, s, [&](std::size_t i) {
+    T acc = zero;
+    for (std::size_t x : p.part(i))
+      acc = combine(acc, map(x));
+    partial[i] = acc;
+  });
+  T acc = zero;
+  for (T const& x : partial)
+    acc = combine(acc, x);
+  return acc;
+}
+
+template<typename G, typename F>
+void
+for_each_vertex(thread_pool* pool, G const& g, F f, schedule_t s,
+                std::size_t grain)
+{
+  vertex_partition p = vertex_parts(g, s, grain, [&g](vertex_t v) {
+    return g.degree(v);
+  });
+  run_parts(pool, p, s, [&](std::size_t i) {
+    for (vertex_t v : p.part(i))
+      f(v);
+  });
+}
+
+template<typename G, typename F>
+void
+for_each_edge(thread_pool* pool, G const& g, F f, schedule_t s,
+              std::size_t grain)
+{
+  if (s == edge_schedule)
+    s = dynamic_schedule;
+  vertex_partition p = uniform_parts(g.num_edges(), s, grain);
+  run_parts(pool, p, s, [&](std::size_t i) {
+    for (edge_t e : p.part(i))
+      f(e);
+  });
+}
+
+template<typename G, typename F>
+void
+for_each_out_edge(thread_pool* pool, G const& g, F f, schedule_t s,
+                  std::size_t grain)
+{
+  vertex_partition p = vertex_parts(g, s, grain, [&g](vertex_t v) {
+    return g.out_degree(v);
+  });
+  run_parts(pool, p, s, [&](std::size_t i) {
+    for (vertex_t u : p.part(i))
+      for (edge_t e : g.out_edges(u))
+        f(u, e);
+  });
+}
+
+template<typename G, typename M, typename T, typename C>
+T
+reduce_vertices(thread_pool* pool, G const& g, M map, T zero, C combine,
+                schedule_t s, std::size_t grain)
+{
+  vertex_partition p = vertex_parts(g, s, grain, [&g](vertex_t v) {
+    return g.degree(v);
+  });
+  return reduce_parts(pool, p, s, map, zero, combine);
+}
+
+template<typename G, typename M, typename T, typename C>
+T
+reduce_edges(thread_pool* pool, G const& g, M map, T zero, C combine,
+             schedule_t s, std::size_t grain)
+{
+  if (s == edge_schedule)
+    s = dynamic_schedule;
+  vertex_partition p = uniform_parts(g.num_edges(), s, grain);
+  return reduce_parts(pool, p, s, map, zero, combine);
+}
+
+} // namespace for_each_impl
+
+
+// Each algorithm below has an overload whose first argument is a thread
+// pool, which executes the parts instead of newly started threads.
+
+// Call f(v) for each vertex v of g.
+template<typename G, typename F>
+void
+for_each_vertex(G const& g, F f, schedule_t s = static_schedule,
+                std::size_t grain = 1024)
+{
+  for_each_impl::for_each_vertex(nullptr, g, f, s, grain);
+}
+
+template<typename G, typename F>
+void
+for_each_vertex(thread_pool& pool, G const& g, F f,
+                schedule_t s = static_schedule, std::size_t grain = 1024)
+{
+  for_each_impl::for_each_vertex(&pool, g, f, s, grain);
+}
+
+// Call f(e) for each edge e of g.
+template<typename G, typename F>
+void
+for_each_edge(G const& g, F f, schedule_t s = static_schedule,
+              std::size_t grain = 1024)
+{
+  for_each_impl::for_each_edge(nullptr, g, f, s, grain);
+}
+
+template<typename G, typename F>
+void
+for_each_edge(thread_pool& pool, G const& g, F f,
+              schedule_t s = static_schedule, std::size_t grain = 1024)
+{
+  for_each_impl::for_each_edge(&pool, g, f, s, grain);
+}
+
+// Call f(u, e) for each vertex u of the directed graph g, and each edge e
+// leaving u. All the edges leaving a vertex are visited by the same thread,
+// in order.
+template<typename G, typename F>
+void
+for_each_out_edge(G const& g, F f, schedule_t s = edge_schedule,
+                  std::size_t grain = 1024)
+{
+  for_each_impl::for_each_out_edge(nullptr, g, f, s, grain);
+}
+
+template<typename G, typename F>
+void
+for_each_out_edge(thread_pool& pool, G const& g, F f,
+                  schedule_t s = edge_schedule, std::size_t grain = 1024)
+{
+  for_each_impl::for_each_out_edge(&pool, g, f, s, grain);
+}
+
+
+// Returns the combination of map(v) for each vertex v of g.
+template<typename G, typename M, typename T, typename C = std::plus<>>
+T
+reduce_vertices(G const& g, M map, T zero, C combine = C(),
+                schedule_t s = static_schedule, std::size_t grain = 1024)
+{
+  return for_each_impl::reduce_vertices(nullptr, g, map, zero, combine,
+                                        s, grain);
+}
+
+template<typename G, typename M, typename T, typename C = std::plus<>>
+T
+reduce_vertices(thread_pool& pool, G const& g, M map, T zero,
+                C combine = C(), schedule_t s = static_schedule,
+                std::size_t grain = 1024)
+{
+  return for_each_impl::reduce_vertices(&pool, g, map, zero, combine,
+                                        s, grain);
+}
+
+// Returns the combination of map(e) for each edge e of g.
+template<typename G, typename M, typename T, typename C = std::plus<>>
+T
+reduce_edges(G const& g, M map, T zero, C combine = C(),
+             schedule_t s = static_schedule, std::size_t grain = 1024)
+{
+  return for_each_impl::reduce_edges(nullptr, g, map, zero, combine,
+                                     s, grain);
+}
+
+template<typename G, typename M, typename T, typename C = std::plus<>>
+T
+reduce_edges(thread_pool& pool, G const& g, M map, T zero,
+             C combine = C(), schedule_t s = static_schedule,
+             std::size_t grain = 1024)
+{
+  return for_each_impl::reduce_edges(&pool, g, map, zero, combine,
+                                     s, grain);
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../for_each.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Returns true if each counter is exactly 1.
+bool
+once(std::vector<std::atomic<int>> const& seen)
+{
+  for (auto const& x : seen)
+    if (x.load() != 1)
+      return false;
+  return true;
+}
+
+
+int
+main()
+{
+  // A star and a random graph, so that degrees are skewed.
+  digraph<> g;
+  std::size_t n = 5000;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  for (vertex_t v = 1; v < n; ++v)
+    g.add_edge(0, v);
+  std::minstd_rand gen(13);
+  std::uniform_int_distribution<vertex_t> pick(1, n - 1);
+  for (int i = 0; i < 20000; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (!g.has_edge(u, v))
+      g.add_edge(u, v);
+  }
+
+  std::size_t out = 0;
+  for (vertex_t v : g.vertices())
+    out += v * g.out_degree(v);
+
+  for (schedule_t s : {static_schedule, dynamic_schedule, edge_schedule}) {
+    for (std::size_t grain : {1, 100, 100000}) {
+      std::vector<std::atomic<int>> verts(n);
+      for_each_vertex(g, [&](vertex_t v) { ++verts[v]; }, s, grain);
+      assert(once(verts));
+
+      std::vector<std::atomic<int>> edges(g.num_edges());
+      for_each_edge(g, [&](edge_t e) { ++edges[e]; }, s, grain);
+      assert(once(edges));
+
+      std::vector<std::atomic<int>> outs(g.num_edges());
+      for_each_out_edge(g, [&](vertex_t u, edge_t e) {
+        assert(g.source(e) == u);
+        ++outs[e];
+      }, s, grain);
+      assert(once(outs));
+
+      auto degree = [&g](vertex_t v) { return g.out_degree(v); };
+      assert(reduce_vertices(g, degree, std::size_t(0), std::plus<>(),
+                             s, grain) == g.num_edges());
+      auto source = [&g](edge_t e) { return g.source(e); };
+      assert(reduce_edges(g, source, std::size_t(0), std::plus<>(),
+                          s, grain) == out);
+    }
+  }
+
+  // Undirected graphs and the default schedule.
+  graph<> h;
+  for (int i = 0; i < 10; ++i)
+    h.add_vertex();
+  for (vertex_t v = 1; v < 10; ++v)
+    h.add_edge(v - 1, v);
+  auto max = [](std::size_t a, std::size_t b) { return std::max(a, b); };
+  assert(reduce_vertices(h, [&h](vertex_t v) { return h.degree(v); },
+                         std::size_t(0), max) == 2);
+  assert(reduce_edges(h, [](edge_t) { return 1; }, 0) == 9);
+
+  // An empty graph.
+  digraph<> z;
+  for_each_vertex(z, [](vertex_t) { assert(false); }, edge_schedule);
+  for_each_edge(z, [](edge_t) { assert(false); }, dynamic_schedule);
+  assert(reduce_edges(z, [](edge_t) { return 1; }, 0) == 0);
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_GATHER_HPP
+#define GRAPH_GATHER_HPP
+
+#include "common.hpp"
+#include "parallel.hpp"
+
+#include <functional>
+#include <vector>
+
+
+namespace origin {
+
+// A partition of the vertices of a graph into contiguous ranges. Part i
+// contains the vertices in [bounds[i], bounds[i + 1]).
+struct vertex_partition
+{
+  std::size_t size() const { return bounds.size() - 1; }
+
+  counted_range<vertex_t> part(std::size_t i) const
+  {
+    return {bounds[i], bounds[i + 1]};
+  }
+
+  // Returns the range of part indexes.
+  counted_range<std::size_t> parts() const { return size(); }
+
+  std::vector<vertex_t> bounds;
+};
+
+
+// Partition the vertices of g into at most n contiguous ranges, each having
+// about the same total weight, where weight(v) is the work for vertex v.
+template<typename G, typename W>
+vertex_partition
+partition_vertices(G const& g, std::size_t n, W weight)
+{
+  std::size_t nv = g.num_vertices();
+  std::size_t total = 0;
+  for (vertex_t v = 0; v < nv; ++v)
+    total += weight(v);
+  vertex_partition p;
+  p.bounds.push_back(0);
+  std::size_t work = 0;
+  for (vertex_t v = 0; v < nv && p.bounds.size() < n; ++v) {
+    work += weight(v);
+    if (work * n >= total * p.bounds.size())
+      p.bounds.push_back(v + 1);
+  }
+  if (p.bounds.back() != nv)
+    p.bounds.push_back(nv);
+  return p;
+}
+
+// Partition the vertices of g into n contiguous ranges, each having about
+// the same number of incoming edges. Each vertex also counts as one unit of
+// work, so ranges of vertices with no incoming edges are also balanced.
+template<typename G>
+vertex_partition
+partition_in_edges(G const& g, std::size_t n)
+{
+  return partition_vertices(g, n, [&g](vertex_t v) {
+    return 1 + g.in_degree(v);
+  });
+}
+
+
+// For each vertex v of g, compute the combination of map(e) for each edge
+// e entering v, and store the result in y[v]. Vertices with no incoming
+// edges are assigned zero. This is the transposed sparse matrix-vector
+// product when map(e) is the product of the weight of e and the value of
+// its source.
+//
+// Each part of the partition is computed by a single thread. Different
+// parts are computed in parallel.
+template<typename G, typename T, typename M, typename C = std::plus<>>
+void
+gather_in_edges(G const& g, vertex_partition const& parts,
+                std::vector<T>& y, M map, T zero = T(), C combine = C())
+{
+  parallel_for(parts.parts(), [&](counted_range<std::size_t> r) {
+    for (std::size_t i : r) {
+      for (vertex_t v : parts.part(i)) {
+        T acc = zero;
+        for (edge_t e : g.in_edges(v))
+          acc = combine(acc, map(e));
+        y[v] = acc;
+      }
+    }
+  }, 1);
+}
+
+
+// For each part of the partition, compute the combination of map(v) for
+// each vertex v in that part, and store the result in y[i]. Parts are
+// reduced in parallel. This returns the combination of all parts.
+template<typename T, typename M, typename C = std::plus<>>
+T
+reduce_parts(vertex_partition const& parts, std::vector<T>& y, M map,
+             T zero = T(), C combine = C())
+{
+  y.assign(parts.size(), zero);
+  parallel_for(parts.parts(), [&](counted_range<std::size_t> r) {
+    for (std::size_t i : r) {
+      T acc = zero;
+      for (vertex_t v : parts.part(i))
+        acc = combine(acc, map(v));
+      y[i] = acc;
+    }
+  }, 1);
+  T acc = zero;
+  for (T const& x : y)
+    acc = combine(acc, x);
+  return acc;
+}
+
+
+} // namespace origin
+
+#endif
@@ -17,6 +17,8 @@ namespace origin {
 template<typename T = empty>
 struct undirected_vertex
 {
+  using label_type = T;
+
   undirected_vertex() = default;
 
   undirected_vertex(T const& t)
@@ -31,6 +33,27 @@ struct undirected_vertex
   T data;
 };
 
+// An unlabeled vertex stores only its incidence list.
+template<>
+struct undirected_vertex<empty>
+{
+  using label_type = empty;
+
+  undirected_vertex() = default;
+
+  undirected_vertex(empty const&)
+    : edges_()
+  { }
+
+  edge_list const& edges() const { return edges_; }
+
+  std::size_t degree() const { return edges_.size(); }
+
+  edge_list edges_;
+};
+
+static_assert(sizeof(undirected_vertex<>) == sizeof(edge_list), "");
+
 
 // Edges
 
@@ -39,6 +62,8 @@ struct undirected_vertex
 template<typename T = empty>
 struct undirected_edge
 {
+  using label_type = T;
+
   // TODO: Value-initialize the data element or not? We currently do not.
   undirected_edge(vertex_t u, vertex_t v)
     : ends_{u, v}
@@ -55,6 +80,28 @@ struct undirected_edge
   T data;
 };
 
+// An unlabeled edge stores only its endpoints.
+template<>
+struct undirected_edge<empty>
+{
+  using label_type = empty;
+
+  undirected_edge(vertex_t u, vertex_t v)
+    : ends_{u, v}
+  { }
+
+  undirected_edge(vertex_t u, vertex_t v, empty const&)
+    : ends_{u, v}
+  { }
+
+  vertex_t first() const { return ends_[0]; }
+  vertex_t second() const { return ends_[1]; }
+
+  vertex_t ends_[2];
+};
+
+static_assert(sizeof(undirected_edge<>) == 2 * sizeof(vertex_t), "");
+
 
 // Graph
 
@@ -97,7 +144,7 @@ struct graph
   edge_iterator end_edges() const;
 
   // Incidence
-  edge_list edges(vertex_t v) const;
+  edge_list const& edges(vertex_t v) const;
   std::size_t degree(vertex_t v) const;
 
   edge_iterator find_edge(vertex_t, vertex_t) const;
@@ -202,7 +249,7 @@ graph<V, E>::end_edges() const -> edge_iterator
 
 // Returns the list of edges incident to v.
 template<typename V, typename E>
-edge_list 
+edge_list const&
 graph<V, E>::edges(vertex_t v) const 
 { 
   return verts_[v].edges(); 
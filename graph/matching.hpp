@@ -0,0 +1,536 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_MATCHING_HPP
+#define GRAPH_MATCHING_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+
+namespace origin {
+
+// Matching
+//
+// A matching of an undirected graph is a set of edges without common ends.
+// It is represented by the mate of each vertex, which is unmatched for
+// vertices not covered by the matching.
+
+constexpr vertex_t unmatched = std::numeric_limits<vertex_t>::max();
+
+// Returns the number of edges in the matching given by mates.
+inline std::size_t
+matching_size(std::vector<vertex_t> const& mates)
+{
+  std::size_t n = 0;
+  for (vertex_t m : mates)
+    n += m != unmatched;
+  return n / 2;
+}
+
+
+// Computes a maximal matching with the Karp-Sipser heuristic, extending
+// the matching in mates, which is resized to the number of vertices. A
+// vertex with exactly one unmatched neighbor is always matched to it,
+// since some maximum matching does so. When there is no such vertex, an
+// arbitrary unmatched vertex is matched to its first unmatched neighbor.
+// This runs in O(V + E) time and usually leaves few vertices for an exact
+// algorithm to match.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+void
+karp_sipser(G const& g, std::vector<vertex_t>& mates)
+{
+  std::size_t n = g.num_vertices();
+  mates.resize(n, unmatched);
+
+  // The number of unmatched neighbors of each unmatched vertex.
+  std::vector<std::size_t> degrees(n, 0);
+  std::vector<vertex_t> ones;
+  for (vertex_t v = 0; v < n; ++v) {
+    if (mates[v] != unmatched)
+      continue;
+    for (edge_t e : g.edges(v)) {
+      vertex_t u = g.opposite(e, v);
+      degrees[v] += u != v && mates[u] == unmatched;
+    }
+    if (degrees[v] == 1)
+      ones.push_back(v);
+  }
+
+  auto match = [&](vertex_t u, vertex_t v) {
+    mates[u] = v;
+    mates[v] = u;
+    for (vertex_t x : {u, v}) {
+      for (edge_t e : g.edges(x)) {
+        vertex_t w = g.opposite(e, x);
+        if (mates[w] == unmatched && --degrees[w] == 1)
+          ones.push_back(w);
+      }
+    }
+  };
+  auto first_free = [&](vertex_t v) {
+    for (edge_t e : g.edges(v)) {
+      vertex_t u = g.opposite(e, v);
+      if (u != v && mates[u] == unmatched)
+        return u;
+    }
+    return unmatched;
+  };
+
+  vertex_t next = 0;
+  while (true) {
+    while (!ones.empty()) {
+      vertex_t v = ones.back();
+      ones.pop_back();
+      if (mates[v] != unmatched || degrees[v] != 1)
+        continue;
+      match(v, first_free(v));
+    }
+    while (next < n && (mates[next] != unmatched || degrees[next] == 0))
+      ++next;
+    if (next == n)
+      break;
+    match(next, first_free(next));
+  }
+}
+
+
+// Returns true if g is bipartite, and labels the vertices of each
+// connected component 0 and 1 alternately, starting with 0.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+bool
+bipartition(G const& g, std::vector<char>& sides)
+{
+  std::size_t n = g.num_vertices();
+  sides.assign(n, 2);
+  std::vector<vertex_t> queue;
+  for (vertex_t s = 0; s < n; ++s) {
+    if (sides[s] != 2)
+      continue;
+    sides[s] = 0;
+    queue.assign(1, s);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      vertex_t u = queue[i];
+      for (edge_t e : g.edges(u)) {
+        vertex_t v = g.opposite(e, u);
+        if (sides[v] == 2) {
+          sides[v] = !sides[u];
+          queue.push_back(v);
+        }
+        else if (sides[v] == sides[u]) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+
+// Computes a maximum matching of a bipartite graph by the Hopcroft-Karp
+// algorithm. The sides of the graph are given by a vertex label; left
+// vertices have side 0, and every edge joins a left and a right vertex.
+//
+// Each phase finds the length of the shortest augmenting paths by a
+// breadth-first search from the unmatched left vertices, and then augments
+// along a maximal set of disjoint shortest paths found by depth-first
+// searches of the layered graph. The searches are iterative and resume
+// from the last edge tried at each vertex, so a phase takes O(E) time.
+// There are O(sqrt(V)) phases.
+//
+// By default, the matching starts from the Karp-Sipser heuristic, which
+// usually leaves a few short phases.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+struct hopcroft_karp
+{
+  static constexpr std::size_t infinity =
+    std::numeric_limits<std::size_t>::max();
+
+  hopcroft_karp(G const& g, std::vector<char> const& sides)
+    : graph(g), sides(sides), warm_start(true), phases(0)
+  { }
+
+  std::size_t operator()();
+
+  bool layer();
+  bool augment(vertex_t s);
+
+  G const& graph;
+  std::vector<char> const& sides;
+  bool warm_start;
+
+  std::vector<vertex_t> mates;
+  std::vector<std::size_t> distances;  // Layers of left vertices
+  std::vector<std::size_t> current;    // The next edge to try
+  std::vector<vertex_t> stack;
+  std::size_t limit;                   // The layer of the free right ends
+  std::size_t phases;
+};
+
+// Returns the size of a maximum matching.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+std::size_t
+hopcroft_karp<G>::operator()()
+{
+  std::size_t n = graph.num_vertices();
+  mates.assign(n, unmatched);
+  if (warm_start)
+    karp_sipser(graph, mates);
+  phases = 0;
+  while (layer()) {
+    ++phases;
+    current.assign(n, 0);
+    for (vertex_t v = 0; v < n; ++v)
+      if (sides[v] == 0 && mates[v] == unmatched)
+        augment(v);
+  }
+  return matching_size(mates);
+}
+
+// Compute the layer of each left vertex reachable from an unmatched left
+// vertex by an alternating path. Returns true if an unmatched right vertex
+// is reachable.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+bool
+hopcroft_karp<G>::layer()
+{
+  std::size_t n = graph.num_vertices();
+  distances.assign(n, infinity);
+  stack.clear();
+  for (vertex_t v = 0; v < n; ++v) {
+    if (sides[v] == 0 && mates[v] == unmatched) {
+      distances[v] = 0;
+      stack.push_back(v);
+    }
+  }
+  limit = infinity;
+  for (std::size_t i = 0; i < stack.size(); ++i) {
+    vertex_t u = stack[i];
+    if (distances[u] >= limit)
+      break;
+    for (edge_t e : graph.edges(u)) {
+      vertex_t m = mates[graph.opposite(e, u)];
+      if (m == unmatched) {
+        limit = std::min(limit, distances[u] + 1);
+      }
+      else if (distances[m] == infinity) {
+        distances[m] = distances[u] + 1;
+        stack.push_back(m);
+      }
+    }
+  }
+  return limit != infinity;
+}
+
+// Search for a shortest augmenting path from the left vertex s, and flip
+// the matching along it. Left vertices that lead to no such path are
+// removed from the layers.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+bool
+hopcroft_karp<G>::augment(vertex_t s)
+{
+  stack.assign(1, s);
+  while (!stack.empty()) {
+    vertex_t u = stack.back();
+    auto const& edges = graph.edges(u);
+    if (current[u] == edges.size()) {
+      distances[u] = infinity;
+      stack.pop_back();
+      if (!stack.empty())
+        ++current[stack.back()];
+      continue;
+    }
+    vertex_t r = graph.opposite(edges[current[u]], u);
+    vertex_t m = mates[r];
+    if (m == unmatched && distances[u] + 1 == limit) {
+      // Flip the path. Each left vertex on the stack is matched to the
+      // right vertex of its current edge.
+      for (vertex_t x : stack) {
+        vertex_t y = graph.opposite(graph.edges(x)[current[x]], x);
+        mates[x] = y;
+        mates[y] = x;
+      }
+      return true;
+    }
+    if (m != unmatched && distances[m] == distances[u] + 1)
+      stack.push_back(m);
+    else
+      ++current[u];
+  }
+  return false;
+}
+
+
+// Computes a maximum matching of a general graph by Edmonds' blossom
+// algorithm. From each unmatched vertex, a breadth-first search grows an
+// alternating tree. When an edge closes an odd cycle (a blossom), the
+// vertices of the cycle are contracted into their base, and the search
+// continues. When the search reaches an unmatched vertex, the matching is
+// flipped along the path to the root.
+//
+// Each search takes time proportional to the size of its tree times the
+// number of blossoms it contracts, and O(V^3) overall in the worst case.
+// Only the vertices of the tree are reset between searches. When a search
+// fails, no later augmenting path passes through its tree, so the tree's
+// vertices are ignored by later searches. The matching
+// starts from the Karp-Sipser heuristic, so searches are only needed for
+// the few vertices it leaves unmatched.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+struct edmonds_matching
+{
+  edmonds_matching(G const& g)
+    : graph(g), warm_start(true), searches(0)
+  { }
+
+  std::size_t operator()();
+
+  vertex_t search(vertex_t root);
+  vertex_t common_base(vertex_t u, vertex_t v);
+  void mark_path(vertex_t v, vertex_t b, vertex_t child);
+
+  G const& graph;
+  bool warm_start;
+
+  std::vector<vertex_t> mates;
+  std::vector<vertex_t> parents;   // Tree parents of inner vertices
+  std::vector<vertex_t> bases;     // The base of each vertex's blossom
+  std::vector<char> used;          // Outer vertices of the tree
+  std::vector<char> blossom;
+  std::vector<char> seen;
+  std::vector<char> removed;       // Vertices of failed trees
+  std::vector<vertex_t> queue;
+  std::vector<vertex_t> tree;      // The vertices touched by a search
+  std::vector<vertex_t> path;
+  std::size_t searches;
+};
+
+// Returns the size of a maximum matching.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+std::size_t
+edmonds_matching<G>::operator()()
+{
+  std::size_t n = graph.num_vertices();
+  mates.assign(n, unmatched);
+  if (warm_start)
+    karp_sipser(graph, mates);
+  parents.assign(n, unmatched);
+  bases.resize(n);
+  for (vertex_t v = 0; v < n; ++v)
+    bases[v] = v;
+  used.assign(n, 0);
+  blossom.assign(n, 0);
+  seen.assign(n, 0);
+  removed.assign(n, 0);
+  tree.clear();
+  searches = 0;
+  for (vertex_t r = 0; r < n; ++r) {
+    if (mates[r] != unmatched || graph.degree(r) == 0)
+      continue;
+    ++searches;
+    vertex_t v = search(r);
+    if (v == unmatched) {
+      for (vertex_t x : tree)
+        removed[x] = 1;
+    }
+    while (v != unmatched) {
+      vertex_t p = parents[v];
+      vertex_t next = mates[p];
+      mates[v] = p;
+      mates[p] = v;
+      v = next;
+    }
+  }
+  return matching_size(mates);
+}
+
+// Returns the base of the smallest blossom containing u and v, which are
+// outer vertices of the same tree.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+vertex_t
+edmonds_matching<G>::common_base(vertex_t u, vertex_t v)
+{
+  path.clear();
+  while (true) {
+    u = bases[u];
+    seen[u] = 1;
+    path.push_back(u);
+    if (mates[u] == unmatched)
+      break;
+    u = parents[mates[u]];
+  }
+  while (true) {
+    v = bases[v];
+    if (seen[v])
+      break;
+    v = parents[mates[v]];
+  }
+  for (vertex_t x : path)
+    seen[x] = 0;
+  return v;
+}
+
+// Mark the blossoms on the path from v to the base b, and point the tree
+// parents along it toward the closing edge.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+void
+edmonds_matching<G>::mark_path(vertex_t v, vertex_t b, vertex_t child)
+{
+  while (bases[v] != b) {
+    blossom[bases[v]] = blossom[bases[mates[v]]] = 1;
+    parents[v] = child;
+    child = mates[v];
+    v = parents[mates[v]];
+  }
+}
+
+// Grow an alternating tree from root. Returns the unmatched vertex that
+// ends an augmenting path, or unmatched if there is none.
+template<typename G>
+  requires vertex_list_graph<G> && undirected_incidence_graph<G>
+vertex_t
+edmonds_matching<G>::search(vertex_t root)
+{
+  // Reset the tree of the previous search.
+  for (vertex_t x : tree) {
+    used[x] = 0;
+    parents[x] = unmatched;
+    bases[x] = x;
+  }
+  tree.assign(1, root);
+
+  used[root] = 1;
+  queue.assign(1, root);
+  for (std::size_t i = 0; i < queue.size(); ++i) {
+    vertex_t v = queue[i];
+    for (edge_t e : graph.edges(v)) {
+      vertex_t to = graph.opposite(e, v);
+      if (bases[v] == bases[to] || mates[v] == to || removed[to])
+        continue;
+      if (to == root ||
+          (mates[to] != unmatched && parents[mates[to]] != unmatched)) {
+        // The edge closes a blossom. Contract it.
+        // Every vertex of the blossom is in the tree.
+        vertex_t b = common_base(v, to);
+        mark_path(v, b, to);
+        mark_path(to, b, v);
+        for (vertex_t x : tree) {
+          if (blossom[bases[x]]) {
+            bases[x] = b;
+            if (!used[x]) {
+              used[x] = 1;
+              queue.push_back(x);
+            }
+          }
+        }
+        for (vertex_t x : tree)
+          blossom[x] = 0;
+      }
+      else if (parents[to] == unmatched) {
+        parents[to] = v;
+        tree.push_back(to);
+        if (mates[to] == unmatched)
+          return to;
+        used[mates[to]] = 1;
+        tree.push_back(mates[to]);
+        queue.push_back(mates[to]);
+      }
+    }
+  }
+  return unmatched;
+}
+
+
+// Solves the assignment problem for a dense rows x cols matrix of costs,
+// stored by rows, where rows <= cols. Returns the column assigned to each
+// row such that the total cost is minimal and no column is used twice.
+//
+// This is the Hungarian algorithm with row and column potentials. Rows
+// are added one at a time, each by a Dijkstra-like search for a shortest
+// augmenting path of reduced costs, in O(rows^2 cols) time overall. To
+// find a maximum weight matching, negate the weights. T must be a signed
+// integer or floating point type.
+template<typename T>
+std::vector<std::size_t>
+hungarian_assignment(std::vector<T> const& cost, std::size_t rows,
+                     std::size_t cols)
+{
+  assert(rows <= cols && cost.size() == rows * cols);
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  T const inf = std::numeric_limits<T>::max();
+
+  // Columns are numbered from 1; column 0 holds the row being added.
+  std::vector<T> u(rows + 1, 0);       // Row potentials
+  std::vector<T> v(cols + 1, 0);       // Column potentials
+  std::vector<std::size_t> p(cols + 1, none); // The row of each column
+  std::vector<std::size_t> way(cols + 1, 0);
+  std::vector<T> slack(cols + 1);
+  std::vector<char> done(cols + 1);
+  for (std::size_t i = 0; i < rows; ++i) {
+    p[0] = i;
+    std::size_t j0 = 0;
+    std::fill(slack.begin(), slack.end(), inf);
+    std::fill(done.begin(), done.end(), 0);
+    do {
+      done[j0] = 1;
+      std::size_t i0 = p[j0];
+      std::size_t j1 = 0;
+      T delta = inf;
+      for (std::size_t j = 1; j <= cols; ++j) {
+        if (done[j])
+          continue;
+        T c = cost[i0 * cols + j - 1] - u[i0 + 1] - v[j];
+        if (c < slack[j]) {
+          slack[j] = c;
+          way[j] = j0;
+        }
+        if (slack[j] < delta) {
+          delta = slack[j];
+          j1 = j;
+        }
+      }
+      for (std::size_t j = 0; j <= cols; ++j) {
+        if (done[j]) {
+          u[p[j] + 1] += delta;
+          v[j] -= delta;
+        }
+        else {
+          slack[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != none);
+
+    // Flip the augmenting path.
+    do {
+      std::size_t j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0 != 0);
+  }
+
+  std::vector<std::size_t> result(rows);
+  for (std::size_t j = 1; j <= cols; ++j)
+    if (p[j] != none)
+      result[p[j]] = j - 1;
+  return result;
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,169 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../matching.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Check that mates is a matching of g.
+template<typename G>
+void
+check(G const& g, std::vector<vertex_t> const& mates)
+{
+  assert(mates.size() == g.num_vertices());
+  for (vertex_t v : g.vertices()) {
+    vertex_t m = mates[v];
+    if (m == unmatched)
+      continue;
+    assert(m != v && mates[m] == v && g.has_edge(v, m));
+  }
+}
+
+// Returns the size of a maximum matching by trying every subset of edges.
+template<typename G>
+std::size_t
+brute_force(G const& g)
+{
+  std::size_t m = g.num_edges();
+  std::size_t best = 0;
+  for (std::size_t set = 0; set < (std::size_t(1) << m); ++set) {
+    std::vector<char> used(g.num_vertices(), 0);
+    std::size_t k = 0;
+    bool ok = true;
+    for (edge_t e = 0; e < m && ok; ++e) {
+      if (!(set >> e & 1))
+        continue;
+      vertex_t u = g.first(e), v = g.second(e);
+      ok = u != v && !used[u] && !used[v];
+      used[u] = used[v] = 1;
+      ++k;
+    }
+    if (ok)
+      best = std::max(best, k);
+  }
+  return best;
+}
+
+int
+main()
+{
+  using G = graph<>;
+
+  // A path of 4 vertices is bipartite with a perfect matching, which the
+  // heuristic finds by matching the degree-one ends first.
+  {
+    G g;
+    for (int i = 0; i < 4; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 3);
+    std::vector<vertex_t> mates;
+    karp_sipser(g, mates);
+    check(g, mates);
+    assert(matching_size(mates) == 2);
+
+    std::vector<char> sides;
+    assert(bipartition(g, sides));
+    assert((sides == std::vector<char>{0, 1, 0, 1}));
+    hopcroft_karp<G> hk(g, sides);
+    hk.warm_start = false;
+    assert(hk() == 2);
+    check(g, hk.mates);
+  }
+
+  // A triangle with a pendant vertex on each corner needs a blossom.
+  {
+    G g;
+    for (int i = 0; i < 6; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(2, 0);
+    g.add_edge(0, 3);
+    g.add_edge(1, 4);
+    g.add_edge(2, 5);
+    std::vector<char> sides;
+    assert(!bipartition(g, sides));
+    edmonds_matching<G> em(g);
+    em.warm_start = false;
+    assert(em() == 3);
+    check(g, em.mates);
+  }
+
+  // Random graphs: general matchings agree with brute force, and bipartite
+  // matchings with the general algorithm.
+  std::minstd_rand gen(19);
+  for (int trial = 0; trial < 200; ++trial) {
+    std::size_t n = 2 + gen() % 10;
+    G g;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (int i = 0; i < 12; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (u != v && !g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    edmonds_matching<G> em(g);
+    em.warm_start = trial % 2;
+    std::size_t k = em();
+    check(g, em.mates);
+    assert(k == brute_force(g));
+  }
+  for (int trial = 0; trial < 100; ++trial) {
+    std::size_t l = 1 + gen() % 30, r = 1 + gen() % 30;
+    G g;
+    for (std::size_t i = 0; i < l + r; ++i)
+      g.add_vertex();
+    std::vector<char> sides(l + r, 1);
+    std::fill(sides.begin(), sides.begin() + l, 0);
+    std::uniform_int_distribution<vertex_t> left(0, l - 1), right(l, l + r - 1);
+    for (std::size_t i = 0; i < 2 * (l + r); ++i) {
+      vertex_t u = left(gen), v = right(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    hopcroft_karp<G> hk(g, sides);
+    hk.warm_start = trial % 2;
+    std::size_t k = hk();
+    check(g, hk.mates);
+    edmonds_matching<G> em(g);
+    assert(k == em());
+  }
+
+  // Assignments agree with trying every permutation.
+  for (int trial = 0; trial < 50; ++trial) {
+    std::size_t rows = 1 + gen() % 5, cols = rows + gen() % 3;
+    std::vector<long> cost(rows * cols);
+    for (long& c : cost)
+      c = long(gen() % 100) - 20;
+    std::vector<std::size_t> a = hungarian_assignment(cost, rows, cols);
+    long total = 0;
+    std::vector<char> used(cols, 0);
+    for (std::size_t i = 0; i < rows; ++i) {
+      assert(!used[a[i]]);
+      used[a[i]] = 1;
+      total += cost[i * cols + a[i]];
+    }
+    std::vector<std::size_t> perm(cols);
+    std::iota(perm.begin(), perm.end(), 0);
+    long best = total;
+    do {
+      long t = 0;
+      for (std::size_t i = 0; i < rows; ++i)
+        t += cost[i * cols + perm[i]];
+      best = std::min(best, t);
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    assert(total == best);
+  }
+}
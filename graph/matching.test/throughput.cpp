@@ -0,0 +1,87 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../matching.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Measures matching throughput on a random bipartite graph whose left
+// vertices have d random neighbors, with and without the Karp-Sipser warm
+// start; on a random general graph; and for dense assignment problems.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  using G = graph<>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::size_t d = argc > 2 ? std::atoi(argv[2]) : 4;
+  std::size_t k = argc > 3 ? std::atoi(argv[3]) : 300;
+
+  G g;
+  for (std::size_t i = 0; i < 2 * n; ++i)
+    g.add_vertex();
+  std::vector<char> sides(2 * n, 1);
+  std::fill(sides.begin(), sides.begin() + n, 0);
+  std::minstd_rand gen(37);
+  std::uniform_int_distribution<vertex_t> right(n, 2 * n - 1);
+  for (vertex_t u = 0; u < n; ++u)
+    for (std::size_t i = 0; i < d; ++i) {
+      vertex_t v = right(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+  std::cout << "bipartite: " << n << " + " << n << " vertices, "
+            << g.num_edges() << " edges\n";
+
+  auto rate = [&](ms t) { return g.num_edges() / (1e3 * t.count()); };
+
+  auto start = clock::now();
+  std::vector<vertex_t> mates;
+  karp_sipser(g, mates);
+  ms t0 = clock::now() - start;
+  std::cout << "karp-sipser: " << t0.count() << " ms, "
+            << matching_size(mates) << " matched, " << rate(t0)
+            << " Medges/s\n";
+
+  for (bool warm : {false, true}) {
+    hopcroft_karp<G> hk(g, sides);
+    hk.warm_start = warm;
+    start = clock::now();
+    std::size_t size = hk();
+    ms t = clock::now() - start;
+    std::cout << "hopcroft-karp" << (warm ? " (warm)" : "") << ": "
+              << t.count() << " ms, " << size << " matched, " << hk.phases
+              << " phases, " << rate(t) << " Medges/s\n";
+  }
+
+  start = clock::now();
+  edmonds_matching<G> em(g);
+  std::size_t size = em();
+  ms t1 = clock::now() - start;
+  std::cout << "edmonds (warm): " << t1.count() << " ms, " << size
+            << " matched, " << em.searches << " searches\n";
+
+  // Dense assignment.
+  std::vector<long> cost(k * k);
+  for (long& c : cost)
+    c = gen() % 1000000;
+  start = clock::now();
+  auto a = hungarian_assignment(cost, k, k);
+  ms t2 = clock::now() - start;
+  long total = 0;
+  for (std::size_t i = 0; i < k; ++i)
+    total += cost[i * k + a[i]];
+  std::cout << "hungarian " << k << "x" << k << ": " << t2.count()
+            << " ms, cost " << total << '\n';
+}
@@ -0,0 +1,439 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_MSBFS_HPP
+#define GRAPH_MSBFS_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+
+namespace origin {
+
+// Multi-source shortest paths
+//
+// The algorithms below compute the distances from many sources, such as
+// landmarks, to every vertex. Sources are processed in batches that share
+// one traversal of the graph, so the edges of a vertex are scanned once
+// per batch rather than once per source. Batches are independent and run
+// in parallel, each thread with its own working state. Directed graphs
+// follow outgoing edges.
+
+
+// The distances from a number of sources to each vertex. Distances are
+// stored by vertex, so the distances from all sources to a vertex are
+// contiguous, as needed to estimate distances through landmarks.
+template<typename T>
+struct distance_matrix
+{
+  static constexpr T unreachable = std::numeric_limits<T>::has_infinity
+                                 ? std::numeric_limits<T>::infinity()
+                                 : std::numeric_limits<T>::max();
+
+  distance_matrix(std::size_t vertices, std::size_t sources)
+    : num_vertices(vertices),
+      num_sources(sources),
+      values(vertices * sources, unreachable)
+  { }
+
+  // Returns the distance from source i to v.
+  T operator()(vertex_t v, std::size_t i) const
+  {
+    return values[v * num_sources + i];
+  }
+
+  T& operator()(vertex_t v, std::size_t i)
+  {
+    return values[v * num_sources + i];
+  }
+
+  // Returns the distances from each source to v.
+  T const* row(vertex_t v) const { return values.data() + v * num_sources; }
+
+  std::size_t num_vertices;
+  std::size_t num_sources;
+  std::vector<T> values;
+};
+
+
+namespace msbfs_impl {
+
+// Operations on bitsets of L 64-bit words. AVX2 (4 words) or SSE2 (2 words)
+// is used when the compiler targets it, and the remainder is scalar.
+
+// Returns true if a has a bit set.
+template<std::size_t L>
+inline bool
+any(std::uint64_t const* a)
+{
+  std::uint64_t x = 0;
+  for (std::size_t i = 0; i < L; ++i)
+    x |= a[i];
+  return x != 0;
+}
+
+// Set a to a | b.
+template<std::size_t L>
+inline void
+or_into(std::uint64_t* a, std::uint64_t const* b)
+{
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 4 <= L; i += 4) {
+    __m256i x = _mm256_loadu_si256((__m256i const*)(a + i));
+    __m256i y = _mm256_loadu_si256((__m256i const*)(b + i));
+    _mm256_storeu_si256((__m256i*)(a + i), _mm256_or_si256(x, y));
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 2 <= L; i += 2) {
+    __m128i x = _mm_loadu_si128((__m128i const*)(a + i));
+    __m128i y = _mm_loadu_si128((__m128i const*)(b + i));
+    _mm_storeu_si128((__m128i*)(a + i), _mm_or_si128(x, y));
+  }
+#endif
+  for (; i < L; ++i)
+    a[i] |= b[i];
+}
+
+// Set out to a & ~b, and return true if it has a bit set.
+template<std::size_t L>
+inline bool
+and_not(std::uint64_t* out, std::uint64_t const* a, std::uint64_t const* b)
+{
+  std::size_t i = 0;
+  bool set = false;
+#if defined(__AVX2__)
+  for (; i + 4 <= L; i += 4) {
+    __m256i x = _mm256_loadu_si256((__m256i const*)(a + i));
+    __m256i y = _mm256_loadu_si256((__m256i const*)(b + i));
+    __m256i r = _mm256_andnot_si256(y, x);
+    _mm256_storeu_si256((__m256i*)(out + i), r);
+    set |= !_mm256_testz_si256(r, r);
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 2 <= L; i += 2) {
+    __m128i x = _mm_loadu_si128((__m128i const*)(a + i));
+    __m128i y = _mm_loadu_si128((__m128i const*)(b + i));
+    __m128i r = _mm_andnot_si128(y, x);
+    _mm_storeu_si128((__m128i*)(out + i), r);
+    __m128i z = _mm_cmpeq_epi8(r, _mm_setzero_si128());
+    set |= _mm_movemask_epi8(z) != 0xffff;
+  }
+#endif
+  for (; i < L; ++i) {
+    out[i] = a[i] & ~b[i];
+    set |= out[i] != 0;
+  }
+  return set;
+}
+
+// Set du[i] to the least of du[i] and dv[i] + w for each of B lanes.
+// Returns true if any lane decreased.
+template<std::size_t B>
+inline bool
+relax(double* du, double const* dv, double w)
+{
+  std::size_t i = 0;
+  bool changed = false;
+#if defined(__AVX2__)
+  __m256d wv = _mm256_set1_pd(w);
+  for (; i + 4 <= B; i += 4) {
+    __m256d c = _mm256_add_pd(_mm256_loadu_pd(dv + i), wv);
+    __m256d old = _mm256_loadu_pd(du + i);
+    if (_mm256_movemask_pd(_mm256_cmp_pd(c, old, _CMP_LT_OQ))) {
+      _mm256_storeu_pd(du + i, _mm256_min_pd(c, old));
+      changed = true;
+    }
+  }
+#endif
+#if defined(__SSE2__)
+  __m128d wx = _mm_set1_pd(w);
+  for (; i + 2 <= B; i += 2) {
+    __m128d c = _mm_add_pd(_mm_loadu_pd(dv + i), wx);
+    __m128d old = _mm_loadu_pd(du + i);
+    if (_mm_movemask_pd(_mm_cmplt_pd(c, old))) {
+      _mm_storeu_pd(du + i, _mm_min_pd(c, old));
+      changed = true;
+    }
+  }
+#endif
+  for (; i < B; ++i) {
+    double c = dv[i] + w;
+    if (c < du[i]) {
+      du[i] = c;
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+// The working state of a breadth-first search from a batch of up to 64 * L
+// sources. Bit i of the sets of v refers to source i of the batch:
+//
+//    seen     Sources that have reached v.
+//    visit    Sources that reached v in the last level.
+//    next     Sources that reach v in the next level, including some that
+//             already have.
+//
+// Distances are stored as T.
+template<std::size_t L, typename T>
+struct bfs_batch
+{
+  explicit bfs_batch(std::size_t n)
+    : seen(n * L, 0), visit(n * L, 0), next(n * L, 0)
+  { }
+
+  template<typename G>
+  bool run(G const& g, std::vector<vertex_t> const& sources,
+           std::size_t first, std::size_t count, distance_matrix<T>& m);
+
+  std::vector<std::uint64_t> seen;
+  std::vector<std::uint64_t> visit;
+  std::vector<std::uint64_t> next;
+  std::vector<vertex_t> frontier;
+  std::vector<vertex_t> touched;
+  std::vector<vertex_t> reached;
+};
+
+// Search from sources [first, first + count) and store their distances
+// in m. Returns false, leaving the state dirty, if a distance is too large
+// to store as T.
+template<std::size_t L, typename T>
+template<typename G>
+bool
+bfs_batch<L, T>::run(G const& g, std::vector<vertex_t> const& sources,
+                     std::size_t first, std::size_t count,
+                     distance_matrix<T>& m)
+{
+  // Each level records the distance from every source whose bit is set.
+  auto record = [&](vertex_t v, std::uint64_t const* bits, T d) {
+    for (std::size_t w = 0; w < L; ++w) {
+      for (std::uint64_t b = bits[w]; b; b &= b - 1)
+        m(v, first + 64 * w + __builtin_ctzll(b)) = d;
+    }
+  };
+
+  frontier.clear();
+  for (std::size_t i = 0; i < count; ++i) {
+    vertex_t s = sources[first + i];
+    if (!any<L>(&visit[s * L])) {
+      frontier.push_back(s);
+      reached.push_back(s);
+    }
+    visit[s * L + i / 64] |= std::uint64_t(1) << (i % 64);
+    seen[s * L + i / 64] |= std::uint64_t(1) << (i % 64);
+  }
+  for (vertex_t s : frontier)
+    record(s, &visit[s * L], 0);
+
+  constexpr std::size_t limit = distance_matrix<T>::unreachable;
+  for (std::size_t level = 1; !frontier.empty(); ++level) {
+    // Push the sources visiting each vertex to its successors.
+    touched.clear();
+    for (vertex_t v : frontier) {
+      std::uint64_t const* bits = &visit[v * L];
+      for_each_successor(g, v, [&](vertex_t u, edge_t) {
+        if (!any<L>(&next[u * L]))
+          touched.push_back(u);
+        or_into<L>(&next[u * L], bits);
+      });
+    }
+    for (vertex_t v : frontier)
+      std::fill_n(&visit[v * L], L, 0);
+
+    // Keep the sources that have not reached each vertex before.
+    frontier.clear();
+    for (vertex_t u : touched) {
+      std::uint64_t* bits = &visit[u * L];
+      if (and_not<L>(bits, &next[u * L], &seen[u * L])) {
+        if (level >= limit)
+          return false;
+        if (!any<L>(&seen[u * L]))
+          reached.push_back(u);
+        or_into<L>(&seen[u * L], bits);
+        frontier.push_back(u);
+        record(u, bits, T(level));
+      }
+      std::fill_n(&next[u * L], L, 0);
+    }
+  }
+
+  for (vertex_t v : reached)
+    std::fill_n(&seen[v * L], L, 0);
+  reached.clear();
+  return true;
+}
+
+} // namespace msbfs_impl
+
+
+// Returns the number of edges on a shortest path from each source to each
+// vertex, computed by multi-source breadth-first search (MS-BFS). Each
+// batch of 64 * L sources shares one search, whose frontiers are bitsets
+// of sources. Each level ORs the bitset of each frontier vertex into its
+// successors, and keeps the sources that are new at each successor.
+//
+// Each thread uses 3 * L words per vertex, so L should be small enough
+// that batches are full. Distances are stored as T, an unsigned integer
+// type whose greatest value means unreachable. Throws overflow_error if a
+// distance is too large for T, such as a path of 65535 or more edges for
+// the default.
+template<std::size_t L = 4, typename T = std::uint16_t, typename G>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+distance_matrix<T>
+multi_source_bfs(G const& g, std::vector<vertex_t> const& sources)
+{
+  static_assert(std::is_unsigned<T>::value, "distances must be unsigned");
+  constexpr std::size_t width = 64 * L;
+  std::size_t n = g.num_vertices();
+  distance_matrix<T> m(n, sources.size());
+  std::size_t batches = (sources.size() + width - 1) / width;
+  std::atomic<bool> overflow(false);
+  parallel_for_dynamic(counted_range<std::size_t>(batches),
+                       [&](counted_range<std::size_t> r) {
+    msbfs_impl::bfs_batch<L, T> state(n);
+    for (std::size_t b : r) {
+      if (overflow.load(std::memory_order_relaxed))
+        return;
+      std::size_t first = b * width;
+      std::size_t count = std::min(width, sources.size() - first);
+      if (!state.run(g, sources, first, count, m)) {
+        overflow.store(true, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }, 1);
+  if (overflow)
+    throw std::overflow_error("multi_source_bfs: distance exceeds its type");
+  return m;
+}
+
+
+// Returns the length of a shortest path from each source to each vertex,
+// where edges are weighted by a label W. Weights may be negative, but
+// there must be no negative cycle reachable from a source.
+//
+// Each batch of B sources runs one label-correcting search, ordered as in
+// delta-stepping. Each vertex holds the B distances of the batch, and
+// relaxing an edge updates all of them with vector operations. A vertex
+// whose distances decrease is placed in the bucket of width delta that
+// holds its least distance, and buckets are scanned in order, so vertices
+// near some source are settled before those that depend on them. Since
+// the lanes of a vertex belong to different sources, a vertex may be
+// scanned more than once; negative weights only add rescans.
+//
+// If delta is not positive, it is the mean absolute edge weight. Only the
+// buckets that hold vertices are stored, in an ordered map.
+template<std::size_t B = 8, typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+distance_matrix<double>
+multi_source_shortest_paths(G const& g, std::vector<vertex_t> const& sources,
+                            W weight, double delta = 0)
+{
+  constexpr double inf = distance_matrix<double>::unreachable;
+  constexpr std::size_t npos = -1;
+  std::size_t n = g.num_vertices();
+  if (delta <= 0) {
+    double sum = 0;
+    std::size_t count = 0;
+    for (vertex_t v = 0; v < n; ++v) {
+      for_each_successor(g, v, [&](vertex_t, edge_t e) {
+        sum += std::abs(double(weight(e)));
+        ++count;
+      });
+    }
+    delta = count && sum > 0 ? sum / count : 1;
+  }
+  distance_matrix<double> m(n, sources.size());
+  std::size_t batches = (sources.size() + B - 1) / B;
+  parallel_for_dynamic(counted_range<std::size_t>(batches),
+                       [&](counted_range<std::size_t> r) {
+    std::vector<double> dist(n * B, inf);
+    std::vector<std::size_t> slot(n, npos);
+    std::vector<char> touched(n, 0);
+    std::vector<vertex_t> bucket;
+    std::map<std::size_t, std::vector<vertex_t>> later;
+    std::vector<vertex_t> reached;
+    for (std::size_t b : r) {
+      std::size_t first = b * B;
+      std::size_t count = std::min(B, sources.size() - first);
+      std::size_t current = 0;
+      auto enqueue = [&](vertex_t v) {
+        double const* dv = &dist[v * B];
+        double key = *std::min_element(dv, dv + B) / delta;
+        std::size_t k = current;
+        if (key > double(current))
+          k = std::size_t(std::min(key, 1e18));
+        if (k < slot[v]) {
+          slot[v] = k;
+          if (k == current)
+            bucket.push_back(v);
+          else
+            later[k].push_back(v);
+        }
+        if (!touched[v]) {
+          touched[v] = 1;
+          reached.push_back(v);
+        }
+      };
+      for (std::size_t i = 0; i < count; ++i)
+        dist[sources[first + i] * B + i] = 0;
+      for (std::size_t i = 0; i < count; ++i)
+        enqueue(sources[first + i]);
+
+      while (true) {
+        for (std::size_t j = 0; j < bucket.size(); ++j) {
+          vertex_t v = bucket[j];
+          if (slot[v] != current)
+            continue;
+          slot[v] = npos;
+          double const* dv = &dist[v * B];
+          for_each_successor(g, v, [&](vertex_t u, edge_t e) {
+            if (msbfs_impl::relax<B>(&dist[u * B], dv, weight(e)))
+              enqueue(u);
+          });
+        }
+        bucket.clear();
+        if (later.empty())
+          break;
+        current = later.begin()->first;
+        bucket.swap(later.begin()->second);
+        later.erase(later.begin());
+      }
+
+      for (vertex_t v : reached) {
+        for (std::size_t i = 0; i < count; ++i)
+          m(v, first + i) = dist[v * B + i];
+        std::fill_n(&dist[v * B], B, inf);
+        touched[v] = 0;
+      }
+      reached.clear();
+    }
+  }, 1);
+  return m;
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,182 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../msbfs.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns the hop distances from s by a plain breadth-first search.
+template<typename G>
+std::vector<std::uint16_t>
+hops(G const& g, vertex_t s)
+{
+  constexpr std::uint16_t none = distance_matrix<std::uint16_t>::unreachable;
+  std::vector<std::uint16_t> d(g.num_vertices(), none);
+  std::deque<vertex_t> q{s};
+  d[s] = 0;
+  while (!q.empty()) {
+    vertex_t v = q.front();
+    q.pop_front();
+    for_each_successor(g, v, [&](vertex_t u, edge_t) {
+      if (d[u] == none) {
+        d[u] = d[v] + 1;
+        q.push_back(u);
+      }
+    });
+  }
+  return d;
+}
+
+// Returns the weighted distances from s by Dijkstra's algorithm.
+template<typename G>
+std::vector<double>
+lengths(G const& g, vertex_t s, std::vector<double> const& w)
+{
+  using entry = std::pair<double, vertex_t>;
+  std::vector<double> d(g.num_vertices(), INFINITY);
+  std::priority_queue<entry, std::vector<entry>, std::greater<entry>> q;
+  d[s] = 0;
+  q.emplace(0, s);
+  while (!q.empty()) {
+    entry x = q.top();
+    q.pop();
+    if (x.first > d[x.second])
+      continue;
+    for_each_successor(g, x.second, [&](vertex_t u, edge_t e) {
+      if (x.first + w[e] < d[u]) {
+        d[u] = x.first + w[e];
+        q.emplace(d[u], u);
+      }
+    });
+  }
+  return d;
+}
+
+// Check both searches against one search per source.
+template<std::size_t L, typename G>
+void
+check(G const& g, std::vector<vertex_t> const& sources,
+      std::vector<double>& w)
+{
+  distance_matrix<std::uint16_t> h = multi_source_bfs<L>(g, sources);
+  distance_matrix<double> d =
+    multi_source_shortest_paths(g, sources, edge_label(w));
+  assert(h.num_vertices == g.num_vertices());
+  assert(h.num_sources == sources.size());
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    std::vector<std::uint16_t> h1 = hops(g, sources[i]);
+    std::vector<double> d1 = lengths(g, sources[i], w);
+    for (vertex_t v = 0; v < g.num_vertices(); ++v) {
+      assert(h(v, i) == h1[v]);
+      assert(h.row(v)[i] == h1[v]);
+      assert(std::abs(d(v, i) - d1[v]) < 1e-9 || d(v, i) == d1[v]);
+    }
+  }
+}
+
+
+int
+main()
+{
+  // A directed path reaches only later vertices.
+  {
+    digraph<> g;
+    for (int i = 0; i < 5; ++i)
+      g.add_vertex();
+    for (vertex_t v = 0; v < 4; ++v)
+      g.add_edge(v, v + 1);
+    distance_matrix<std::uint16_t> h = multi_source_bfs(g, {0, 2});
+    assert(h(4, 0) == 4);
+    assert(h(4, 1) == 2);
+    assert(h(1, 1) == distance_matrix<std::uint16_t>::unreachable);
+    distance_matrix<double> d =
+      multi_source_shortest_paths(g, {2}, unit_weight(), 0.5);
+    assert(d(3, 0) == 1);
+    assert(std::isinf(d(0, 0)));
+  }
+
+  // Distances too large for their type are reported.
+  {
+    digraph<> g;
+    for (int i = 0; i < 300; ++i)
+      g.add_vertex();
+    for (vertex_t v = 0; v + 1 < 300; ++v)
+      g.add_edge(v, v + 1);
+    distance_matrix<std::uint16_t> h = multi_source_bfs(g, {0});
+    assert(h(299, 0) == 299);
+    distance_matrix<std::uint8_t> near = multi_source_bfs<1, std::uint8_t>(
+      g, {45});
+    assert(near(299, 0) == 254);
+    bool thrown = false;
+    try {
+      multi_source_bfs<1, std::uint8_t>(g, {0, 45});
+    }
+    catch (std::overflow_error const&) {
+      thrown = true;
+    }
+    assert(thrown);
+  }
+
+  // Random directed and undirected graphs, with batches that are partly
+  // filled, several batches, and repeated sources.
+  std::minstd_rand gen(23);
+  for (int trial = 0; trial < 3; ++trial) {
+    std::size_t n = 300;
+    digraph<> dg;
+    graph<> ug;
+    for (std::size_t i = 0; i < n; ++i) {
+      dg.add_vertex();
+      ug.add_vertex();
+    }
+    for (std::size_t i = 0; i < 2 * n; ++i) {
+      vertex_t u = gen() % n, v = gen() % n;
+      if (!dg.has_edge(u, v))
+        dg.add_edge(u, v);
+      if (u != v && !ug.has_edge(u, v))
+        ug.add_edge(u, v);
+    }
+    std::vector<double> dw(dg.num_edges()), uw(ug.num_edges());
+    for (double& x : dw)
+      x = gen() % 10;
+    for (double& x : uw)
+      x = 1 + gen() % 10;
+
+    for (std::size_t k : {1, 70, 300}) {
+      std::vector<vertex_t> sources(k);
+      for (vertex_t& s : sources)
+        s = gen() % n;
+      check<1>(dg, sources, dw);
+      check<4>(dg, sources, dw);
+      check<1>(ug, sources, uw);
+      check<2>(ug, sources, uw);
+    }
+  }
+
+  // Negative weights without negative cycles: a layered DAG.
+  {
+    digraph<> g;
+    for (int i = 0; i < 40; ++i)
+      g.add_vertex();
+    std::vector<double> w;
+    for (vertex_t v = 0; v < 36; ++v) {
+      for (vertex_t u = v + 1; u < v + 5; ++u) {
+        g.add_edge(v, u);
+        w.push_back(int(gen() % 11) - 5);
+      }
+    }
+    std::vector<vertex_t> sources{0, 3, 3, 17, 39};
+    check<1>(g, sources, w);
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../msbfs.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Measures the time to compute hop and weighted distances from a number of
+// landmarks to every vertex of a graph grown by preferential attachment,
+// with one breadth-first search per landmark as a baseline.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using sec = std::chrono::duration<double>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::size_t k = argc > 2 ? std::atoi(argv[2]) : 256;
+  std::size_t d = 8;
+
+  graph<> g;
+  std::vector<vertex_t> ends;
+  std::minstd_rand gen(37);
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = g.add_vertex();
+    for (std::size_t j = 0; j < d && !ends.empty(); ++j) {
+      vertex_t u = ends[gen() % ends.size()];
+      if (u != v && !g.has_edge(u, v)) {
+        g.add_edge(u, v);
+        ends.push_back(u);
+        ends.push_back(v);
+      }
+    }
+    ends.push_back(v);
+  }
+  std::vector<double> weights(g.num_edges());
+  for (double& w : weights)
+    w = 1 + gen() % 100;
+  std::vector<vertex_t> landmarks(k);
+  for (vertex_t& s : landmarks)
+    s = gen() % n;
+  std::cout << n << " vertices, " << g.num_edges() << " edges, " << k
+            << " landmarks\n";
+
+  // One search per landmark.
+  auto start = clock::now();
+  std::size_t total = 0;
+  std::vector<std::uint16_t> dist(n);
+  std::deque<vertex_t> q;
+  for (vertex_t s : landmarks) {
+    std::fill(dist.begin(), dist.end(), 0xffff);
+    dist[s] = 0;
+    q.push_back(s);
+    while (!q.empty()) {
+      vertex_t v = q.front();
+      q.pop_front();
+      for (edge_t e : g.edges(v)) {
+        vertex_t u = g.opposite(e, v);
+        if (dist[u] == 0xffff) {
+          dist[u] = dist[v] + 1;
+          total += dist[u];
+          q.push_back(u);
+        }
+      }
+    }
+  }
+  double t = sec(clock::now() - start).count();
+  std::cout << "bfs per landmark  " << t << " s (" << total << ")\n";
+
+  auto report = [&](char const* name, auto const& m, double t) {
+    double sum = 0;
+    for (auto x : m.values)
+      sum += x;
+    std::cout << name << t << " s (" << sum << ")\n";
+  };
+
+  start = clock::now();
+  auto h1 = multi_source_bfs<1>(g, landmarks);
+  report("ms-bfs, 64 wide   ", h1, sec(clock::now() - start).count());
+
+  start = clock::now();
+  auto h4 = multi_source_bfs<4>(g, landmarks);
+  report("ms-bfs, 256 wide  ", h4, sec(clock::now() - start).count());
+
+  start = clock::now();
+  auto w = multi_source_shortest_paths(g, landmarks, edge_label(weights));
+  report("delta-stepping, 8 ", w, sec(clock::now() - start).count());
+}
@@ -0,0 +1,195 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_MST_HPP
+#define GRAPH_MST_HPP
+
+#include "common.hpp"
+#include "disjoint_set.hpp"
+#include "parallel.hpp"
+#include "queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+
+namespace origin {
+
+// Minimum spanning forests.
+//
+// Each algorithm takes an undirected graph and a label W that weights its
+// edges, and returns the edges of a minimum spanning forest. Ties between
+// equal weights are broken by edge id, so every algorithm selects the same
+// set of edges (but not necessarily in the same order).
+
+
+// A strict weak order on edges by weight, then by id.
+template<typename W>
+struct edge_weight_order
+{
+  edge_weight_order(W weight)
+    : weight(weight)
+  { }
+
+  bool operator()(edge_t a, edge_t b) const
+  {
+    auto wa = weight(a);
+    auto wb = weight(b);
+    return wa < wb || (!(wb < wa) && a < b);
+  }
+
+  W weight;
+};
+
+
+// Kruskal's algorithm. Edges are sorted in parallel, and then added in
+// order unless they join vertices that are already connected.
+template<typename G, typename W>
+std::vector<edge_t>
+kruskal_mst(G const& g, W weight)
+{
+  std::vector<edge_t> edges(g.num_edges());
+  for (edge_t e : g.edges())
+    edges[e] = e;
+  parallel_sort(edges.begin(), edges.end(), edge_weight_order<W>(weight));
+
+  disjoint_sets sets(g.num_vertices());
+  std::vector<edge_t> tree;
+  for (edge_t e : edges) {
+    if (sets.num_sets() == 1)
+      break;
+    if (sets.join(g.first(e), g.second(e)))
+      tree.push_back(e);
+  }
+  return tree;
+}
+
+
+// Prim's algorithm. A tree is grown from each vertex not yet spanned, using
+// an indexed heap of vertices keyed by the weight of their lightest edge
+// to the tree.
+template<typename G, typename W>
+std::vector<edge_t>
+prim_mst(G const& g, W weight)
+{
+  std::size_t n = g.num_vertices();
+  edge_weight_order<W> less(weight);
+  std::vector<edge_t> best(n);    // The lightest edge to the tree
+  std::vector<char> state(n, 0);  // 0 = unseen, 1 = queued, 2 = spanned
+
+  // Order vertices by their lightest edge.
+  auto key = [&best](vertex_t v) -> edge_t& { return best[v]; };
+  auto comp = [&less](edge_t a, edge_t b) { return less(a, b); };
+  mutable_binary_heap<vertex_t, decltype(key), decltype(comp)>
+    queue(n, key, comp);
+
+  std::vector<edge_t> tree;
+  for (vertex_t r : g.vertices()) {
+    if (state[r])
+      continue;
+    state[r] = 2;
+    vertex_t u = r;
+    while (true) {
+      for (edge_t e : g.edges(u)) {
+        vertex_t v = g.opposite(e, u);
+        if (state[v] == 0) {
+          state[v] = 1;
+          best[v] = e;
+          queue.push(v);
+        }
+        else if (state[v] == 1 && less(e, best[v])) {
+          queue.update(v, e);
+        }
+      }
+      if (queue.is_empty())
+        break;
+      u = queue.top();
+      queue.pop();
+      state[u] = 2;
+      tree.push_back(best[u]);
+    }
+  }
+  return tree;
+}
+
+
+// Borůvka's algorithm. In each round, every component selects its lightest
+// incident edge, and the selected edges are added to the forest. Selection
+// is done in parallel over the remaining edges; each component's choice is
+// updated by compare-and-swap. Edges within a component are discarded
+// after each round, and the number of components at least halves.
+template<typename G, typename W>
+std::vector<edge_t>
+boruvka_mst(G const& g, W weight)
+{
+  constexpr edge_t none = std::numeric_limits<edge_t>::max();
+
+  std::size_t n = g.num_vertices();
+  edge_weight_order<W> less(weight);
+
+  std::vector<edge_t> edges;
+  edges.reserve(g.num_edges());
+  for (edge_t e : g.edges()) {
+    if (g.first(e) != g.second(e))
+      edges.push_back(e);
+  }
+
+  disjoint_sets sets(n);
+  std::vector<vertex_t> comp(n);
+  for (vertex_t v = 0; v < n; ++v)
+    comp[v] = v;
+  std::vector<std::atomic<edge_t>> lightest(n);
+  for (auto& x : lightest)
+    x.store(none, std::memory_order_relaxed);
+
+  // Offer e as the lightest edge of component c.
+  auto offer = [&](vertex_t c, edge_t e) {
+    edge_t cur = lightest[c].load(std::memory_order_relaxed);
+    while (cur == none || less(e, cur)) {
+      auto order = std::memory_order_relaxed;
+      if (lightest[c].compare_exchange_weak(cur, e, order, order))
+        break;
+    }
+  };
+
+  std::vector<edge_t> tree;
+  while (!edges.empty()) {
+    parallel_for(counted_range<std::size_t>(edges.size()),
+                 [&](counted_range<std::size_t> r) {
+      for (std::size_t i : r) {
+        edge_t e = edges[i];
+        offer(comp[g.first(e)], e);
+        offer(comp[g.second(e)], e);
+      }
+    });
+
+    // Add the selected edges. Because edges are totally ordered, the
+    // selected edges never form a cycle, except that two components may
+    // select the same edge.
+    for (vertex_t c = 0; c < n; ++c) {
+      edge_t e = lightest[c].load(std::memory_order_relaxed);
+      if (e == none)
+        continue;
+      lightest[c].store(none, std::memory_order_relaxed);
+      if (sets.join(g.first(e), g.second(e)))
+        tree.push_back(e);
+    }
+
+    // Relabel components and discard internal edges.
+    parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+      for (vertex_t v : r)
+        comp[v] = sets.root(v);
+    });
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](edge_t e) {
+      return comp[g.first(e)] == comp[g.second(e)];
+    }), edges.end());
+  }
+  return tree;
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,100 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../mst.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+template<typename W>
+long
+total(std::vector<edge_t> const& tree, W weight)
+{
+  long sum = 0;
+  for (edge_t e : tree)
+    sum += weight(e);
+  return sum;
+}
+
+
+int
+main()
+{
+  using G = graph<char, int>;
+  G g;
+  for (char c = 'a'; c <= 'g'; ++c)
+    g.add_vertex(c);
+  std::vector<int> weights;
+  auto add = [&](vertex_t u, vertex_t v, int w) {
+    g.add_edge(u, v, weights.size());
+    weights.push_back(w);
+  };
+  add(0, 1, 7);
+  add(0, 3, 5);
+  add(1, 2, 8);
+  add(1, 3, 9);
+  add(1, 4, 7);
+  add(2, 4, 5);
+  add(3, 4, 15);
+  add(3, 5, 6);
+  add(4, 5, 8);
+  add(4, 6, 9);
+  add(5, 6, 11);
+  auto weight = edge_label(weights);
+
+  std::vector<edge_t> expect {0, 1, 4, 5, 7, 9};
+  for (auto tree : {kruskal_mst(g, weight),
+                    prim_mst(g, weight),
+                    boruvka_mst(g, weight)}) {
+    std::sort(tree.begin(), tree.end());
+    assert(tree == expect);
+    assert(total(tree, weight) == 39);
+  }
+
+  // A random forest with many equal weights.
+  graph<> r;
+  std::size_t n = 2000;
+  for (std::size_t i = 0; i < n; ++i)
+    r.add_vertex();
+  std::minstd_rand gen(11);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::uniform_int_distribution<int> cost(0, 20);
+  std::vector<int> costs;
+  for (std::size_t i = 0; i < 3 * n; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (!r.has_edge(u, v)) {
+      r.add_edge(u, v);
+      costs.push_back(cost(gen));
+    }
+  }
+  auto w = edge_label(costs);
+  std::vector<edge_t> t1 = kruskal_mst(r, w);
+  std::vector<edge_t> t2 = prim_mst(r, w);
+  std::vector<edge_t> t3 = boruvka_mst(r, w);
+  std::sort(t1.begin(), t1.end());
+  std::sort(t2.begin(), t2.end());
+  std::sort(t3.begin(), t3.end());
+  assert(t1 == t2);
+  assert(t1 == t3);
+
+  // The forest has one fewer edge than vertices in each component.
+  disjoint_sets sets(n);
+  for (edge_t e : r.edges())
+    sets.join(r.first(e), r.second(e));
+  assert(t1.size() == n - sets.num_sets());
+
+  // Parallel sorting.
+  std::vector<int> xs(100000);
+  for (int& x : xs)
+    x = cost(gen) * 1000 + pick(gen) % 1000;
+  std::vector<int> ys = xs;
+  parallel_sort(xs.begin(), xs.end(), std::less<>(), 1000);
+  std::sort(ys.begin(), ys.end());
+  assert(xs == ys);
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../mst.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Compares the minimum spanning tree algorithms on random sparse and dense
+// graphs with uniformly distributed weights.
+void
+run(std::size_t n, std::size_t m)
+{
+  using clock = std::chrono::steady_clock;
+
+  graph<> g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(n ^ m);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::uniform_real_distribution<double> cost(0, 1);
+  std::vector<double> weights;
+  while (weights.size() < m) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u != v && !g.has_edge(u, v)) {
+      g.add_edge(u, v);
+      weights.push_back(cost(gen));
+    }
+  }
+  auto weight = edge_label(weights);
+
+  std::cout << n << " vertices, " << m << " edges\n";
+  auto time = [&](char const* name, auto mst) {
+    auto start = clock::now();
+    std::vector<edge_t> tree = mst();
+    std::chrono::duration<double, std::milli> t = clock::now() - start;
+    double sum = 0;
+    for (edge_t e : tree)
+      sum += weight(e);
+    std::cout << "  " << name << ": " << t.count() << " ms, "
+              << tree.size() << " edges, weight " << sum << '\n';
+  };
+  time("kruskal", [&]() { return kruskal_mst(g, weight); });
+  time("prim", [&]() { return prim_mst(g, weight); });
+  time("boruvka", [&]() { return boruvka_mst(g, weight); });
+}
+
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::size_t d = argc > 2 ? std::atoi(argv[2]) : 2000;
+  run(n, 4 * n);
+  run(d, d * (d - 1) / 4);
+}
@@ -5,6 +5,7 @@
 #define GRAPH_OUTPUT_HPP
 
 #include "common.hpp"
+#include "concepts.hpp"
 
 #include <iostream>
 
@@ -12,7 +13,9 @@
 namespace origin
 {
 
+// Prints a directed graph in the DOT language.
 template<typename G>
+  requires vertex_list_graph<G> && edge_list_graph<G> && directed_graph<G>
 struct print_digraph
 {
   print_digraph(std::ostream& os, G const& g)
@@ -46,7 +49,9 @@ struct print_digraph
 };
 
 
+// Prints an undirected graph in the DOT language.
 template<typename G>
+  requires vertex_list_graph<G> && edge_list_graph<G> && undirected_graph<G>
 struct print_graph
 {
   print_graph(std::ostream& os, G const& g)
@@ -0,0 +1,118 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_PAGERANK_HPP
+#define GRAPH_PAGERANK_HPP
+
+#include "common.hpp"
+#include "gather.hpp"
+#include "parallel.hpp"
+
+#include <cmath>
+#include <vector>
+
+
+namespace origin {
+
+// Computes the PageRank of each vertex of a directed graph by power
+// iteration. Each iteration pulls rank over the incoming edges of each
+// vertex, so no synchronization is needed between threads.
+//
+// The rank of a vertex is divided evenly among its outgoing edges. The
+// rank of vertices with no outgoing edges, and a fraction 1 - damping of
+// all rank, is redistributed according to the teleport vector. An empty
+// teleport vector is uniform. Otherwise, it is a personalization vector,
+// which is normalized before use.
+//
+// Iteration stops when the L1 distance between successive rank vectors is
+// less than tolerance or after max_iterations iterations.
+template<typename G>
+struct pagerank
+{
+  pagerank(G const& g)
+    : graph(g),
+      damping(0.85),
+      tolerance(1e-6),
+      max_iterations(100),
+      parts(partition_in_edges(g, 4 * concurrency())),
+      iterations(0),
+      error(0)
+  { }
+
+  void operator()();
+
+  G const& graph;
+  double damping;
+  double tolerance;
+  std::size_t max_iterations;
+  std::vector<double> teleport;
+
+  vertex_partition parts;
+  std::vector<double> ranks;
+  std::size_t iterations;
+  double error; // The L1 change in the last iteration
+};
+
+template<typename G>
+void
+pagerank<G>::operator()()
+{
+  std::size_t n = graph.num_vertices();
+  if (n == 0)
+    return;
+
+  // Normalize the teleport vector.
+  std::vector<double> jump(n, 1.0 / n);
+  if (!teleport.empty()) {
+    assert(teleport.size() == n);
+    double sum = 0;
+    for (double x : teleport)
+      sum += x;
+    assert(sum > 0);
+    for (vertex_t v = 0; v < n; ++v)
+      jump[v] = teleport[v] / sum;
+  }
+
+  // Precompute the reciprocal of each out degree.
+  std::vector<double> scale(n);
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      std::size_t d = graph.out_degree(v);
+      scale[v] = d ? 1.0 / d : 0.0;
+    }
+  });
+
+  ranks = jump;
+  std::vector<double> contrib(n);
+  std::vector<double> next(n);
+  std::vector<double> partial;
+  for (iterations = 0; iterations < max_iterations; ) {
+    // Compute the contribution of each vertex and the dangling rank.
+    double dangling = reduce_parts(parts, partial, [&](vertex_t v) {
+      contrib[v] = ranks[v] * scale[v];
+      return scale[v] == 0.0 ? ranks[v] : 0.0;
+    });
+
+    // Pull contributions over incoming edges.
+    gather_in_edges(graph, parts, next, [&](edge_t e) {
+      return contrib[graph.source(e)];
+    });
+
+    double base = damping * dangling + (1.0 - damping);
+    error = reduce_parts(parts, partial, [&](vertex_t v) {
+      double r = damping * next[v] + base * jump[v];
+      double d = std::abs(r - ranks[v]);
+      next[v] = r;
+      return d;
+    });
+    ranks.swap(next);
+    ++iterations;
+    if (error < tolerance)
+      break;
+  }
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,104 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../pagerank.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// A straightforward serial implementation used to check the results.
+template<typename G>
+std::vector<double>
+reference(G const& g, double d, std::vector<double> const& jump, int iters)
+{
+  std::size_t n = g.num_vertices();
+  std::vector<double> r = jump;
+  for (int i = 0; i < iters; ++i) {
+    std::vector<double> next(n, 0.0);
+    double dangling = 0;
+    for (vertex_t u : g.vertices()) {
+      if (g.out_degree(u) == 0)
+        dangling += r[u];
+      for (edge_t e : g.out_edges(u))
+        next[g.target(e)] += r[u] / g.out_degree(u);
+    }
+    for (vertex_t v : g.vertices())
+      next[v] = d * next[v] + (d * dangling + 1 - d) * jump[v];
+    r = next;
+  }
+  return r;
+}
+
+
+int
+main()
+{
+  using G = digraph<>;
+
+  // A cycle distributes rank uniformly.
+  G c;
+  for (int i = 0; i < 3; ++i)
+    c.add_vertex();
+  c.add_edge(0, 1);
+  c.add_edge(1, 2);
+  c.add_edge(2, 0);
+  pagerank<G> pr1(c);
+  pr1();
+  for (double r : pr1.ranks)
+    assert(std::abs(r - 1.0 / 3) < 1e-9);
+
+  // A random graph with dangling vertices.
+  G g;
+  std::minstd_rand gen(3);
+  std::size_t n = 500;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  for (std::size_t i = 0; i < 3 * n; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u % 10 != 0 && !g.has_edge(u, v))
+      g.add_edge(u, v);
+  }
+
+  // The in degree, computed by gathering.
+  std::vector<std::size_t> deg(n);
+  vertex_partition parts = partition_in_edges(g, 7);
+  assert(parts.bounds.front() == 0 && parts.bounds.back() == n);
+  gather_in_edges(g, parts, deg, [](edge_t) { return std::size_t(1); });
+  for (vertex_t v : g.vertices())
+    assert(deg[v] == g.in_degree(v));
+
+  pagerank<G> pr2(g);
+  pr2.tolerance = 1e-12;
+  pr2();
+  assert(pr2.error < 1e-12);
+  std::vector<double> ref = reference(g, 0.85, std::vector<double>(n, 1.0 / n),
+                                      pr2.iterations);
+  double sum = 0;
+  for (vertex_t v : g.vertices()) {
+    assert(std::abs(pr2.ranks[v] - ref[v]) < 1e-12);
+    sum += pr2.ranks[v];
+  }
+  assert(std::abs(sum - 1.0) < 1e-9);
+
+  // Personalized ranks.
+  pagerank<G> pr3(g);
+  pr3.teleport.assign(n, 0.0);
+  pr3.teleport[1] = 2;
+  pr3.teleport[2] = 2;
+  pr3.max_iterations = 20;
+  pr3();
+  assert(pr3.iterations == 20);
+  std::vector<double> jump(n, 0.0);
+  jump[1] = jump[2] = 0.5;
+  ref = reference(g, 0.85, jump, 20);
+  for (vertex_t v : g.vertices())
+    assert(std::abs(pr3.ranks[v] - ref[v]) < 1e-12);
+}
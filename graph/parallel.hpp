@@ -0,0 +1,137 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_PARALLEL_HPP
+#define GRAPH_PARALLEL_HPP
+
+#include "thread_pool.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+
+namespace origin {
+
+// Partition r into contiguous blocks of at least grain elements and call
+// f on each block, which is given as a counted_range<T>. There are at most
+// concurrency() blocks. They are run as tasks of the default pool, and the
+// calling thread takes the last block. This returns when all blocks have
+// been processed. May be called from within a task.
+template<typename T, typename F>
+void
+parallel_for(counted_range<T> r, F f, std::size_t grain = 1024)
+{
+  std::size_t n = r.size();
+  if (n == 0)
+    return;
+  std::size_t blocks = std::min(concurrency(), (n + grain - 1) / grain);
+  if (blocks <= 1) {
+    f(r);
+    return;
+  }
+
+  T first = *r.begin();
+  std::size_t step = n / blocks;
+  std::size_t extra = n % blocks;
+  task_group g(default_pool());
+  for (std::size_t i = 0; i < blocks; ++i) {
+    T last = first + step + (i < extra);
+    counted_range<T> block(first, last);
+    if (i + 1 < blocks)
+      g.run([&f, block]() { f(block); });
+    else
+      f(block);
+    first = last;
+  }
+  g.wait();
+}
+
+
+// Partition r into chunks of chunk elements and call f on each chunk, which
+// is given as a counted_range<T>. Up to concurrency() workers, run as tasks
+// of the default pool and by the calling thread, repeatedly claim the next
+// chunk from a shared counter, so workers that finish early take more
+// chunks. This balances work when the cost of elements is skewed.
+template<typename T, typename F>
+void
+parallel_for_dynamic(counted_range<T> r, F f, std::size_t chunk = 64)
+{
+  std::size_t n = r.size();
+  if (n == 0)
+    return;
+  std::size_t chunks = (n + chunk - 1) / chunk;
+  std::size_t workers = std::min(concurrency(), chunks);
+  if (workers <= 1) {
+    f(r);
+    return;
+  }
+
+  T first = *r.begin();
+  std::atomic<std::size_t> next(0);
+  auto work = [&]() {
+    while (true) {
+      std::size_t i = next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= chunks)
+        break;
+      std::size_t lo = i * chunk;
+      std::size_t hi = std::min(n, lo + chunk);
+      f(counted_range<T>(first + lo, first + hi));
+    }
+  };
+  task_group g(default_pool());
+  for (std::size_t i = 1; i < workers; ++i)
+    g.run(work);
+  work();
+  g.wait();
+}
+
+
+// Sort [first, last) according to comp. Blocks of the sequence are sorted
+// in parallel, and then adjacent runs are merged in parallel rounds.
+template<typename I, typename C = std::less<>>
+void
+parallel_sort(I first, I last, C comp = C(), std::size_t grain = 1 << 14)
+{
+  std::size_t n = last - first;
+  std::size_t blocks = std::min(concurrency(), n / grain);
+  if (blocks <= 1) {
+    std::sort(first, last, comp);
+    return;
+  }
+
+  // The boundaries of sorted runs.
+  std::vector<I> runs;
+  for (std::size_t i = 0; i <= blocks; ++i)
+    runs.push_back(first + n * i / blocks);
+
+  parallel_for(counted_range<std::size_t>(blocks),
+               [&](counted_range<std::size_t> r) {
+    for (std::size_t i : r)
+      std::sort(runs[i], runs[i + 1], comp);
+  }, 1);
+
+  while (runs.size() > 2) {
+    std::size_t pairs = (runs.size() - 1) / 2;
+    parallel_for(counted_range<std::size_t>(pairs),
+                 [&](counted_range<std::size_t> r) {
+      for (std::size_t i : r)
+        std::inplace_merge(runs[2 * i], runs[2 * i + 1], runs[2 * i + 2],
+                           comp);
+    }, 1);
+    std::vector<I> next;
+    for (std::size_t i = 0; i < runs.size(); i += 2)
+      next.push_back(runs[i]);
+    if (next.back() != runs.back())
+      next.push_back(runs.back());
+    runs.swap(next);
+  }
+}
+
+
+} // namespace origin
+
+#endif
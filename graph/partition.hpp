@@ -0,0 +1,515 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_PARTITION_HPP
+#define GRAPH_PARTITION_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "digraph.hpp"
+#include "graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+
+namespace origin {
+
+// Returns the number of edges of g whose ends are in different parts.
+template<typename G>
+  requires edge_list_graph<G> && (directed_graph<G> || undirected_graph<G>)
+std::size_t
+edge_cut(G const& g, std::vector<std::size_t> const& parts)
+{
+  std::size_t cut = 0;
+  for (edge_t e : g.edges()) {
+    if constexpr (directed_graph<G>)
+      cut += parts[g.source(e)] != parts[g.target(e)];
+    else
+      cut += parts[g.first(e)] != parts[g.second(e)];
+  }
+  return cut;
+}
+
+
+namespace partition_impl {
+
+constexpr vertex_t none = std::numeric_limits<vertex_t>::max();
+
+// An undirected graph with weighted vertices and edges, in compressed
+// sparse row form. Each edge appears in the adjacency of both ends.
+struct weighted_graph
+{
+  std::size_t size() const { return weights.size(); }
+
+  std::vector<std::size_t> offsets {0};
+  std::vector<vertex_t> heads;
+  std::vector<std::size_t> costs;    // Edge weights
+  std::vector<std::size_t> weights;  // Vertex weights
+  std::size_t total = 0;             // The sum of vertex weights
+};
+
+// Build the weighted graph of g, where each vertex has weight 1 and each
+// edge has the number of edges of g between its ends. Directions are
+// ignored and self loops are dropped.
+template<typename G>
+weighted_graph
+make_weighted(G const& g)
+{
+  weighted_graph w;
+  std::size_t n = g.num_vertices();
+  w.weights.assign(n, 1);
+  w.total = n;
+  std::vector<vertex_t> adj;
+  for (vertex_t u = 0; u < n; ++u) {
+    adj.clear();
+    if constexpr (bidirectional_graph<G>) {
+      for (edge_t e : g.out_edges(u))
+        adj.push_back(g.target(e));
+      for (edge_t e : g.in_edges(u))
+        adj.push_back(g.source(e));
+    }
+    else {
+      for (edge_t e : g.edges(u))
+        adj.push_back(g.opposite(e, u));
+    }
+    std::sort(adj.begin(), adj.end());
+    for (std::size_t i = 0; i < adj.size(); ) {
+      std::size_t j = i;
+      while (j < adj.size() && adj[j] == adj[i])
+        ++j;
+      if (adj[i] != u) {
+        w.heads.push_back(adj[i]);
+        w.costs.push_back(j - i);
+      }
+      i = j;
+    }
+    w.offsets.push_back(w.heads.size());
+  }
+  return w;
+}
+
+// Contract a heavy-edge matching of g. Vertices are visited in random
+// order, and each unmatched vertex is matched with the unmatched neighbor
+// joined by the heaviest edge, provided their combined weight is at most
+// limit. Stores the coarse vertex of each vertex in map.
+inline weighted_graph
+coarsen(weighted_graph const& g, std::vector<vertex_t>& map,
+        std::size_t limit, std::minstd_rand& gen)
+{
+  std::size_t n = g.size();
+  std::vector<vertex_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), gen);
+
+  std::vector<vertex_t> mates(n, none);
+  for (vertex_t u : order) {
+    if (mates[u] != none)
+      continue;
+    vertex_t best = u;
+    std::size_t heaviest = 0;
+    for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j) {
+      vertex_t v = g.heads[j];
+      if (mates[v] == none && g.costs[j] > heaviest &&
+          g.weights[u] + g.weights[v] <= limit) {
+        best = v;
+        heaviest = g.costs[j];
+      }
+    }
+    mates[u] = best;
+    mates[best] = u;
+  }
+
+  // Number the coarse vertices, and record a representative of each.
+  map.assign(n, none);
+  std::vector<vertex_t> leaders;
+  for (vertex_t u = 0; u < n; ++u) {
+    if (map[u] != none)
+      continue;
+    map[u] = map[mates[u]] = leaders.size();
+    leaders.push_back(u);
+  }
+
+  // Merge the adjacency of each pair. slots records where each coarse
+  // neighbor of the current vertex is stored.
+  weighted_graph c;
+  std::size_t m = leaders.size();
+  c.weights.resize(m);
+  c.total = g.total;
+  std::vector<std::size_t> slots(m, none);
+  for (vertex_t x = 0; x < m; ++x) {
+    vertex_t u = leaders[x];
+    vertex_t v = mates[u];
+    c.weights[x] = g.weights[u] + (v != u ? g.weights[v] : 0);
+    std::size_t first = c.heads.size();
+    for (vertex_t y : {u, v}) {
+      for (std::size_t j = g.offsets[y]; j < g.offsets[y + 1]; ++j) {
+        vertex_t z = map[g.heads[j]];
+        if (z == x)
+          continue;
+        if (slots[z] == none) {
+          slots[z] = c.heads.size();
+          c.heads.push_back(z);
+          c.costs.push_back(g.costs[j]);
+        }
+        else {
+          c.costs[slots[z]] += g.costs[j];
+        }
+      }
+      if (v == u)
+        break;
+    }
+    for (std::size_t j = first; j < c.heads.size(); ++j)
+      slots[c.heads[j]] = none;
+    c.offsets.push_back(c.heads.size());
+  }
+  return c;
+}
+
+// Returns the total weight of edges of g between different parts.
+inline std::size_t
+cut_weight(weighted_graph const& g, std::vector<std::size_t> const& parts)
+{
+  std::size_t cut = 0;
+  for (vertex_t u = 0; u < g.size(); ++u)
+    for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j)
+      cut += parts[u] != parts[g.heads[j]] ? g.costs[j] : 0;
+  return cut / 2;
+}
+
+// Partition g into k parts by growing each part in turn from a random
+// seed. The next vertex added is the one most strongly connected to the
+// part, until the part reaches its share of the total weight. The last
+// part takes the remaining vertices.
+//
+// Frontier vertices are kept in a heap keyed by their connection to the
+// part. A vertex is pushed again when its connection grows, and stale or
+// assigned entries are dropped when they reach the top, so growing costs
+// O(E log E) in all.
+inline void
+grow_partition(weighted_graph const& g, std::size_t k,
+               std::vector<std::size_t>& parts, std::minstd_rand& gen)
+{
+  using entry = std::pair<std::size_t, vertex_t>;
+  std::size_t n = g.size();
+  std::size_t target = (g.total + k - 1) / k;
+  parts.assign(n, k);
+  std::vector<std::size_t> conn(n, 0);
+  std::vector<vertex_t> frontier;
+  std::priority_queue<entry> heap;
+  std::vector<vertex_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), gen);
+  std::size_t next = 0;
+  for (std::size_t p = 0; p + 1 < k; ++p) {
+    std::size_t weight = 0;
+    while (weight < target) {
+      // Take the best frontier vertex, or a new seed.
+      vertex_t u = none;
+      while (!heap.empty() && u == none) {
+        entry top = heap.top();
+        heap.pop();
+        if (parts[top.second] == k && conn[top.second] == top.first)
+          u = top.second;
+      }
+      if (u == none) {
+        while (next < n && parts[order[next]] != k)
+          ++next;
+        if (next == n)
+          break;
+        u = order[next];
+      }
+      parts[u] = p;
+      weight += g.weights[u];
+      for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j) {
+        vertex_t v = g.heads[j];
+        if (parts[v] != k)
+          continue;
+        if (conn[v] == 0)
+          frontier.push_back(v);
+        conn[v] += g.costs[j];
+        heap.emplace(conn[v], v);
+      }
+    }
+    for (vertex_t v : frontier)
+      conn[v] = 0;
+    frontier.clear();
+    heap = std::priority_queue<entry>();
+  }
+  for (vertex_t u = 0; u < n; ++u)
+    if (parts[u] == k)
+      parts[u] = k - 1;
+}
+
+// Improve the partition by moving boundary vertices to the neighboring
+// part to which they are most strongly connected, as in label propagation,
+// when that reduces the cut and keeps the part within limit. Moves that
+// do not change the cut are made when they improve the balance. A vertex
+// in an overweight part moves to the best part that can take it, even if
+// that increases the cut. Stops after passes passes, or when a pass does
+// not reduce the cut.
+inline void
+refine(weighted_graph const& g, std::size_t k, std::size_t limit,
+       std::size_t passes, std::vector<std::size_t>& parts,
+       std::minstd_rand& gen)
+{
+  std::size_t n = g.size();
+  std::vector<std::size_t> loads(k, 0);
+  for (vertex_t u = 0; u < n; ++u)
+    loads[parts[u]] += g.weights[u];
+
+  std::vector<vertex_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<std::size_t> conn(k, 0);
+  std::vector<std::size_t> near;
+  for (std::size_t pass = 0; pass < passes; ++pass) {
+    std::shuffle(order.begin(), order.end(), gen);
+    long reduced = 0;
+    for (vertex_t u : order) {
+      std::size_t own = parts[u];
+      std::size_t w = g.weights[u];
+      near.clear();
+      for (std::size_t j = g.offsets[u]; j < g.offsets[u + 1]; ++j) {
+        std::size_t p = parts[g.heads[j]];
+        if (conn[p] == 0)
+          near.push_back(p);
+        conn[p] += g.costs[j];
+      }
+      bool over = loads[own] > limit;
+
+      std::size_t best = own;
+      long gain = 0;
+      for (std::size_t p : near) {
+        if (p == own || loads[p] + w > limit)
+          continue;
+        long d = long(conn[p]) - long(conn[own]);
+        bool better = best == own
+          ? (over || d > 0 || (d == 0 && loads[p] + w < loads[own]))
+          : d > gain;
+        if (better) {
+          best = p;
+          gain = d;
+        }
+      }
+      if (best == own && over) {
+        // Move to the lightest part, even if it is not adjacent.
+        std::size_t p = std::min_element(loads.begin(), loads.end()) -
+                        loads.begin();
+        if (loads[p] + w <= limit) {
+          best = p;
+          gain = long(conn[p]) - long(conn[own]);
+        }
+      }
+      for (std::size_t p : near)
+        conn[p] = 0;
+      if (best != own) {
+        loads[own] -= w;
+        loads[best] += w;
+        parts[u] = best;
+        reduced += gain;
+      }
+    }
+    if (reduced <= 0)
+      break;
+  }
+}
+
+} // namespace partition_impl
+
+
+// Partitions the vertices of a graph into k parts of about equal size,
+// minimizing the number of edges between parts. Directions of edges are
+// ignored.
+//
+// The partitioner is multilevel. The graph is repeatedly coarsened by
+// contracting a heavy-edge matching until it has a few vertices per part.
+// The coarsest graph is partitioned by greedy growing, keeping the best of
+// several trials. The partition is then projected back through each level
+// and refined there by moving boundary vertices to reduce the cut.
+//
+// Each part weighs at most (1 + imbalance) times the average.
+template<typename G>
+  requires vertex_list_graph<G> &&
+           (bidirectional_graph<G> || undirected_incidence_graph<G>)
+struct multilevel_partition
+{
+  multilevel_partition(G const& g, std::size_t k)
+    : graph(g),
+      k(k),
+      imbalance(0.03),
+      passes(8),
+      trials(4),
+      seed(1),
+      levels(0),
+      cut(0)
+  { }
+
+  void operator()();
+
+  G const& graph;
+  std::size_t k;
+  double imbalance;
+  std::size_t passes;  // Refinement passes per level
+  std::size_t trials;  // Initial partitions tried
+  std::size_t seed;
+
+  std::vector<std::size_t> parts; // The part of each vertex
+  std::size_t levels;             // The number of coarsening levels
+  std::size_t cut;                // The number of edges cut
+};
+
+template<typename G>
+  requires vertex_list_graph<G> &&
+           (bidirectional_graph<G> || undirected_incidence_graph<G>)
+void
+multilevel_partition<G>::operator()()
+{
+  using namespace partition_impl;
+
+  assert(k > 0);
+  std::minstd_rand gen(seed);
+  std::vector<weighted_graph> stack;
+  std::vector<std::vector<vertex_t>> maps;
+  stack.push_back(make_weighted(graph));
+  std::size_t total = stack.back().total;
+  std::size_t limit = std::ceil((1 + imbalance) * total / k);
+  limit = std::max(limit, (total + k - 1) / k);
+
+  // Coarsen until there are a few vertices per part, or until matching
+  // no longer shrinks the graph.
+  std::size_t small = std::max<std::size_t>(16 * k, 64);
+  std::size_t heaviest = std::max<std::size_t>(1, 3 * total / (2 * small));
+  while (stack.back().size() > small) {
+    maps.emplace_back();
+    weighted_graph c = coarsen(stack.back(), maps.back(), heaviest, gen);
+    if (c.size() > 0.95 * stack.back().size()) {
+      maps.pop_back();
+      break;
+    }
+    stack.push_back(std::move(c));
+  }
+  levels = maps.size();
+
+  // Partition the coarsest graph.
+  std::vector<std::size_t> best;
+  std::size_t best_cut = std::numeric_limits<std::size_t>::max();
+  for (std::size_t t = 0; t < std::max<std::size_t>(trials, 1); ++t) {
+    grow_partition(stack.back(), k, parts, gen);
+    refine(stack.back(), k, limit, passes, parts, gen);
+    std::size_t c = cut_weight(stack.back(), parts);
+    if (c < best_cut) {
+      best_cut = c;
+      best = parts;
+    }
+  }
+  parts = std::move(best);
+
+  // Project and refine.
+  while (!maps.empty()) {
+    stack.pop_back();
+    std::vector<vertex_t> const& map = maps.back();
+    std::vector<std::size_t> fine(map.size());
+    for (vertex_t u = 0; u < map.size(); ++u)
+      fine[u] = parts[map[u]];
+    parts = std::move(fine);
+    maps.pop_back();
+    refine(stack.back(), k, limit, passes, parts, gen);
+  }
+  cut = edge_cut(graph, parts);
+}
+
+
+// The vertices and edges of a graph assigned to one part, as a graph of
+// its own. Local vertices are numbered with the owned vertices first, in
+// increasing order of their global numbers, followed by ghost vertices:
+// vertices of other parts adjacent to an owned vertex, also in increasing
+// order. The shard contains every edge with an owned end, so cut edges
+// appear in the shards of both ends.
+template<typename H>
+struct graph_shard
+{
+  // Returns true if the local vertex v is owned by another part.
+  bool is_ghost(vertex_t v) const { return v >= owned; }
+
+  // Returns the local number of the global vertex v, or npos if v is not
+  // in the shard.
+  vertex_t local(vertex_t v) const
+  {
+    auto mid = vertices.begin() + owned;
+    auto i = std::lower_bound(vertices.begin(), mid, v);
+    if (i != mid && *i == v)
+      return i - vertices.begin();
+    auto j = std::lower_bound(mid, vertices.end(), v);
+    if (j != vertices.end() && *j == v)
+      return j - vertices.begin();
+    return npos;
+  }
+
+  static constexpr vertex_t npos = std::numeric_limits<vertex_t>::max();
+
+  H graph;
+  std::vector<vertex_t> vertices; // The global number of each vertex
+  std::vector<edge_t> edges;      // The global number of each edge
+  std::size_t owned;              // The number of owned vertices
+};
+
+// Returns a shard for each of the k parts of g. Shards of directed graphs
+// are digraphs, and shards of undirected graphs are graphs. Labels are not
+// copied; they are found through the global numbers of edges and vertices.
+template<typename G>
+  requires vertex_list_graph<G> && edge_list_graph<G> &&
+           (bidirectional_graph<G> || undirected_incidence_graph<G>)
+auto
+extract_shards(G const& g, std::vector<std::size_t> const& parts,
+               std::size_t k)
+{
+  using H = std::conditional_t<bidirectional_graph<G>, digraph<>, graph<>>;
+  auto ends = [&g](edge_t e) {
+    if constexpr (bidirectional_graph<G>)
+      return std::make_pair(g.source(e), g.target(e));
+    else
+      return std::make_pair(g.first(e), g.second(e));
+  };
+
+  std::vector<graph_shard<H>> shards(k);
+  for (vertex_t v : g.vertices())
+    shards[parts[v]].vertices.push_back(v);
+  for (auto& s : shards)
+    s.owned = s.vertices.size();
+
+  // Find ghosts, and the edges of each shard.
+  for (edge_t e : g.edges()) {
+    auto uv = ends(e);
+    std::size_t p = parts[uv.first];
+    std::size_t q = parts[uv.second];
+    shards[p].edges.push_back(e);
+    if (q != p) {
+      shards[q].edges.push_back(e);
+      shards[p].vertices.push_back(uv.second);
+      shards[q].vertices.push_back(uv.first);
+    }
+  }
+  for (auto& s : shards) {
+    auto mid = s.vertices.begin() + s.owned;
+    std::sort(mid, s.vertices.end());
+    s.vertices.erase(std::unique(mid, s.vertices.end()), s.vertices.end());
+    for (std::size_t i = 0; i < s.vertices.size(); ++i)
+      s.graph.add_vertex();
+    for (edge_t e : s.edges) {
+      auto uv = ends(e);
+      s.graph.add_edge(s.local(uv.first), s.local(uv.second));
+    }
+  }
+  return shards;
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,98 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../partition.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Compares the edge cut of hash partitioning with that of the multilevel
+// partitioner, on a perturbed grid (like a road network) and on a graph
+// grown by preferential attachment (like a social network), and reports
+// the time to partition and to extract the shards.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  using G = graph<>;
+
+  std::size_t side = argc > 1 ? std::atoi(argv[1]) : 400;
+  std::size_t k = argc > 2 ? std::atoi(argv[2]) : 16;
+  std::minstd_rand gen(11);
+
+  G road;
+  std::size_t n = side * side;
+  for (std::size_t i = 0; i < n; ++i)
+    road.add_vertex();
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  for (std::size_t y = 0; y < side; ++y)
+    for (std::size_t x = 0; x < side; ++x) {
+      vertex_t v = y * side + x;
+      if (x + 1 < side && gen() % 10)
+        road.add_edge(v, v + 1);
+      if (y + 1 < side && gen() % 10)
+        road.add_edge(v, v + side);
+    }
+  for (std::size_t i = 0; i < n / 100; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u != v && !road.has_edge(u, v))
+      road.add_edge(u, v);
+  }
+
+  G social;
+  std::vector<vertex_t> ends;
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = social.add_vertex();
+    for (int j = 0; j < 4 && !ends.empty(); ++j) {
+      vertex_t u = ends[gen() % ends.size()];
+      if (u != v && !social.has_edge(u, v)) {
+        social.add_edge(u, v);
+        ends.push_back(u);
+        ends.push_back(v);
+      }
+    }
+    if (ends.empty())
+      ends.push_back(v);
+  }
+
+  for (auto const* g : {&road, &social}) {
+    std::cout << (g == &road ? "road" : "social") << ": "
+              << g->num_vertices() << " vertices, " << g->num_edges()
+              << " edges, " << k << " parts\n";
+
+    std::vector<std::size_t> hashed(n);
+    for (vertex_t v = 0; v < n; ++v)
+      hashed[v] = (v * 2654435761u) % k;
+    std::size_t cut = edge_cut(*g, hashed);
+    std::cout << "  hash: cut " << cut << " ("
+              << 100.0 * cut / g->num_edges() << "%)\n";
+
+    multilevel_partition<G> mp(*g, k);
+    auto start = clock::now();
+    mp();
+    ms t = clock::now() - start;
+    std::cout << "  multilevel: cut " << mp.cut << " ("
+              << 100.0 * mp.cut / g->num_edges() << "%), " << mp.levels
+              << " levels, " << t.count() << " ms\n";
+
+    start = clock::now();
+    auto shards = extract_shards(*g, mp.parts, k);
+    t = clock::now() - start;
+    std::size_t ghosts = 0, largest = 0;
+    for (auto const& s : shards) {
+      ghosts += s.vertices.size() - s.owned;
+      largest = std::max(largest, s.owned);
+    }
+    std::cout << "  shards: " << ghosts << " ghosts, largest part "
+              << largest << ", " << t.count() << " ms\n";
+  }
+}
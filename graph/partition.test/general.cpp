@@ -0,0 +1,160 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../partition.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Check that parts is a balanced partition of g into k parts, and that its
+// shards cover g.
+template<typename G>
+void
+check(G const& g, std::vector<std::size_t> const& parts, std::size_t k,
+      double imbalance)
+{
+  std::size_t n = g.num_vertices();
+  assert(parts.size() == n);
+  std::vector<std::size_t> sizes(k, 0);
+  for (std::size_t p : parts) {
+    assert(p < k);
+    ++sizes[p];
+  }
+  std::size_t limit = std::ceil((1 + imbalance) * n / k);
+  for (std::size_t s : sizes)
+    assert(s <= std::max(limit, (n + k - 1) / k));
+
+  auto shards = extract_shards(g, parts, k);
+  assert(shards.size() == k);
+  std::size_t owned = 0, edges = 0;
+  for (std::size_t p = 0; p < k; ++p) {
+    auto const& s = shards[p];
+    assert(s.graph.num_vertices() == s.vertices.size());
+    assert(s.graph.num_edges() == s.edges.size());
+    owned += s.owned;
+    edges += s.edges.size();
+    for (vertex_t v = 0; v < s.vertices.size(); ++v) {
+      assert(s.local(s.vertices[v]) == v);
+      assert((parts[s.vertices[v]] == p) == !s.is_ghost(v));
+    }
+    // Every edge has an owned end.
+    for (edge_t e = 0; e < s.edges.size(); ++e) {
+      vertex_t a, b;
+      if constexpr (bidirectional_graph<G>) {
+        a = s.graph.source(e);
+        b = s.graph.target(e);
+        assert(s.vertices[a] == g.source(s.edges[e]));
+        assert(s.vertices[b] == g.target(s.edges[e]));
+      }
+      else {
+        a = s.graph.first(e);
+        b = s.graph.second(e);
+      }
+      assert(!s.is_ghost(a) || !s.is_ghost(b));
+    }
+  }
+  assert(owned == n);
+  assert(edges == g.num_edges() + edge_cut(g, parts));
+}
+
+// Returns a w by h grid.
+template<typename G>
+G
+grid(std::size_t w, std::size_t h)
+{
+  G g;
+  for (std::size_t i = 0; i < w * h; ++i)
+    g.add_vertex();
+  for (std::size_t y = 0; y < h; ++y)
+    for (std::size_t x = 0; x < w; ++x) {
+      if (x + 1 < w)
+        g.add_edge(y * w + x, y * w + x + 1);
+      if (y + 1 < h)
+        g.add_edge(y * w + x, (y + 1) * w + x);
+    }
+  return g;
+}
+
+
+int
+main()
+{
+  // Two cliques joined by a single edge are split at that edge.
+  {
+    graph<> g;
+    for (int i = 0; i < 20; ++i)
+      g.add_vertex();
+    for (vertex_t u = 0; u < 20; ++u)
+      for (vertex_t v = u + 1; v < 20; ++v)
+        if (u / 10 == v / 10)
+          g.add_edge(u, v);
+    g.add_edge(3, 14);
+    multilevel_partition<graph<>> mp(g, 2);
+    mp.imbalance = 0;
+    mp();
+    assert(mp.cut == 1);
+    check(g, mp.parts, 2, 0);
+    auto shards = extract_shards(g, mp.parts, 2);
+    for (auto const& s : shards) {
+      assert(s.owned == 10 && s.vertices.size() == 11);
+      assert(s.edges.size() == 46);
+    }
+  }
+
+  // A grid is cut along about a line per part.
+  {
+    using G = graph<>;
+    G g = grid<G>(40, 40);
+    for (std::size_t k : {1, 2, 4, 7}) {
+      multilevel_partition<G> mp(g, k);
+      mp();
+      check(g, mp.parts, k, mp.imbalance);
+      assert(mp.cut == edge_cut(g, mp.parts));
+      assert(mp.cut <= 40 * k);
+      if (k == 1)
+        assert(mp.cut == 0);
+    }
+  }
+
+  // Directed graphs are partitioned by their underlying undirected graph.
+  {
+    using G = digraph<>;
+    G g = grid<G>(30, 20);
+    g.add_edge(1, 0);
+    multilevel_partition<G> mp(g, 3);
+    mp.imbalance = 0.1;
+    mp();
+    check(g, mp.parts, 3, 0.1);
+    assert(mp.cut <= 3 * 30);
+    assert(mp.levels > 0);
+  }
+
+  // Random graphs, with more parts than some components.
+  std::minstd_rand gen(5);
+  for (int trial = 0; trial < 20; ++trial) {
+    using G = graph<>;
+    G g;
+    std::size_t n = 1 + gen() % 300;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (std::size_t i = 0; i < n; ++i) {
+      vertex_t u = pick(gen), v = pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+    std::size_t k = 1 + gen() % 8;
+    multilevel_partition<G> mp(g, k);
+    mp.seed = trial;
+    mp();
+    check(g, mp.parts, k, mp.imbalance);
+  }
+}
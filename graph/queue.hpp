@@ -5,9 +5,12 @@
 #define GRAPH_QUEUE_HPP
 
 #include "common.hpp"
+#include "concepts.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <queue>
+#include <vector>
 
 
 namespace origin
@@ -16,6 +19,7 @@ namespace origin
 // A function object used to compare the label values of vertices. This
 // is a relation on the value of the label.
 template<typename L, typename C>
+  requires vertex_property<L> && relation<C, vertex_value_type<L>>
 struct compare_vertex_label
 {
   compare_vertex_label(L label)
@@ -91,32 +95,60 @@ insertion_queue<T, C>::push(T&& key)
 }
 
 
-#if 0
+// A binary heap whose elements are dense indexes (0..n) that are ordered
+// by a priority label. The heap maintains the position of each key, so the
+// priority of a key in the heap can be changed in logarithmic time.
+//
+// The key at the top of the heap is the one that precedes all others
+// according to comp; with the default comparison, it has the smallest
+// priority.
+//
 // TODO: Currently we assume that T is an integer type whose values
 // are dense (0..n). In full generality, that won't hold water. We
 // should really parameterize the queue by the index to better lookup.
 template<typename T, typename L, typename C = std::less<>>
 struct mutable_binary_heap
 {
-  using std::vector<std::size_t> index_map;
-  using std::vector<T> key_list;
+  using index_map = std::vector<std::size_t>;
+  using key_list = std::vector<T>;
+
+  static constexpr std::size_t npos = -1;
+
+  mutable_binary_heap(std::size_t n, L pri);
+  mutable_binary_heap(std::size_t n, L pri, C comp);
 
   bool is_empty() const;
-  int size() const;
+  std::size_t size() const;
+  bool contains(T const&) const;
 
-  T const& top();
+  T const& top() const;
   void push(T const&);
   void pop();
+  void clear();
 
   template<typename U>
   void update(T const&, U const&);
 
+  bool before(std::size_t, std::size_t) const;
+  void swap(std::size_t, std::size_t);
+  void sift_up(std::size_t);
+  void sift_down(std::size_t);
+
   index_map index;
   key_list order;
   L pri;
   C comp;
 };
 
+template<typename T, typename L, typename C>
+mutable_binary_heap<T, L, C>::mutable_binary_heap(std::size_t n, L pri)
+  : index(n, npos), order(), pri(pri), comp()
+{ }
+
+template<typename T, typename L, typename C>
+mutable_binary_heap<T, L, C>::mutable_binary_heap(std::size_t n, L pri, C comp)
+  : index(n, npos), order(), pri(pri), comp(comp)
+{ }
 
 // Returns true if the binary heap is emmpty.
 template<typename T, typename L, typename C>
@@ -128,18 +160,27 @@ mutable_binary_heap<T, L, C>::is_empty() const
 
 // Returns the number of elements in the heap.
 template<typename T, typename L, typename C>
-int 
+std::size_t
 mutable_binary_heap<T, L, C>::size() const 
 { 
   return order.size(); 
 }
 
+// Returns true if k is in the heap.
+template<typename T, typename L, typename C>
+bool
+mutable_binary_heap<T, L, C>::contains(T const& k) const
+{
+  return index[k] != npos;
+}
+
 // Returns the element at the top of the heap.
 template<typename T, typename L, typename C>
 T const&
 mutable_binary_heap<T, L, C>::top() const
 {
-
+  assert(!is_empty());
+  return order.front();
 }
 
 // Insert a new element into the heap.
@@ -147,7 +188,10 @@ template<typename T, typename L, typename C>
 void
 mutable_binary_heap<T, L, C>::push(T const& k)
 {
-
+  assert(!contains(k));
+  index[k] = order.size();
+  order.push_back(k);
+  sift_up(order.size() - 1);
 }
 
 // Remove the top element from the heap.
@@ -155,7 +199,23 @@ template<typename T, typename L, typename C>
 void
 mutable_binary_heap<T, L, C>::pop()
 {
+  assert(!is_empty());
+  swap(0, order.size() - 1);
+  index[order.back()] = npos;
+  order.pop_back();
+  if (!order.empty())
+    sift_down(0);
+}
 
+// Remove all elements from the heap. This is linear in the size of the
+// heap, not the number of keys.
+template<typename T, typename L, typename C>
+void
+mutable_binary_heap<T, L, C>::clear()
+{
+  for (T const& k : order)
+    index[k] = npos;
+  order.clear();
 }
 
 // Update the position of k within the heap as a result of changing its
@@ -167,9 +227,60 @@ template<typename U>
 void
 mutable_binary_heap<T, L, C>::update(T const& key, U const& value)
 {
+  assert(contains(key));
+  pri(key) = value;
+  sift_up(index[key]);
+  sift_down(index[key]);
+}
 
+// Returns true if the key at position i should be above the key at j.
+template<typename T, typename L, typename C>
+inline bool
+mutable_binary_heap<T, L, C>::before(std::size_t i, std::size_t j) const
+{
+  return comp(pri(order[i]), pri(order[j]));
+}
+
+// Exchange the keys at positions i and j.
+template<typename T, typename L, typename C>
+inline void
+mutable_binary_heap<T, L, C>::swap(std::size_t i, std::size_t j)
+{
+  std::swap(order[i], order[j]);
+  index[order[i]] = i;
+  index[order[j]] = j;
+}
+
+template<typename T, typename L, typename C>
+void
+mutable_binary_heap<T, L, C>::sift_up(std::size_t i)
+{
+  while (i != 0) {
+    std::size_t p = (i - 1) / 2;
+    if (!before(i, p))
+      break;
+    swap(i, p);
+    i = p;
+  }
+}
+
+template<typename T, typename L, typename C>
+void
+mutable_binary_heap<T, L, C>::sift_down(std::size_t i)
+{
+  std::size_t n = order.size();
+  while (true) {
+    std::size_t c = 2 * i + 1;
+    if (c >= n)
+      break;
+    if (c + 1 < n && before(c + 1, c))
+      ++c;
+    if (!before(c, i))
+      break;
+    swap(i, c);
+    i = c;
+  }
 }
-#endif
 
 
 } // namespace origin
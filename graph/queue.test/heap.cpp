@@ -0,0 +1,55 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include <graph/queue.hpp>
+
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  // Randomize a list of priorities.
+  std::vector<int> priority(100);
+  std::iota(priority.begin(), priority.end(), 0);
+  std::shuffle(priority.begin(), priority.end(), std::minstd_rand(0));
+
+  auto pri = vertex_label(priority);
+  mutable_binary_heap<vertex_t, decltype(pri)> heap(priority.size(), pri);
+  for (vertex_t v = 0; v < priority.size(); ++v)
+    heap.push(v);
+  assert(heap.size() == 100);
+
+  // Move some keys to the front and back of the queue.
+  heap.update(50, -1);
+  heap.update(60, 1000);
+  assert(heap.top() == 50);
+
+  int last = -2;
+  while (!heap.is_empty()) {
+    vertex_t v = heap.top();
+    assert(priority[v] > last);
+    last = priority[v];
+    heap.pop();
+    assert(!heap.contains(v));
+  }
+  assert(last == 1000);
+
+  // A max-heap.
+  mutable_binary_heap<vertex_t, decltype(pri), std::greater<>> max(100, pri);
+  for (vertex_t v = 0; v < 10; ++v)
+    max.push(v);
+  vertex_t top = max.top();
+  for (vertex_t v = 0; v < 10; ++v)
+    assert(priority[v] <= priority[top]);
+  max.clear();
+  assert(max.is_empty());
+  assert(!max.contains(top));
+}
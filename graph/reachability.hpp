@@ -0,0 +1,313 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_REACHABILITY_HPP
+#define GRAPH_REACHABILITY_HPP
+
+#include "common.hpp"
+#include "components.hpp"
+#include "topological.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+
+namespace origin {
+
+// An index that answers reachability queries on a directed graph.
+//
+// The strongly connected components of the graph are condensed into a
+// DAG. Each component is labeled with a topological number and with k
+// GRAIL intervals, each computed by a randomized post-order traversal of
+// the DAG. If a reaches b, then topo(a) < topo(b), and the intervals of b
+// are contained in those of a. A query that fails either test is answered
+// negatively in O(k). Otherwise, a depth-first search of the DAG decides
+// the query, pruning components whose labels exclude the target.
+//
+// The index is built lazily, on the first query after construction or
+// after an update that invalidates it. Edges and vertices should be added
+// through the index, which updates the graph and then the index:
+//
+//  - An edge between different components widens the intervals of the
+//    ancestors of the source component. This visits only ancestors whose
+//    intervals do not already contain those of the target.
+//  - If the edge violates the topological numbers, the affected region is
+//    renumbered as in Pearce and Kelly's dynamic topological sort. This
+//    visits only the components numbered between the ends of the edge.
+//  - An edge that creates a cycle merges components, so the index is
+//    rebuilt on the next query.
+//
+// Widening intervals weakens their pruning. Call rebuild() to recompute
+// tight labels after many updates.
+//
+// Queries modify scratch state, so the index must not be queried by
+// multiple threads concurrently.
+template<typename G>
+struct reachability_index
+{
+  reachability_index(G& g, std::size_t k = 2)
+    : graph(g), k(k), stale(true), rebuilds(0)
+  { }
+
+  vertex_t add_vertex();
+  edge_t add_edge(vertex_t u, vertex_t v);
+
+  bool reaches(vertex_t u, vertex_t v);
+
+  void rebuild();
+
+  // Returns true if the labels of component a do not exclude a path to
+  // component b.
+  bool may_reach(vertex_t a, vertex_t b) const;
+
+  // Widen the intervals of a and its ancestors to contain those of b.
+  void widen(vertex_t a, vertex_t b);
+
+  // Renumber components after adding (a, b) when topo(a) > topo(b).
+  bool reorder(vertex_t a, vertex_t b);
+
+  G& graph;
+  std::size_t k;         // The number of intervals per component
+  bool stale;            // True if the labels must be rebuilt
+  std::size_t rebuilds;  // The number of times the index was built
+
+  std::vector<vertex_t> components;            // The component of each vertex
+  std::vector<std::vector<vertex_t>> succ;     // The condensed DAG
+  std::vector<std::vector<vertex_t>> pred;
+  std::vector<std::size_t> topo;               // Topological numbers
+  std::vector<std::size_t> lows;               // Interval i of c is
+  std::vector<std::size_t> highs;              // [lows, highs][c * k + i]
+  std::size_t next_topo;
+  std::size_t next_rank;
+
+  // Search state, also used by queries.
+  topological_repair repair;
+};
+
+// Add a vertex to the graph. If the index is current, the vertex forms a
+// new component whose labels exclude all other components.
+template<typename G>
+vertex_t
+reachability_index<G>::add_vertex()
+{
+  vertex_t v = graph.add_vertex();
+  if (stale)
+    return v;
+  vertex_t c = succ.size();
+  components.push_back(c);
+  succ.emplace_back();
+  pred.emplace_back();
+  topo.push_back(next_topo++);
+  for (std::size_t i = 0; i < k; ++i) {
+    lows.push_back(next_rank);
+    highs.push_back(next_rank);
+  }
+  ++next_rank;
+  repair.marks.push_back(0);
+  return v;
+}
+
+// Add the edge (u, v) to the graph and update the index.
+template<typename G>
+edge_t
+reachability_index<G>::add_edge(vertex_t u, vertex_t v)
+{
+  edge_t e = graph.add_edge(u, v);
+  if (stale)
+    return e;
+  vertex_t a = components[u];
+  vertex_t b = components[v];
+  if (a == b)
+    return e;
+  if (topo[a] > topo[b] && !reorder(a, b)) {
+    // The edge creates a cycle.
+    stale = true;
+    return e;
+  }
+  succ[a].push_back(b);
+  pred[b].push_back(a);
+  widen(a, b);
+  return e;
+}
+
+template<typename G>
+void
+reachability_index<G>::widen(vertex_t a, vertex_t b)
+{
+  auto covers = [this](vertex_t x, vertex_t y) {
+    for (std::size_t i = 0; i < k; ++i) {
+      if (lows[x * k + i] > lows[y * k + i] ||
+          highs[x * k + i] < highs[y * k + i])
+        return false;
+    }
+    return true;
+  };
+
+  std::vector<vertex_t>& stack = repair.stack;
+  stack.clear();
+  stack.push_back(a);
+  while (!stack.empty()) {
+    vertex_t x = stack.back();
+    stack.pop_back();
+    if (covers(x, b))
+      continue;
+    for (std::size_t i = 0; i < k; ++i) {
+      lows[x * k + i] = std::min(lows[x * k + i], lows[b * k + i]);
+      highs[x * k + i] = std::max(highs[x * k + i], highs[b * k + i]);
+    }
+    for (vertex_t p : pred[x])
+      stack.push_back(p);
+  }
+}
+
+// Returns false if b reaches a. Otherwise, the components are renumbered
+// by Pearce and Kelly's repair so that topo(a) < topo(b).
+template<typename G>
+bool
+reachability_index<G>::reorder(vertex_t a, vertex_t b)
+{
+  auto successors = [this](vertex_t x, auto f) {
+    for (vertex_t y : succ[x])
+      f(y);
+  };
+  auto predecessors = [this](vertex_t x, auto f) {
+    for (vertex_t y : pred[x])
+      f(y);
+  };
+  return repair(a, b, topo, successors, predecessors);
+}
+
+template<typename G>
+bool
+reachability_index<G>::may_reach(vertex_t a, vertex_t b) const
+{
+  if (topo[a] > topo[b])
+    return false;
+  for (std::size_t i = 0; i < k; ++i) {
+    if (lows[a * k + i] > lows[b * k + i] ||
+        highs[a * k + i] < highs[b * k + i])
+      return false;
+  }
+  return true;
+}
+
+// Returns true if there is a path from u to v.
+template<typename G>
+bool
+reachability_index<G>::reaches(vertex_t u, vertex_t v)
+{
+  if (stale)
+    rebuild();
+  vertex_t a = components[u];
+  vertex_t b = components[v];
+  if (a == b)
+    return true;
+  if (!may_reach(a, b))
+    return false;
+
+  // Search the DAG from a, pruning components that cannot reach b.
+  std::vector<std::uint32_t>& marks = repair.marks;
+  std::vector<vertex_t>& stack = repair.stack;
+  repair.next_epoch();
+  std::uint32_t epoch = repair.epoch;
+  stack.clear();
+  stack.push_back(a);
+  marks[a] = epoch;
+  while (!stack.empty()) {
+    vertex_t x = stack.back();
+    stack.pop_back();
+    for (vertex_t y : succ[x]) {
+      if (y == b)
+        return true;
+      if (marks[y] == epoch || !may_reach(y, b))
+        continue;
+      marks[y] = epoch;
+      stack.push_back(y);
+    }
+  }
+  return false;
+}
+
+// Recompute the components, the condensed DAG, and its labels.
+template<typename G>
+void
+reachability_index<G>::rebuild()
+{
+  std::size_t n = strong_components(graph, components);
+
+  succ.assign(n, {});
+  pred.assign(n, {});
+  for (edge_t e : graph.edges()) {
+    vertex_t a = components[graph.source(e)];
+    vertex_t b = components[graph.target(e)];
+    if (a != b)
+      succ[a].push_back(b);
+  }
+  for (vertex_t a = 0; a < n; ++a) {
+    std::sort(succ[a].begin(), succ[a].end());
+    succ[a].erase(std::unique(succ[a].begin(), succ[a].end()),
+                  succ[a].end());
+    for (vertex_t b : succ[a])
+      pred[b].push_back(a);
+  }
+
+  // Components are numbered in reverse topological order.
+  topo.resize(n);
+  for (vertex_t c = 0; c < n; ++c)
+    topo[c] = n - 1 - c;
+  next_topo = n;
+
+  // Label each component with the interval [low, rank], where rank is its
+  // post-order number in a randomized traversal and low is the least rank
+  // of its descendants. Roots and successors are visited starting from
+  // random offsets.
+  lows.assign(n * k, 0);
+  highs.assign(n * k, 0);
+  std::vector<char> seen(n);
+  std::vector<std::pair<vertex_t, std::size_t>> calls;
+  std::minstd_rand gen(rebuilds + 1);
+  for (std::size_t i = 0; i < k; ++i) {
+    std::fill(seen.begin(), seen.end(), 0);
+    std::size_t rank = 0;
+    vertex_t start = n ? gen() % n : 0;
+    for (vertex_t j = 0; j < n; ++j) {
+      vertex_t r = (start + j) % n;
+      if (seen[r] || !pred[r].empty())
+        continue;
+      seen[r] = 1;
+      calls.emplace_back(r, 0);
+      std::size_t offset = gen();
+      while (!calls.empty()) {
+        vertex_t x = calls.back().first;
+        std::size_t& m = calls.back().second;
+        std::vector<vertex_t> const& out = succ[x];
+        if (m < out.size()) {
+          vertex_t y = out[(offset + m++) % out.size()];
+          if (!seen[y]) {
+            seen[y] = 1;
+            calls.emplace_back(y, 0);
+          }
+          continue;
+        }
+        calls.pop_back();
+        std::size_t low = rank;
+        for (vertex_t y : out)
+          low = std::min(low, lows[y * k + i]);
+        lows[x * k + i] = low;
+        highs[x * k + i] = rank++;
+      }
+    }
+  }
+  next_rank = n;
+
+  repair.reset(n);
+  stale = false;
+  ++rebuilds;
+}
+
+
+} // namespace origin
+
+#endif
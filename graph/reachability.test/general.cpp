@@ -0,0 +1,111 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../reachability.hpp"
+
+#include <cassert>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Returns the vertices reachable from s.
+template<typename G>
+std::vector<char>
+reachable(G const& g, vertex_t s)
+{
+  std::vector<char> seen(g.num_vertices(), 0);
+  std::vector<vertex_t> stack {s};
+  seen[s] = 1;
+  while (!stack.empty()) {
+    vertex_t u = stack.back();
+    stack.pop_back();
+    for (edge_t e : g.out_edges(u)) {
+      vertex_t v = g.target(e);
+      if (!seen[v]) {
+        seen[v] = 1;
+        stack.push_back(v);
+      }
+    }
+  }
+  return seen;
+}
+
+template<typename G>
+void
+check(reachability_index<G>& index, G const& g)
+{
+  for (vertex_t u : g.vertices()) {
+    std::vector<char> seen = reachable(g, u);
+    for (vertex_t v : g.vertices())
+      assert(index.reaches(u, v) == bool(seen[v]));
+  }
+}
+
+
+int
+main()
+{
+  // Two cycles joined by an edge.
+  digraph<> g;
+  for (int i = 0; i < 6; ++i)
+    g.add_vertex();
+  g.add_edge(0, 1);
+  g.add_edge(1, 2);
+  g.add_edge(2, 0);
+  g.add_edge(3, 4);
+  g.add_edge(4, 3);
+  g.add_edge(2, 3);
+
+  std::vector<vertex_t> comp;
+  assert(strong_components(g, comp) == 3);
+  assert(comp[0] == comp[1] && comp[1] == comp[2]);
+  assert(comp[3] == comp[4]);
+  assert(comp[0] > comp[3] && comp[3] != comp[5]);
+
+  reachability_index<digraph<>> index(g);
+  check(index, g);
+  assert(index.rebuilds == 1);
+
+  // Edges that respect the order do not rebuild the index.
+  vertex_t x = index.add_vertex();
+  index.add_edge(4, x);
+  index.add_edge(x, 5);
+  check(index, g);
+  assert(index.rebuilds == 1);
+
+  // An edge that creates a cycle merges components.
+  index.add_edge(5, 0);
+  check(index, g);
+  assert(index.rebuilds == 2);
+  assert(index.components[0] == index.components[5]);
+
+  // Random graphs with few cycles, updated incrementally.
+  digraph<> r;
+  std::size_t n = 300;
+  for (std::size_t i = 0; i < n; ++i)
+    r.add_vertex();
+  std::minstd_rand gen(19);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  auto add = [&](auto&& f) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u > v && gen() % 50)
+      std::swap(u, v);
+    if (!r.has_edge(u, v))
+      f(u, v);
+  };
+  for (int i = 0; i < 400; ++i)
+    add([&](vertex_t u, vertex_t v) { r.add_edge(u, v); });
+  reachability_index<digraph<>> ri(r, 3);
+  check(ri, r);
+  for (int round = 0; round < 5; ++round) {
+    for (int i = 0; i < 40; ++i)
+      add([&](vertex_t u, vertex_t v) { ri.add_edge(u, v); });
+    check(ri, r);
+  }
+  ri.rebuild();
+  check(ri, r);
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../dfs.hpp"
+#include "../reachability.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Compares random reachability queries answered by the index with queries
+// answered by a fresh depth-first search, on a sparse graph whose edges
+// mostly point forward, and measures incremental updates.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::size_t m = argc > 2 ? std::atoi(argv[2]) : 3 * n;
+  std::size_t q = argc > 3 ? std::atoi(argv[3]) : 100000;
+
+  digraph<> g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(23);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  auto edge = [&]() {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u > v && gen() % 1000)
+      std::swap(u, v);
+    return std::make_pair(u, v);
+  };
+  while (g.num_edges() < m) {
+    auto p = edge();
+    if (!g.has_edge(p.first, p.second))
+      g.add_edge(p.first, p.second);
+  }
+
+  reachability_index<digraph<>> index(g);
+  auto start = clock::now();
+  index.rebuild();
+  ms t0 = clock::now() - start;
+  std::cout << n << " vertices, " << m << " edges, "
+            << index.succ.size() << " components\n";
+  std::cout << "build: " << t0.count() << " ms\n";
+
+  std::vector<std::pair<vertex_t, vertex_t>> queries(q);
+  for (auto& p : queries)
+    p = {pick(gen), pick(gen)};
+
+  start = clock::now();
+  std::size_t yes = 0;
+  for (auto const& p : queries)
+    yes += index.reaches(p.first, p.second);
+  ms t1 = clock::now() - start;
+  std::cout << "index: " << 1e3 * t1.count() / q << " us/query, " << yes
+            << " reachable\n";
+
+  // A full search per query is slow, so use fewer queries.
+  std::size_t few = std::min<std::size_t>(q, 200);
+  start = clock::now();
+  std::size_t yes2 = 0;
+  for (std::size_t i = 0; i < few; ++i) {
+    directed_dfs<digraph<>> dfs(g);
+    auto color = vertex_label(dfs.colors);
+    auto parent = vertex_label(dfs.parents);
+    dfs.explore(queries[i].first, color, parent);
+    yes2 += dfs.colors[queries[i].second] != white;
+  }
+  ms t2 = clock::now() - start;
+  std::cout << "dfs: " << 1e3 * t2.count() / few << " us/query\n";
+
+  // Forward edges update the index in place; backward edges trigger a
+  // rebuild on the next query.
+  start = clock::now();
+  std::size_t updates = 0;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    auto p = edge();
+    if (g.has_edge(p.first, p.second))
+      continue;
+    index.add_edge(p.first, p.second);
+    index.reaches(p.second, p.first);
+    ++updates;
+  }
+  ms t3 = clock::now() - start;
+  std::cout << "update and query: " << 1e3 * t3.count() / updates
+            << " us, " << index.rebuilds - 1 << " rebuilds\n";
+}
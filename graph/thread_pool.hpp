@@ -0,0 +1,558 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_THREAD_POOL_HPP
+#define GRAPH_THREAD_POOL_HPP
+
+#include "utility.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+
+namespace origin {
+
+// Returns the number of threads used by parallel algorithms.
+inline std::size_t
+concurrency()
+{
+  std::size_t n = std::thread::hardware_concurrency();
+  return n ? n : 1;
+}
+
+
+// A Chase-Lev work-stealing deque of pointers. The owning thread pushes
+// and pops at the bottom; any other thread may steal from the top. The
+// circular buffer doubles when full. Old buffers are kept until the deque
+// is destroyed, since a thief may still be reading from them.
+//
+// The memory orders follow Lê et al., "Correct and Efficient Work-Stealing
+// for Weak Memory Models" (PPoPP 2013).
+template<typename T>
+struct work_stealing_deque
+{
+  static_assert(std::is_pointer<T>::value, "deque elements are pointers");
+
+  // A circular buffer whose capacity is a power of 2.
+  struct ring
+  {
+    explicit ring(std::size_t n)
+      : mask(n - 1), items(new std::atomic<T>[n])
+    { }
+
+    std::size_t capacity() const { return mask + 1; }
+
+    T get(std::int64_t i) const
+    {
+      return items[i & mask].load(std::memory_order_relaxed);
+    }
+
+    void put(std::int64_t i, T x)
+    {
+      items[i & mask].store(x, std::memory_order_relaxed);
+    }
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+  explicit work_stealing_deque(std::size_t n = 256)
+    : top(0), bottom(0)
+  {
+    rings.emplace_back(new ring(n));
+    buffer.store(rings.back().get(), std::memory_order_relaxed);
+  }
+
+  work_stealing_deque(work_stealing_deque const&) = delete;
+  work_stealing_deque& operator=(work_stealing_deque const&) = delete;
+
+  // Returns true if the deque appears empty. The result may be stale.
+  bool is_empty() const
+  {
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  void push(T x);
+  bool pop(T& x);
+  bool steal(T& x);
+
+  std::atomic<std::int64_t> top;
+  std::atomic<std::int64_t> bottom;
+  std::atomic<ring*> buffer;
+  std::vector<std::unique_ptr<ring>> rings; // Owned by the pushing thread
+};
+
+// Push x onto the bottom of the deque. Only the owner may call this.
+template<typename T>
+void
+work_stealing_deque<T>::push(T x)
+{
+  std::int64_t b = bottom.load(std::memory_order_relaxed);
+  std::int64_t t = top.load(std::memory_order_acquire);
+  ring* a = buffer.load(std::memory_order_relaxed);
+  if (b - t > std::int64_t(a->capacity()) - 1) {
+    ring* r = new ring(2 * a->capacity());
+    for (std::int64_t i = t; i < b; ++i)
+      r->put(i, a->get(i));
+    rings.emplace_back(r);
+    buffer.store(r, std::memory_order_release);
+    a = r;
+  }
+  a->put(b, x);
+  bottom.store(b + 1, std::memory_order_release);
+}
+
+// Pop the most recently pushed element into x. Only the owner may call
+// this. Returns false if the deque is empty or the last element was
+// stolen.
+template<typename T>
+bool
+work_stealing_deque<T>::pop(T& x)
+{
+  std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+  ring* a = buffer.load(std::memory_order_relaxed);
+  bottom.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t t = top.load(std::memory_order_relaxed);
+  if (t > b) {
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return false;
+  }
+  x = a->get(b);
+  if (t == b) {
+    // The last element; race with thieves for it.
+    bool won = top.compare_exchange_strong(t, t + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+  return true;
+}
+
+// Steal the least recently pushed element into x. Returns false if the
+// deque is empty or another thread took the element first.
+template<typename T>
+bool
+work_stealing_deque<T>::steal(T& x)
+{
+  std::int64_t t = top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::int64_t b = bottom.load(std::memory_order_acquire);
+  if (t >= b)
+    return false;
+  ring* a = buffer.load(std::memory_order_acquire);
+  x = a->get(t);
+  return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed);
+}
+
+
+struct task_group;
+
+inline void task_group_done(task_group* g);
+
+// A unit of work scheduled on a thread pool.
+struct pool_task
+{
+  virtual ~pool_task() = default;
+  virtual void execute() = 0;
+
+  task_group* group = nullptr;
+};
+
+template<typename F>
+struct function_task : pool_task
+{
+  function_task(F f)
+    : fn(std::move(f))
+  { }
+
+  void execute() override { fn(); }
+
+  F fn;
+};
+
+
+// A fixed set of worker threads that execute tasks. Each worker owns a
+// work-stealing deque. Tasks spawned by a worker are pushed onto its own
+// deque and popped in LIFO order; idle workers steal the oldest tasks
+// from randomly chosen victims. Tasks spawned by other threads are placed
+// in a shared queue.
+//
+// Workers that find no work spin briefly and then sleep until a task is
+// submitted. When pinned, worker i is bound to processor i (modulo the
+// number of processors) where the platform supports it.
+//
+// Threads that wait for a task group help by executing tasks, so nested
+// fork/join parallelism does not deadlock. Tasks must not throw.
+struct thread_pool
+{
+  static constexpr std::size_t npos = std::size_t(-1);
+
+  explicit thread_pool(std::size_t n = concurrency(), bool pinned = false);
+
+  thread_pool(thread_pool const&) = delete;
+  thread_pool& operator=(thread_pool const&) = delete;
+
+  ~thread_pool();
+
+  std::size_t size() const { return workers.size(); }
+
+  void submit(pool_task* t);
+  bool run_one();
+  bool has_local_work() const;
+
+  // Returns the index of the calling thread's worker, or npos if the
+  // calling thread is not a worker of this pool.
+  std::size_t worker_index() const;
+
+  // State
+
+  struct worker
+  {
+    work_stealing_deque<pool_task*> deque;
+    std::uint32_t seed;
+    std::thread thread;
+  };
+
+  void work(std::size_t i);
+  pool_task* find_task(std::size_t self);
+  void execute(pool_task* t);
+
+  std::vector<std::unique_ptr<worker>> workers;
+
+  std::mutex shared_mutex;
+  std::deque<pool_task*> shared;
+  std::atomic<std::size_t> shared_size;
+
+  std::atomic<std::size_t> pending;   // Submitted but not yet started
+  std::atomic<std::size_t> sleeping;
+  std::atomic<bool> stopping;
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+};
+
+
+namespace pool_impl {
+
+// The pool and worker index of the calling thread.
+struct current_worker
+{
+  thread_pool const* pool;
+  std::size_t index;
+};
+
+inline current_worker&
+current()
+{
+  static thread_local current_worker w { nullptr, thread_pool::npos };
+  return w;
+}
+
+// Bind t to processor i, where supported.
+inline void
+pin_thread(std::thread& t, std::size_t i)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(i % concurrency(), &set);
+  pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+#else
+  (void)t;
+  (void)i;
+#endif
+}
+
+} // namespace pool_impl
+
+
+// Start n worker threads, at least 1.
+inline
+thread_pool::thread_pool(std::size_t n, bool pinned)
+  : shared_size(0), pending(0), sleeping(0), stopping(false)
+{
+  if (n == 0)
+    n = 1;
+  for (std::size_t i = 0; i < n; ++i) {
+    workers.emplace_back(new worker());
+    workers.back()->seed = 2654435761u * (i + 1);
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    workers[i]->thread = std::thread([this, i]() { work(i); });
+    if (pinned)
+      pool_impl::pin_thread(workers[i]->thread, i);
+  }
+}
+
+// Finish all submitted tasks and stop the workers.
+inline
+thread_pool::~thread_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping.store(true);
+  }
+  wake.notify_all();
+  for (auto& w : workers)
+    w->thread.join();
+}
+
+inline std::size_t
+thread_pool::worker_index() const
+{
+  pool_impl::current_worker const& w = pool_impl::current();
+  return w.pool == this ? w.index : npos;
+}
+
+// Schedule t for execution.
+inline void
+thread_pool::submit(pool_task* t)
+{
+  std::size_t i = worker_index();
+  if (i != npos) {
+    workers[i]->deque.push(t);
+  }
+  else {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    shared.push_back(t);
+    shared_size.fetch_add(1);
+  }
+  pending.fetch_add(1);
+  if (sleeping.load()) {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    wake.notify_one();
+  }
+}
+
+// Returns true if tasks spawned by the calling thread have not yet been
+// taken by other threads.
+inline bool
+thread_pool::has_local_work() const
+{
+  std::size_t i = worker_index();
+  if (i != npos)
+    return !workers[i]->deque.is_empty();
+  return shared_size.load(std::memory_order_relaxed) != 0;
+}
+
+// Returns a task from the calling worker's deque, a random victim, or the
+// shared queue, or nullptr if none was found.
+inline pool_task*
+thread_pool::find_task(std::size_t self)
+{
+  pool_task* t = nullptr;
+  if (self != npos && workers[self]->deque.pop(t))
+    return t;
+
+  std::size_t n = workers.size();
+  std::size_t start;
+  if (self != npos) {
+    std::uint32_t& s = workers[self]->seed;
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    start = s % n;
+  }
+  else {
+    start = std::hash<std::thread::id>()(std::this_thread::get_id()) % n;
+  }
+  for (std::size_t k = 0; k < n; ++k) {
+    std::size_t v = (start + k) % n;
+    if (v != self && workers[v]->deque.steal(t))
+      return t;
+  }
+
+  if (shared_size.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (!shared.empty()) {
+      t = shared.front();
+      shared.pop_front();
+      shared_size.fetch_sub(1);
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+// Run t and signal its group. The task is destroyed before the group is
+// signaled, since the group may be destroyed as soon as it completes.
+inline void
+thread_pool::execute(pool_task* t)
+{
+  pending.fetch_sub(1);
+  t->execute();
+  task_group* g = t->group;
+  delete t;
+  if (g)
+    task_group_done(g);
+}
+
+// Execute one task, if any is available. Returns false if none was found.
+inline bool
+thread_pool::run_one()
+{
+  pool_task* t = find_task(worker_index());
+  if (!t)
+    return false;
+  execute(t);
+  return true;
+}
+
+// The main loop of worker i.
+inline void
+thread_pool::work(std::size_t i)
+{
+  pool_impl::current() = {this, i};
+  while (true) {
+    pool_task* t = find_task(i);
+    for (int spin = 0; !t && spin < 64; ++spin) {
+      std::this_thread::yield();
+      t = find_task(i);
+    }
+    if (t) {
+      execute(t);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleeping.fetch_add(1);
+    wake.wait(lock, [this]() {
+      return stopping.load() || pending.load() != 0;
+    });
+    sleeping.fetch_sub(1);
+    if (stopping.load() && pending.load() == 0)
+      break;
+  }
+}
+
+
+// A set of tasks that can be waited on together. Calling run(f) forks a
+// task that calls f, and wait() returns when all forked tasks, including
+// those forked while waiting, have finished. The waiting thread executes
+// tasks in the meantime. The destructor waits.
+struct task_group
+{
+  explicit task_group(thread_pool& p)
+    : pool(p), count(0)
+  { }
+
+  task_group(task_group const&) = delete;
+  task_group& operator=(task_group const&) = delete;
+
+  ~task_group() { wait(); }
+
+  template<typename F>
+  void run(F f);
+
+  void wait();
+
+  thread_pool& pool;
+  std::atomic<std::size_t> count; // Unfinished tasks
+};
+
+// Called by the pool when a task of g has finished.
+inline void
+task_group_done(task_group* g)
+{
+  g->count.fetch_sub(1, std::memory_order_release);
+}
+
+template<typename F>
+void
+task_group::run(F f)
+{
+  pool_task* t = new function_task<F>(std::move(f));
+  t->group = this;
+  count.fetch_add(1, std::memory_order_relaxed);
+  pool.submit(t);
+}
+
+inline void
+task_group::wait()
+{
+  while (count.load(std::memory_order_acquire) != 0) {
+    if (!pool.run_one())
+      std::this_thread::yield();
+  }
+}
+
+
+// Returns the pool shared by parallel algorithms that are not given one.
+// It is started on first use with one worker fewer than concurrency(),
+// since the calling thread also executes tasks while it waits.
+inline thread_pool&
+default_pool()
+{
+  static thread_pool pool(concurrency() > 1 ? concurrency() - 1 : 1);
+  return pool;
+}
+
+
+namespace pool_impl {
+
+// Call f on [first, last) in chunks of grain elements. Before each chunk,
+// if the tasks this thread has spawned have all been taken by others, the
+// remaining range is split in half and the upper half is forked. Splitting
+// therefore adapts to the number of idle threads (lazy binary splitting).
+template<typename T, typename F>
+void
+split_range(task_group& g, T first, T last, F& f, std::size_t grain)
+{
+  while (first != last) {
+    std::size_t n = last - first;
+    if (n > grain && !g.pool.has_local_work()) {
+      T mid = first + n / 2;
+      g.run([&g, mid, last, &f, grain]() {
+        split_range(g, mid, last, f, grain);
+      });
+      last = mid;
+      continue;
+    }
+    T next = first + std::min(n, grain);
+    f(counted_range<T>(first, next));
+    first = next;
+  }
+}
+
+} // namespace pool_impl
+
+
+// Call f on blocks of r, which are given as counted_range<T>, using the
+// threads of pool. Blocks have at most grain elements. This returns when
+// all blocks have been processed. May be called from within a task.
+template<typename T, typename F>
+void
+parallel_for(thread_pool& pool, counted_range<T> r, F f,
+             std::size_t grain = 64)
+{
+  if (r.empty())
+    return;
+  T first = *r.begin();
+  task_group g(pool);
+  grain = std::max<std::size_t>(grain, 1);
+  pool_impl::split_range(g, first, first + r.size(), f, grain);
+  g.wait();
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,62 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../thread_pool.hpp"
+
+#include <cassert>
+#include <iostream>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  std::vector<int> xs(10000);
+  for (int i = 0; i < 10000; ++i)
+    xs[i] = i;
+
+  // The owner pops in LIFO order and thieves steal in FIFO order. The
+  // deque grows past its initial capacity.
+  work_stealing_deque<int*> d(4);
+  assert(d.is_empty());
+  for (int i = 0; i < 10; ++i)
+    d.push(&xs[i]);
+  int* p;
+  assert(d.steal(p) && *p == 0);
+  assert(d.pop(p) && *p == 9);
+  assert(d.steal(p) && *p == 1);
+  for (int i = 8; i >= 2; --i)
+    assert(d.pop(p) && *p == i);
+  assert(!d.pop(p));
+  assert(!d.steal(p));
+  assert(d.is_empty());
+
+  // Every element is taken exactly once while the owner pushes and pops
+  // and other threads steal.
+  work_stealing_deque<int*> q(2);
+  std::vector<std::atomic<int>> taken(xs.size());
+  std::atomic<bool> done(false);
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; ++t) {
+    thieves.emplace_back([&]() {
+      int* x;
+      while (!done.load() || !q.is_empty())
+        if (q.steal(x))
+          ++taken[*x];
+    });
+  }
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    q.push(&xs[i]);
+    if (i % 3 == 0 && q.pop(p))
+      ++taken[*p];
+  }
+  while (q.pop(p))
+    ++taken[*p];
+  done.store(true);
+  for (std::thread& t : thieves)
+    t.join();
+  for (auto const& n : taken)
+    assert(n.load() == 1);
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../for_each.hpp"
+#include "../thread_pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+long
+fib(thread_pool& pool, int n)
+{
+  if (n < 20) {
+    long a = 0, b = 1;
+    for (int i = 0; i < n; ++i) {
+      long c = a + b;
+      a = b;
+      b = c;
+    }
+    // Simulate the work of a sequential leaf.
+    volatile double x = 0;
+    for (int i = 0; i < 2000; ++i)
+      x = x + std::sqrt(double(i));
+    return a;
+  }
+  long a, b;
+  task_group g(pool);
+  g.run([&]() { a = fib(pool, n - 1); });
+  b = fib(pool, n - 2);
+  g.wait();
+  return a + b;
+}
+
+
+// Reports the time and speedup of a fine-grained loop, recursive fork/join,
+// and a loop over the out edges of a graph with skewed degrees, for pools
+// of increasing size. Pass the largest pool size to test beyond the number
+// of processors, and 1 to pin workers.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t max = argc > 1 ? std::atoi(argv[1]) : concurrency();
+  bool pinned = argc > 2 && std::atoi(argv[2]);
+
+  // Most edges leave a few vertices.
+  digraph<> g;
+  std::size_t n = 200000;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(1);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  for (vertex_t u = 0; u < n; ++u) {
+    std::size_t d = u % 1000 == 0 ? 2000 : 4;
+    for (std::size_t i = 0; i < d; ++i) {
+      vertex_t v = pick(gen);
+      if (!g.has_edge(u, v))
+        g.add_edge(u, v);
+    }
+  }
+
+  std::vector<double> xs(1 << 22);
+  std::vector<double> ys(g.num_edges());
+  double base[3] = {0, 0, 0};
+  std::cout << "threads  loop (ms)  fork/join (ms)  out edges (ms)\n";
+  for (std::size_t k = 1; k <= max; k *= 2) {
+    thread_pool pool(k, pinned);
+    ms t[3];
+
+    auto start = clock::now();
+    parallel_for(pool, counted_range<std::size_t>(xs.size()),
+                 [&](counted_range<std::size_t> r) {
+      for (std::size_t i : r)
+        xs[i] = std::sqrt(double(i)) * std::log1p(double(i));
+    });
+    t[0] = clock::now() - start;
+
+    start = clock::now();
+    long f = fib(pool, 32);
+    t[1] = clock::now() - start;
+
+    start = clock::now();
+    for_each_out_edge(pool, g, [&](vertex_t u, edge_t e) {
+      ys[e] = std::sqrt(double(u + g.target(e)));
+    }, edge_schedule);
+    t[2] = clock::now() - start;
+
+    std::cout << k;
+    for (int i = 0; i < 3; ++i) {
+      if (k == 1)
+        base[i] = t[i].count();
+      std::cout << "  " << t[i].count() << " (" << base[i] / t[i].count()
+                << "x)";
+    }
+    std::cout << "  [" << f << "]\n";
+  }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../for_each.hpp"
+#include "../thread_pool.hpp"
+
+#include <cassert>
+#include <iostream>
+
+
+using namespace origin;
+
+
+// Computes Fibonacci numbers by recursive fork/join.
+long
+fib(thread_pool& pool, int n)
+{
+  if (n < 2)
+    return n;
+  long a, b;
+  task_group g(pool);
+  g.run([&]() { a = fib(pool, n - 1); });
+  b = fib(pool, n - 2);
+  g.wait();
+  return a + b;
+}
+
+
+int
+main()
+{
+  for (std::size_t n : {1, 2, 4}) {
+    thread_pool pool(n, n == 2);
+    assert(pool.size() == n);
+    assert(pool.worker_index() == thread_pool::npos);
+    assert(fib(pool, 20) == 6765);
+
+    // Each element is visited once, including by nested loops.
+    std::vector<std::atomic<int>> seen(10000);
+    parallel_for(pool, counted_range<std::size_t>(100),
+                 [&](counted_range<std::size_t> r) {
+      for (std::size_t i : r) {
+        parallel_for(pool, counted_range<std::size_t>(i * 100, i * 100 + 100),
+                     [&](counted_range<std::size_t> s) {
+          for (std::size_t j : s)
+            ++seen[j];
+        }, 7);
+      }
+    }, 1);
+    for (auto const& x : seen)
+      assert(x.load() == 1);
+
+    // Tasks submitted from outside the pool.
+    std::atomic<int> count(0);
+    {
+      task_group g(pool);
+      for (int i = 0; i < 100; ++i)
+        g.run([&count]() { ++count; });
+    }
+    assert(count.load() == 100);
+
+    // Graph iteration on the pool.
+    digraph<> d;
+    for (int i = 0; i < 1000; ++i)
+      d.add_vertex();
+    for (vertex_t v = 1; v < 1000; ++v) {
+      d.add_edge(0, v);
+      d.add_edge(v, v / 2);
+    }
+    std::vector<std::atomic<int>> outs(d.num_edges());
+    for_each_out_edge(pool, d, [&](vertex_t, edge_t e) { ++outs[e]; },
+                      edge_schedule, 16);
+    for (auto const& x : outs)
+      assert(x.load() == 1);
+    auto degree = [&d](vertex_t v) { return d.out_degree(v); };
+    assert(reduce_vertices(pool, d, degree, std::size_t(0)) ==
+           d.num_edges());
+  }
+}
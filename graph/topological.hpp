@@ -0,0 +1,338 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_TOPOLOGICAL_HPP
+#define GRAPH_TOPOLOGICAL_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// The state of Pearce and Kelly's repair of a topological order, shared by
+// dynamic_topological_order and reachability_index. Vertices are marked
+// with the current epoch when visited, so marks need not be cleared
+// between searches.
+struct topological_repair
+{
+  void reset(std::size_t n);
+  void next_epoch();
+
+  template<typename S, typename P>
+  bool operator()(vertex_t u, vertex_t v, std::vector<std::size_t>& positions,
+                  S successors, P predecessors);
+
+  std::vector<std::uint32_t> marks;
+  std::uint32_t epoch = 0;
+  std::vector<vertex_t> stack;
+  std::vector<vertex_t> forward;   // Vertices moved after the backward set
+  std::vector<vertex_t> backward;  // Vertices moved before the forward set
+  std::vector<std::size_t> slots;
+  std::size_t visits = 0;          // Vertices visited by repairs
+};
+
+// Clear the marks of n vertices.
+inline void
+topological_repair::reset(std::size_t n)
+{
+  marks.assign(n, 0);
+  epoch = 0;
+}
+
+inline void
+topological_repair::next_epoch()
+{
+  if (++epoch == 0) {
+    std::fill(marks.begin(), marks.end(), 0);
+    epoch = 1;
+  }
+}
+
+// Repair the positions for a new edge (u, v) where v precedes u, and
+// return false, leaving them unchanged, if v reaches u. Calling
+// successors(x, f) or predecessors(x, f) calls f(y) for each y adjacent
+// to x. The vertices reachable from v that precede u, and those reaching
+// u that follow v, are reassigned the positions they already occupy, so
+// that the latter precede the former. Each set keeps its relative order.
+template<typename S, typename P>
+bool
+topological_repair::operator()(vertex_t u, vertex_t v,
+                               std::vector<std::size_t>& positions,
+                               S successors, P predecessors)
+{
+  std::size_t lo = positions[v];
+  std::size_t hi = positions[u];
+  next_epoch();
+
+  // Vertices reachable from v that precede u.
+  bool cycle = false;
+  forward.clear();
+  stack.clear();
+  stack.push_back(v);
+  marks[v] = epoch;
+  while (!stack.empty() && !cycle) {
+    vertex_t x = stack.back();
+    stack.pop_back();
+    forward.push_back(x);
+    successors(x, [&](vertex_t y) {
+      if (y == u) {
+        cycle = true;
+      }
+      else if (marks[y] != epoch && positions[y] < hi) {
+        marks[y] = epoch;
+        stack.push_back(y);
+      }
+    });
+  }
+  if (cycle) {
+    visits += forward.size();
+    return false;
+  }
+
+  // Vertices reaching u that follow v. These cannot have been visited by
+  // the forward search, since that would imply a cycle.
+  backward.clear();
+  stack.push_back(u);
+  marks[u] = epoch;
+  while (!stack.empty()) {
+    vertex_t x = stack.back();
+    stack.pop_back();
+    backward.push_back(x);
+    predecessors(x, [&](vertex_t y) {
+      if (marks[y] != epoch && positions[y] > lo) {
+        marks[y] = epoch;
+        stack.push_back(y);
+      }
+    });
+  }
+
+  visits += forward.size() + backward.size();
+
+  auto by_position = [&positions](vertex_t x, vertex_t y) {
+    return positions[x] < positions[y];
+  };
+  std::sort(forward.begin(), forward.end(), by_position);
+  std::sort(backward.begin(), backward.end(), by_position);
+  slots.clear();
+  for (vertex_t x : backward)
+    slots.push_back(positions[x]);
+  for (vertex_t x : forward)
+    slots.push_back(positions[x]);
+  std::sort(slots.begin(), slots.end());
+  std::size_t i = 0;
+  for (vertex_t x : backward)
+    positions[x] = slots[i++];
+  for (vertex_t x : forward)
+    positions[x] = slots[i++];
+  return true;
+}
+
+
+// Maintains a topological order of a directed acyclic graph as edges are
+// added. Edges and vertices must be added through the order, which updates
+// the graph and then the order.
+//
+// Adding an edge (u, v) where u already precedes v costs O(1). Otherwise,
+// the order is repaired using Pearce and Kelly's algorithm: the vertices
+// reachable from v and the vertices reaching u, restricted to positions
+// between those of v and u, are searched and reassigned the positions
+// they already occupy, so that the latter precede the former. If the
+// search from v reaches u, the edge would create a cycle, and it is
+// rejected. The cost is proportional to the size of the affected region,
+// which is typically far smaller than the graph.
+template<typename G>
+struct dynamic_topological_order
+{
+  // Order the vertices of g, which must be acyclic.
+  dynamic_topological_order(G& g);
+
+  vertex_t add_vertex();
+  bool add_edge(vertex_t u, vertex_t v);
+
+  template<typename R>
+  std::size_t add_edges(R const& edges);
+
+  // Returns true if u precedes v in the order.
+  bool precedes(vertex_t u, vertex_t v) const
+  {
+    return positions[u] < positions[v];
+  }
+
+  bool reorder(vertex_t u, vertex_t v);
+  bool sort(std::vector<std::pair<vertex_t, vertex_t>> const& extra);
+
+  G& graph;
+  std::vector<vertex_t> order;        // The vertex at each position
+  std::vector<std::size_t> positions; // The position of each vertex
+  topological_repair repair;
+};
+
+template<typename G>
+dynamic_topological_order<G>::dynamic_topological_order(G& g)
+  : graph(g)
+{
+  bool acyclic = sort({});
+  assert(acyclic);
+  (void)acyclic;
+}
+
+// Add a vertex to the graph. The vertex is placed last in the order.
+template<typename G>
+vertex_t
+dynamic_topological_order<G>::add_vertex()
+{
+  vertex_t v = graph.add_vertex();
+  positions.push_back(order.size());
+  order.push_back(v);
+  repair.marks.push_back(0);
+  return v;
+}
+
+// Add the edge (u, v) to the graph and update the order. Returns false,
+// and does not add the edge, if the edge would create a cycle.
+template<typename G>
+bool
+dynamic_topological_order<G>::add_edge(vertex_t u, vertex_t v)
+{
+  if (u == v)
+    return false;
+  if (positions[u] > positions[v] && !reorder(u, v))
+    return false;
+  graph.add_edge(u, v);
+  return true;
+}
+
+// Add each edge (u, v) in the range of vertex pairs, and return the number
+// of edges added. Edges that agree with the current order are added first.
+// The rest are added in order, rejecting those that would create a cycle.
+//
+// Repairing the order one edge at a time may visit the same vertices
+// repeatedly. Once the repairs for a batch have visited more vertices than
+// the graph has vertices and edges, the order is recomputed once for the
+// graph and the remaining edges. If that finds a cycle, the remaining
+// edges are added one at a time so that the offending ones are rejected.
+template<typename G>
+template<typename R>
+std::size_t
+dynamic_topological_order<G>::add_edges(R const& edges)
+{
+  std::vector<std::pair<vertex_t, vertex_t>> rest;
+  std::size_t added = 0;
+  for (auto const& p : edges) {
+    if (positions[p.first] < positions[p.second]) {
+      graph.add_edge(p.first, p.second);
+      ++added;
+    }
+    else {
+      rest.emplace_back(p.first, p.second);
+    }
+  }
+
+  std::size_t budget = repair.visits + order.size() + graph.num_edges();
+  for (auto i = rest.begin(); i != rest.end(); ++i) {
+    if (repair.visits > budget) {
+      std::vector<std::pair<vertex_t, vertex_t>> tail(i, rest.end());
+      if (sort(tail)) {
+        for (auto const& p : tail)
+          graph.add_edge(p.first, p.second);
+        return added + tail.size();
+      }
+      budget = -1;
+    }
+    added += add_edge(i->first, i->second);
+  }
+  return added;
+}
+
+// Repair the order for the edge (u, v) where v precedes u. Returns false
+// if v reaches u.
+template<typename G>
+bool
+dynamic_topological_order<G>::reorder(vertex_t u, vertex_t v)
+{
+  auto successors = [this](vertex_t x, auto f) {
+    for (edge_t e : graph.out_edges(x))
+      f(graph.target(e));
+  };
+  auto predecessors = [this](vertex_t x, auto f) {
+    for (edge_t e : graph.in_edges(x))
+      f(graph.source(e));
+  };
+  if (!repair(u, v, positions, successors, predecessors))
+    return false;
+  for (vertex_t x : repair.backward)
+    order[positions[x]] = x;
+  for (vertex_t x : repair.forward)
+    order[positions[x]] = x;
+  return true;
+}
+
+// Recompute the order for the graph together with the extra edges, using
+// Kahn's algorithm. Vertices without predecessors are taken in their
+// previous order. Returns false, and leaves the order unchanged, if there
+// is a cycle.
+template<typename G>
+bool
+dynamic_topological_order<G>::sort(
+  std::vector<std::pair<vertex_t, vertex_t>> const& extra)
+{
+  std::size_t n = graph.num_vertices();
+  std::vector<std::size_t> degrees(n, 0);
+  for (vertex_t v : graph.vertices())
+    for (edge_t e : graph.out_edges(v))
+      ++degrees[graph.target(e)];
+
+  // Index the extra edges by source.
+  std::vector<std::size_t> offsets(n + 1, 0);
+  for (auto const& p : extra) {
+    ++offsets[p.first + 1];
+    ++degrees[p.second];
+  }
+  for (std::size_t i = 0; i < n; ++i)
+    offsets[i + 1] += offsets[i];
+  std::vector<vertex_t> heads(extra.size());
+  {
+    std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+    for (auto const& p : extra)
+      heads[next[p.first]++] = p.second;
+  }
+
+  std::vector<vertex_t> result;
+  result.reserve(n);
+  auto visit = [&](vertex_t v) {
+    if (--degrees[v] == 0)
+      result.push_back(v);
+  };
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = order.size() == n ? order[i] : i;
+    if (degrees[v] == 0)
+      result.push_back(v);
+  }
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    vertex_t x = result[i];
+    for (edge_t e : graph.out_edges(x))
+      visit(graph.target(e));
+    for (std::size_t j = offsets[x]; j < offsets[x + 1]; ++j)
+      visit(heads[j]);
+  }
+  if (result.size() != n)
+    return false;
+
+  order = std::move(result);
+  positions.resize(n);
+  for (std::size_t i = 0; i < n; ++i)
+    positions[order[i]] = i;
+  repair.reset(n);
+  return true;
+}
+
+
+} // namespace origin
+
+#endif
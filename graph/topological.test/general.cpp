@@ -0,0 +1,127 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../topological.hpp"
+
+#include <cassert>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Check that the order is a permutation that agrees with every edge.
+template<typename G>
+void
+check(dynamic_topological_order<G> const& topo, G const& g)
+{
+  assert(topo.order.size() == g.num_vertices());
+  for (std::size_t i = 0; i < topo.order.size(); ++i)
+    assert(topo.positions[topo.order[i]] == i);
+  for (edge_t e : g.edges())
+    assert(topo.precedes(g.source(e), g.target(e)));
+}
+
+int
+main()
+{
+  using G = digraph<>;
+
+  // Edges against the initial order are reordered locally, and edges
+  // closing a cycle are rejected.
+  {
+    G g;
+    for (int i = 0; i < 6; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    g.add_edge(3, 4);
+    dynamic_topological_order<G> topo(g);
+    check(topo, g);
+
+    assert(topo.add_edge(4, 0));
+    check(topo, g);
+    assert(topo.precedes(3, 2));
+
+    assert(!topo.add_edge(2, 3));
+    assert(!topo.add_edge(1, 1));
+    assert(!g.has_edge(2, 3));
+    assert(g.num_edges() == 4);
+
+    vertex_t v = topo.add_vertex();
+    assert(topo.add_edge(v, 3));
+    assert(topo.add_edge(2, 5));
+    check(topo, g);
+    assert(!topo.add_edge(5, v));
+  }
+
+  // Random insertions, one at a time and in batches, agree with the
+  // graph and reject exactly the edges that close cycles.
+  std::minstd_rand gen(7);
+  for (int trial = 0; trial < 2; ++trial) {
+    std::size_t n = 300;
+    G g;
+    for (std::size_t i = 0; i < n; ++i)
+      g.add_vertex();
+    dynamic_topological_order<G> topo(g);
+    std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+    for (int round = 0; round < 20; ++round) {
+      std::vector<std::pair<vertex_t, vertex_t>> batch;
+      for (int i = 0; i < 60; ++i) {
+        vertex_t u = pick(gen), v = pick(gen);
+        if (u == v || g.has_edge(u, v) || g.has_edge(v, u))
+          continue;
+        bool dup = false;
+        for (auto const& p : batch)
+          dup |= (p.first == u && p.second == v) ||
+                 (p.first == v && p.second == u);
+        if (!dup)
+          batch.emplace_back(u, v);
+      }
+      std::size_t m = g.num_edges();
+      std::size_t added;
+      if (trial == 0) {
+        added = 0;
+        for (auto const& p : batch)
+          added += topo.add_edge(p.first, p.second);
+      }
+      else {
+        added = topo.add_edges(batch);
+      }
+      assert(g.num_edges() == m + added);
+      check(topo, g);
+
+      // Every rejected edge closes a cycle.
+      for (auto const& p : batch) {
+        if (!g.has_edge(p.first, p.second))
+          assert(!topo.precedes(p.first, p.second));
+      }
+    }
+  }
+
+  // A large batch that reverses the initial order is sorted at once.
+  {
+    G g;
+    for (int i = 0; i < 100; ++i)
+      g.add_vertex();
+    dynamic_topological_order<G> topo(g);
+    std::vector<std::pair<vertex_t, vertex_t>> batch;
+    for (vertex_t v = 99; v > 0; --v)
+      batch.emplace_back(v, v - 1);
+    assert(topo.add_edges(batch) == 99);
+    check(topo, g);
+    assert(topo.order.front() == 99);
+
+    // A batch containing a cycle adds all but the closing edge.
+    G h;
+    for (int i = 0; i < 100; ++i)
+      h.add_vertex();
+    dynamic_topological_order<G> topo2(h);
+    batch.emplace_back(0, 99);
+    assert(topo2.add_edges(batch) == 99);
+    check(topo2, h);
+  }
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../dfs.hpp"
+#include "../topological.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Compares maintaining a topological order of a growing DAG incrementally,
+// in batches, and by recomputing a depth-first post-order after each
+// insertion. Edges mostly point from lower to higher numbered vertices, as
+// in a build graph, so most of them agree with the order.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  using G = digraph<>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 100000;
+  std::size_t m = argc > 2 ? std::atoi(argv[2]) : 2 * n;
+  std::size_t q = argc > 3 ? std::atoi(argv[3]) : 20000;
+
+  std::minstd_rand gen(11);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  auto edge = [&]() {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u > v && gen() % 20)
+      std::swap(u, v);
+    return std::make_pair(u, v);
+  };
+  auto fresh = [&](G const& g) {
+    G h;
+    for (std::size_t i = 0; i < n; ++i)
+      h.add_vertex();
+    for (edge_t e : g.edges())
+      h.add_edge(g.source(e), g.target(e));
+    return h;
+  };
+
+  // Build an initial DAG.
+  G g0;
+  for (std::size_t i = 0; i < n; ++i)
+    g0.add_vertex();
+  while (g0.num_edges() < m) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (u < v && !g0.has_edge(u, v))
+      g0.add_edge(u, v);
+  }
+  std::vector<std::pair<vertex_t, vertex_t>> updates;
+  while (updates.size() < q) {
+    auto p = edge();
+    if (p.first != p.second && !g0.has_edge(p.first, p.second) &&
+        !g0.has_edge(p.second, p.first))
+      updates.push_back(p);
+  }
+  std::cout << n << " vertices, " << m << " edges, " << q << " updates\n";
+
+  // One edge at a time.
+  {
+    G g = fresh(g0);
+    dynamic_topological_order<G> topo(g);
+    auto start = clock::now();
+    std::size_t added = 0;
+    for (auto const& p : updates) {
+      if (!g.has_edge(p.first, p.second))
+        added += topo.add_edge(p.first, p.second);
+    }
+    ms t = clock::now() - start;
+    std::cout << "incremental: " << 1e3 * t.count() / q << " us/edge, "
+              << added << " added\n";
+  }
+
+  // In batches.
+  for (std::size_t b : {100, 10000}) {
+    G g = fresh(g0);
+    dynamic_topological_order<G> topo(g);
+    auto start = clock::now();
+    std::size_t added = 0;
+    std::vector<std::pair<vertex_t, vertex_t>> batch;
+    for (std::size_t i = 0; i < q; i += b) {
+      batch.clear();
+      for (std::size_t j = i; j < std::min(q, i + b); ++j) {
+        auto const& p = updates[j];
+        if (!g.has_edge(p.first, p.second))
+          batch.push_back(p);
+      }
+      added += topo.add_edges(batch);
+    }
+    ms t = clock::now() - start;
+    std::cout << "batch " << b << ": " << 1e3 * t.count() / q
+              << " us/edge, " << added << " added\n";
+  }
+
+  // Recompute a post-order after each insertion. This is slow, so use
+  // fewer updates; cycles are not detected.
+  {
+    G g = fresh(g0);
+    std::size_t few = std::min<std::size_t>(q, 200);
+    auto start = clock::now();
+    for (std::size_t i = 0; i < few; ++i) {
+      auto const& p = updates[i];
+      if (!g.has_edge(p.first, p.second))
+        g.add_edge(p.first, p.second);
+      directed_dfs<G, two_bit_color_map, dfs_timestamps<>> dfs(g);
+      dfs();
+    }
+    ms t = clock::now() - start;
+    std::cout << "recompute: " << 1e3 * t.count() / few << " us/edge\n";
+  }
+}
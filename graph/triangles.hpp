@@ -0,0 +1,383 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_TRIANGLES_HPP
+#define GRAPH_TRIANGLES_HPP
+
+#include "common.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+
+namespace origin {
+
+// Sorted set intersection
+//
+// The intersections below take two strictly increasing sequences of 32-bit
+// values. The vectorized kernel compares a block of each sequence against
+// all rotations of the other, and advances the block with the smaller
+// maximum. AVX2 (8 lanes) or SSE2 (4 lanes) is selected when the compiler
+// targets it; the remainder is handled by a scalar merge.
+
+
+// Call f(x) for each x in both [a, a + na) and [b, b + nb), in increasing
+// order, using a scalar merge.
+template<typename F>
+void
+intersect_scalar(std::uint32_t const* a, std::size_t na,
+                 std::uint32_t const* b, std::size_t nb, F f)
+{
+  std::size_t i = 0, j = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j])
+      ++i;
+    else if (b[j] < a[i])
+      ++j;
+    else {
+      f(a[i]);
+      ++i;
+      ++j;
+    }
+  }
+}
+
+
+namespace triangles_impl {
+
+// Call f(p, mask) for blocks of common values, where bit k of mask is set
+// when p[k] is in both sequences. Each common value is reported once.
+template<typename F>
+void
+intersect_blocks(std::uint32_t const* a, std::size_t na,
+                 std::uint32_t const* b, std::size_t nb, F f)
+{
+  // When one sequence is much shorter, search the longer one instead.
+  if (na > nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (na * 32 < nb) {
+    std::uint32_t const* last = b + nb;
+    for (std::size_t i = 0; i < na && b != last; ++i) {
+      b = std::lower_bound(b, last, a[i]);
+      if (b != last && *b == a[i])
+        f(a + i, 1u);
+    }
+    return;
+  }
+
+  std::size_t i = 0, j = 0;
+#if defined(__AVX2__)
+  __m256i const rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va = _mm256_loadu_si256((__m256i const*)(a + i));
+    __m256i vb = _mm256_loadu_si256((__m256i const*)(b + j));
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    for (int k = 1; k < 8; ++k) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+    }
+    unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(m));
+    if (mask)
+      f(a + i, mask);
+    std::uint32_t amax = a[i + 7];
+    std::uint32_t bmax = b[j + 7];
+    i += 8 * (amax <= bmax);
+    j += 8 * (bmax <= amax);
+  }
+#endif
+#if defined(__SSE2__)
+  while (i + 4 <= na && j + 4 <= nb) {
+    __m128i va = _mm_loadu_si128((__m128i const*)(a + i));
+    __m128i vb = _mm_loadu_si128((__m128i const*)(b + j));
+    __m128i r1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    __m128i r2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i r3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+    __m128i m = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, r1)),
+      _mm_or_si128(_mm_cmpeq_epi32(va, r2), _mm_cmpeq_epi32(va, r3)));
+    unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(m));
+    if (mask)
+      f(a + i, mask);
+    std::uint32_t amax = a[i + 3];
+    std::uint32_t bmax = b[j + 3];
+    i += 4 * (amax <= bmax);
+    j += 4 * (bmax <= amax);
+  }
+#endif
+  intersect_scalar(a + i, na - i, b + j, nb - j, [f](std::uint32_t const& x) {
+    f(&x, 1u);
+  });
+}
+
+} // namespace triangles_impl
+
+
+// Call f(x) for each x in both [a, a + na) and [b, b + nb). Values are not
+// necessarily reported in increasing order.
+template<typename F>
+void
+intersect(std::uint32_t const* a, std::size_t na,
+          std::uint32_t const* b, std::size_t nb, F f)
+{
+  triangles_impl::intersect_blocks(a, na, b, nb,
+                                   [&f](std::uint32_t const* p, unsigned m) {
+    while (m) {
+      f(p[__builtin_ctz(m)]);
+      m &= m - 1;
+    }
+  });
+}
+
+// Returns the number of values in both [a, a + na) and [b, b + nb).
+inline std::size_t
+intersection_size(std::uint32_t const* a, std::size_t na,
+                  std::uint32_t const* b, std::size_t nb)
+{
+  std::size_t n = 0;
+  triangles_impl::intersect_blocks(a, na, b, nb,
+                                   [&n](std::uint32_t const*, unsigned m) {
+    n += __builtin_popcount(m);
+  });
+  return n;
+}
+
+
+// An orientation of an undirected graph. Vertices are ranked by an order,
+// by default of increasing degree (ties broken by id), and each edge is
+// directed from its lower to its higher ranked end. Loops and parallel
+// edges are dropped.
+//
+// The successors of each rank are stored contiguously as sorted 32-bit
+// ranks. Every triangle appears exactly once as ranks u < v < w, where v
+// and w are successors of u and w is a successor of v. With the degree
+// order, no rank has more than O(sqrt(m)) successors.
+struct oriented_graph
+{
+  std::size_t num_vertices() const { return order.size(); }
+  std::size_t num_edges() const { return heads.size(); }
+
+  // Returns the successors of rank r.
+  std::uint32_t const* successors(std::uint32_t r) const
+  {
+    return heads.data() + offsets[r];
+  }
+
+  std::size_t out_degree(std::uint32_t r) const
+  {
+    return offsets[r + 1] - offsets[r];
+  }
+
+  std::vector<vertex_t> order;        // The vertex with each rank
+  std::vector<std::size_t> offsets;   // Bounds of each successor list
+  std::vector<std::uint32_t> heads;
+  std::vector<std::size_t> degrees;   // The number of distinct neighbors
+};
+
+
+// Returns the orientation of g along order, which lists each vertex of g
+// once. Any order gives the same triangles, but the bound on successors
+// depends on it. A degeneracy order (see core.hpp) bounds the successors
+// of each rank by the degeneracy of g, which is at most O(sqrt(m)).
+template<typename G>
+oriented_graph
+orient(G const& g, std::vector<vertex_t> order)
+{
+  std::size_t n = g.num_vertices();
+  assert(n < std::numeric_limits<std::uint32_t>::max());
+  assert(order.size() == n);
+
+  oriented_graph h;
+  h.order = std::move(order);
+  std::vector<std::uint32_t> ranks(n);
+  for (std::uint32_t r = 0; r < n; ++r)
+    ranks[h.order[r]] = r;
+
+  // Count, fill, and sort the successors of each rank, and then remove
+  // duplicates in place.
+  std::vector<std::size_t> sizes(n);
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      std::size_t k = 0;
+      for (edge_t e : g.edges(h.order[v]))
+        k += ranks[g.opposite(e, h.order[v])] > v;
+      sizes[v] = k;
+    }
+  });
+  h.offsets.assign(n + 1, 0);
+  for (std::size_t r = 0; r < n; ++r)
+    h.offsets[r + 1] = h.offsets[r] + sizes[r];
+  h.heads.resize(h.offsets[n]);
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+    for (vertex_t v : r) {
+      std::uint32_t* first = h.heads.data() + h.offsets[v];
+      std::uint32_t* out = first;
+      for (edge_t e : g.edges(h.order[v])) {
+        std::uint32_t w = ranks[g.opposite(e, h.order[v])];
+        if (w > v)
+          *out++ = w;
+      }
+      std::sort(first, out);
+      sizes[v] = std::unique(first, out) - first;
+    }
+  });
+
+  // Compact the successor lists and count distinct neighbors.
+  h.degrees.assign(n, 0);
+  std::size_t k = 0;
+  for (std::size_t r = 0; r < n; ++r) {
+    std::size_t first = h.offsets[r];
+    h.offsets[r] = k;
+    for (std::size_t i = 0; i < sizes[r]; ++i) {
+      std::uint32_t w = h.heads[first + i];
+      h.heads[k++] = w;
+      ++h.degrees[w];
+    }
+    h.degrees[r] += sizes[r];
+  }
+  h.offsets[n] = k;
+  h.heads.resize(k);
+  h.heads.shrink_to_fit();
+  return h;
+}
+
+// Returns the degree-ordered orientation of g.
+template<typename G>
+oriented_graph
+orient_by_degree(G const& g)
+{
+  std::size_t n = g.num_vertices();
+  std::vector<vertex_t> order(n);
+  for (vertex_t v = 0; v < n; ++v)
+    order[v] = v;
+  parallel_sort(order.begin(), order.end(), [&g](vertex_t a, vertex_t b) {
+    std::size_t da = g.degree(a);
+    std::size_t db = g.degree(b);
+    return da < db || (da == db && a < b);
+  });
+  return orient(g, std::move(order));
+}
+
+
+// Returns the number of triangles in h. Ranks are processed in parallel
+// with dynamic scheduling, since the cost per rank is skewed.
+inline std::size_t
+count_triangles(oriented_graph const& h)
+{
+  std::atomic<std::size_t> total(0);
+  parallel_for_dynamic(counted_range<std::uint32_t>(h.num_vertices()),
+                       [&](counted_range<std::uint32_t> r) {
+    std::size_t k = 0;
+    for (std::uint32_t u : r) {
+      std::uint32_t const* su = h.successors(u);
+      std::size_t du = h.out_degree(u);
+      for (std::size_t i = 0; i < du; ++i) {
+        std::uint32_t v = su[i];
+        k += intersection_size(su, du, h.successors(v), h.out_degree(v));
+      }
+    }
+    total.fetch_add(k, std::memory_order_relaxed);
+  });
+  return total.load();
+}
+
+// Returns the number of triangles in g.
+template<typename G>
+std::size_t
+count_triangles(G const& g)
+{
+  return count_triangles(orient_by_degree(g));
+}
+
+
+// Returns the number of triangles containing each vertex, indexed by the
+// vertices of the oriented graph.
+inline std::vector<std::size_t>
+vertex_triangles(oriented_graph const& h)
+{
+  std::size_t n = h.num_vertices();
+  std::vector<std::atomic<std::size_t>> counts(n);
+  for (auto& x : counts)
+    x.store(0, std::memory_order_relaxed);
+  auto add = [&counts](std::uint32_t v, std::size_t k) {
+    counts[v].fetch_add(k, std::memory_order_relaxed);
+  };
+  parallel_for_dynamic(counted_range<std::uint32_t>(n),
+                       [&](counted_range<std::uint32_t> r) {
+    for (std::uint32_t u : r) {
+      std::uint32_t const* su = h.successors(u);
+      std::size_t du = h.out_degree(u);
+      std::size_t ku = 0;
+      for (std::size_t i = 0; i < du; ++i) {
+        std::uint32_t v = su[i];
+        std::size_t kv = 0;
+        intersect(su, du, h.successors(v), h.out_degree(v),
+                  [&](std::uint32_t w) {
+          add(w, 1);
+          ++kv;
+        });
+        if (kv)
+          add(v, kv);
+        ku += kv;
+      }
+      if (ku)
+        add(u, ku);
+    }
+  });
+
+  std::vector<std::size_t> result(n);
+  for (std::uint32_t r = 0; r < n; ++r)
+    result[h.order[r]] = counts[r].load(std::memory_order_relaxed);
+  return result;
+}
+
+// Returns the number of triangles containing each vertex of g.
+template<typename G>
+std::vector<std::size_t>
+vertex_triangles(G const& g)
+{
+  return vertex_triangles(orient_by_degree(g));
+}
+
+
+// Returns the local clustering coefficient of each vertex: the fraction of
+// pairs of distinct neighbors that are adjacent. Vertices with fewer than
+// two neighbors have coefficient 0.
+inline std::vector<double>
+clustering_coefficients(oriented_graph const& h)
+{
+  std::size_t n = h.num_vertices();
+  std::vector<std::size_t> counts = vertex_triangles(h);
+  std::vector<double> result(n, 0.0);
+  for (std::uint32_t r = 0; r < n; ++r) {
+    vertex_t v = h.order[r];
+    double d = h.degrees[r];
+    if (d > 1)
+      result[v] = 2.0 * counts[v] / (d * (d - 1));
+  }
+  return result;
+}
+
+// Returns the local clustering coefficient of each vertex of g.
+template<typename G>
+std::vector<double>
+clustering_coefficients(G const& g)
+{
+  return clustering_coefficients(orient_by_degree(g));
+}
+
+
+} // namespace origin
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../triangles.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <set>
+
+
+using namespace origin;
+
+
+// Returns a sorted sequence of distinct values drawn from [0, limit).
+std::vector<std::uint32_t>
+random_set(std::minstd_rand& gen, std::size_t n, std::uint32_t limit)
+{
+  std::uniform_int_distribution<std::uint32_t> dist(0, limit - 1);
+  std::set<std::uint32_t> s;
+  while (s.size() < n)
+    s.insert(dist(gen));
+  return {s.begin(), s.end()};
+}
+
+
+void
+check_intersection()
+{
+  std::minstd_rand gen(3);
+  std::size_t sizes[] = {0, 1, 3, 4, 7, 8, 9, 31, 100, 1000};
+  for (std::size_t na : sizes) {
+    for (std::size_t nb : sizes) {
+      auto a = random_set(gen, na, 2000);
+      auto b = random_set(gen, nb, 2000);
+      std::vector<std::uint32_t> x, y;
+      intersect_scalar(a.data(), na, b.data(), nb, [&](std::uint32_t v) {
+        x.push_back(v);
+      });
+      intersect(a.data(), na, b.data(), nb, [&](std::uint32_t v) {
+        y.push_back(v);
+      });
+      std::sort(y.begin(), y.end());
+      assert(x == y);
+      assert(intersection_size(a.data(), na, b.data(), nb) == x.size());
+    }
+  }
+}
+
+
+int
+main()
+{
+  check_intersection();
+
+  // K4 with a loop and a pendant edge.
+  graph<> k;
+  for (int i = 0; i < 5; ++i)
+    k.add_vertex();
+  for (vertex_t u = 0; u < 4; ++u)
+    for (vertex_t v = u + 1; v < 4; ++v)
+      k.add_edge(u, v);
+  k.add_edge(2, 2);
+  k.add_edge(3, 4);
+  assert(count_triangles(k) == 4);
+  auto t = vertex_triangles(k);
+  assert((t == std::vector<std::size_t>{3, 3, 3, 3, 0}));
+  auto c = clustering_coefficients(k);
+  assert(c[0] == 1.0 && c[1] == 1.0 && c[2] == 1.0);
+  assert(c[3] == 0.5);
+  assert(c[4] == 0.0);
+
+  // Compare with a direct count on a random graph.
+  graph<> g;
+  std::size_t n = 300;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(5);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  std::vector<std::vector<bool>> adj(n, std::vector<bool>(n));
+  for (int i = 0; i < 6000; ++i) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (g.has_edge(u, v))
+      continue;
+    g.add_edge(u, v);
+    if (u != v)
+      adj[u][v] = adj[v][u] = true;
+  }
+  std::vector<std::size_t> expect(n);
+  std::size_t total = 0;
+  for (vertex_t u = 0; u < n; ++u)
+    for (vertex_t v = u + 1; v < n; ++v)
+      for (vertex_t w = v + 1; adj[u][v] && w < n; ++w)
+        if (adj[u][w] && adj[v][w]) {
+          ++expect[u];
+          ++expect[v];
+          ++expect[w];
+          ++total;
+        }
+  oriented_graph h = orient_by_degree(g);
+  assert(count_triangles(h) == total);
+  assert(vertex_triangles(h) == expect);
+  c = clustering_coefficients(h);
+  for (vertex_t v = 0; v < n; ++v) {
+    double d = std::count(adj[v].begin(), adj[v].end(), true);
+    double x = d > 1 ? 2 * expect[v] / (d * (d - 1)) : 0;
+    assert(std::abs(c[v] - x) < 1e-12);
+  }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../triangles.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+
+using namespace origin;
+
+
+// Counts triangles on a preferential attachment graph, whose degrees follow
+// a power law. The vectorized count is compared with a scalar merge over
+// the same orientation and with a marking count over the original graph.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::size_t k = argc > 2 ? std::atoi(argv[2]) : 8;
+
+  // Each new vertex attaches to k distinct endpoints of existing edges.
+  graph<> g;
+  std::minstd_rand gen(17);
+  std::vector<vertex_t> ends;
+  for (std::size_t i = 0; i <= k; ++i)
+    g.add_vertex();
+  for (vertex_t u = 0; u <= k; ++u)
+    for (vertex_t v = u + 1; v <= k; ++v) {
+      g.add_edge(u, v);
+      ends.push_back(u);
+      ends.push_back(v);
+    }
+  while (g.num_vertices() < n) {
+    vertex_t u = g.add_vertex();
+    std::uniform_int_distribution<std::size_t> pick(0, ends.size() - 1);
+    for (std::size_t i = 0; i < k; ++i) {
+      vertex_t v = ends[pick(gen)];
+      if (g.has_edge(u, v))
+        continue;
+      g.add_edge(u, v);
+      ends.push_back(u);
+      ends.push_back(v);
+    }
+  }
+  std::size_t dmax = 0;
+  for (vertex_t v : g.vertices())
+    dmax = std::max(dmax, g.degree(v));
+  std::cout << g.num_vertices() << " vertices, " << g.num_edges()
+            << " edges, max degree " << dmax << '\n';
+
+  auto start = clock::now();
+  oriented_graph h = orient_by_degree(g);
+  ms t0 = clock::now() - start;
+  std::cout << "orient: " << t0.count() << " ms\n";
+
+  start = clock::now();
+  std::size_t total = count_triangles(h);
+  ms t1 = clock::now() - start;
+  std::cout << "count: " << t1.count() << " ms, " << total
+            << " triangles\n";
+
+  start = clock::now();
+  std::size_t scalar = 0;
+  for (std::uint32_t u = 0; u < h.num_vertices(); ++u) {
+    std::uint32_t const* su = h.successors(u);
+    for (std::size_t i = 0; i < h.out_degree(u); ++i) {
+      std::uint32_t v = su[i];
+      intersect_scalar(su, h.out_degree(u), h.successors(v),
+                       h.out_degree(v), [&](std::uint32_t) { ++scalar; });
+    }
+  }
+  ms t2 = clock::now() - start;
+  std::cout << "scalar count: " << t2.count() << " ms, " << scalar
+            << " triangles\n";
+
+  start = clock::now();
+  std::vector<double> c = clustering_coefficients(h);
+  ms t3 = clock::now() - start;
+  double avg = 0;
+  for (double x : c)
+    avg += x;
+  std::cout << "clustering: " << t3.count() << " ms, average "
+            << avg / c.size() << '\n';
+
+  // Mark the neighbors of each vertex and scan the neighbors of each
+  // neighbor. Each triangle is found six times.
+  start = clock::now();
+  std::vector<vertex_t> mark(n, n);
+  std::size_t naive = 0;
+  for (vertex_t u : g.vertices()) {
+    for (edge_t e : g.edges(u))
+      mark[g.opposite(e, u)] = u;
+    for (edge_t e : g.edges(u)) {
+      vertex_t v = g.opposite(e, u);
+      for (edge_t f : g.edges(v))
+        naive += mark[g.opposite(f, v)] == u;
+    }
+  }
+  ms t4 = clock::now() - start;
+  std::cout << "marking count: " << t4.count() << " ms, " << naive / 6
+            << " triangles\n";
+}
@@ -30,16 +30,16 @@ struct counted_iterator
   void operator->() const = delete;
   
   counted_iterator& operator++() { ++num_; return *this; }
-  counted_iterator& operator++(int) { auto x = *this; ++num_; return x; }
+  counted_iterator operator++(int) { auto x = *this; ++num_; return x; }
 
   counted_iterator& operator--() { --num_; return *this; }
-  counted_iterator& operator--(int) { auto x = *this; --num_; return x; }
+  counted_iterator operator--(int) { auto x = *this; --num_; return x; }
 
   counted_iterator& operator+=(std::ptrdiff_t n) { num_ += n; return *this; }
-  counted_iterator& operator-=(std::ptrdiff_t n) { num_ += n; return *this; }
+  counted_iterator& operator-=(std::ptrdiff_t n) { num_ -= n; return *this; }
 
-  bool operator==(counted_iterator i) { return num_ == i.num_; }
-  bool operator!=(counted_iterator i) { return num_ != i.num_; }
+  bool operator==(counted_iterator i) const { return num_ == i.num_; }
+  bool operator!=(counted_iterator i) const { return num_ != i.num_; }
 
   T num_;
 };
@@ -88,7 +88,8 @@ struct counted_range
   counted_iterator<T> begin() const { return first; }
   counted_iterator<T> end() const { return limit; }
 
-  std::size_t size() const { return limit.count - first.count; }
+  std::size_t size() const { return limit.num_ - first.num_; }
+  bool empty() const { return first == limit; }
 
   counted_iterator<T> first;
   counted_iterator<T> limit;
@@ -0,0 +1,409 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_VIEW_HPP
+#define GRAPH_VIEW_HPP
+
+#include "common.hpp"
+
+#include <iterator>
+#include <utility>
+
+
+namespace origin {
+
+// Graph views
+//
+// A view adapts a graph without copying it. Views refer to the underlying
+// graph, which must outlive them, and see later changes to it. Vertices
+// and edges of a view have the same identifiers as in the underlying graph,
+// so labels over the graph can be used with the view. Views are read-only;
+// vertices and edges are added to the underlying graph.
+
+
+// An iterator over the elements of [iter, last) that satisfy pred.
+template<typename I, typename P>
+struct filter_iterator
+{
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename std::iterator_traits<I>::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = typename std::iterator_traits<I>::reference;
+
+  filter_iterator(I i, I l, P p)
+    : iter(i), last(l), pred(p)
+  {
+    satisfy();
+  }
+
+  reference operator*() const { return *iter; }
+
+  filter_iterator& operator++()
+  {
+    ++iter;
+    satisfy();
+    return *this;
+  }
+
+  filter_iterator operator++(int)
+  {
+    filter_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(filter_iterator const& x) const { return iter == x.iter; }
+  bool operator!=(filter_iterator const& x) const { return iter != x.iter; }
+
+  // Advance to the next element satisfying pred.
+  void satisfy()
+  {
+    while (iter != last && !pred(*iter))
+      ++iter;
+  }
+
+  I iter;
+  I last;
+  P pred;
+};
+
+
+// The elements of [first, last) that satisfy pred.
+template<typename I, typename P>
+struct filter_range
+{
+  using iterator = filter_iterator<I, P>;
+
+  filter_range(I f, I l, P p)
+    : first(f), last(l), pred(p)
+  { }
+
+  iterator begin() const { return iterator(first, last, pred); }
+  iterator end() const { return iterator(last, last, pred); }
+
+  bool empty() const { return begin() == end(); }
+
+  // Returns the number of elements. This is linear in the size of the
+  // underlying range.
+  std::size_t size() const { return std::distance(begin(), end()); }
+
+  I first;
+  I last;
+  P pred;
+};
+
+
+// A predicate that accepts every vertex or edge. Filtering with keep_all
+// compiles to a plain traversal.
+struct keep_all
+{
+  bool operator()(std::size_t) const { return true; }
+};
+
+
+// A directed graph whose edges are reversed. Outgoing edges of the view
+// are incoming edges of the graph, and the source of an edge in the view
+// is its target in the graph.
+template<typename G>
+struct reverse_view
+{
+  using vertex_range = decltype(std::declval<G const&>().vertices());
+  using edge_range = decltype(std::declval<G const&>().edges());
+
+  explicit reverse_view(G const& g)
+    : graph(g)
+  { }
+
+  // Vertex list
+  bool is_null() const { return graph.is_null(); }
+  std::size_t num_vertices() const { return graph.num_vertices(); }
+  vertex_range vertices() const { return graph.vertices(); }
+
+  // Edge list
+  bool is_empty() const { return graph.is_empty(); }
+  std::size_t num_edges() const { return graph.num_edges(); }
+  edge_range edges() const { return graph.edges(); }
+
+  // Incidence list
+  // Ranges of views are returned by value, and those of graphs by reference.
+  decltype(auto) out_edges(vertex_t v) const { return graph.in_edges(v); }
+  decltype(auto) in_edges(vertex_t v) const { return graph.out_edges(v); }
+
+  std::size_t out_degree(vertex_t v) const { return graph.in_degree(v); }
+  std::size_t in_degree(vertex_t v) const { return graph.out_degree(v); }
+  std::size_t degree(vertex_t v) const { return graph.degree(v); }
+
+  bool has_edge(vertex_t u, vertex_t v) const { return graph.has_edge(v, u); }
+  edge_t edge(vertex_t u, vertex_t v) const { return graph.edge(v, u); }
+
+  vertex_t source(edge_t e) const { return graph.target(e); }
+  vertex_t target(edge_t e) const { return graph.source(e); }
+
+  G const& graph;
+};
+
+template<typename G>
+inline reverse_view<G>
+reversed(G const& g)
+{
+  return reverse_view<G>(g);
+}
+
+
+// A directed graph restricted to the vertices satisfying vp and the edges
+// satisfying ep whose ends both satisfy vp. Predicates are called during
+// each traversal, so they should be cheap.
+//
+// Vertices keep their identifiers, so num_vertices() returns the number of
+// vertices of the underlying graph, which bounds the identifiers of the
+// view; this is what algorithms use to size their vertex labels. Counting
+// the vertices, edges, or degrees of a view requires a traversal.
+template<typename G, typename VP = keep_all, typename EP = keep_all>
+struct filtered_view
+{
+  // Accepts an edge satisfying ep whose ends satisfy vp.
+  struct edge_pred
+  {
+    bool operator()(edge_t e) const
+    {
+      return view->ep(e) && view->vp(view->graph.source(e)) &&
+             view->vp(view->graph.target(e));
+    }
+
+    filtered_view const* view;
+  };
+
+  // Accepts an incident edge satisfying ep whose opposite end, given by
+  // End, satisfies vp.
+  template<vertex_t (G::*End)(edge_t) const>
+  struct incidence_pred
+  {
+    bool operator()(edge_t e) const
+    {
+      return view->ep(e) && view->vp((view->graph.*End)(e));
+    }
+
+    filtered_view const* view;
+  };
+
+  using vertex_range =
+    filter_range<counted_iterator<vertex_t>, VP>;
+  using edge_range =
+    filter_range<counted_iterator<edge_t>, edge_pred>;
+  using out_edge_range =
+    filter_range<edge_list::const_iterator, incidence_pred<&G::target>>;
+  using in_edge_range =
+    filter_range<edge_list::const_iterator, incidence_pred<&G::source>>;
+
+  filtered_view(G const& g, VP vp = VP(), EP ep = EP())
+    : graph(g), vp(vp), ep(ep)
+  { }
+
+  // Vertex list
+  std::size_t num_vertices() const { return graph.num_vertices(); }
+
+  vertex_range vertices() const
+  {
+    return {0, graph.num_vertices(), vp};
+  }
+
+  // Edge list
+  edge_range edges() const
+  {
+    return {0, graph.num_edges(), edge_pred{this}};
+  }
+
+  // Incidence list. The edges of a vertex not in the view are those of the
+  // graph that satisfy the predicates.
+  out_edge_range out_edges(vertex_t v) const
+  {
+    edge_list const& out = graph.out_edges(v);
+    return {out.begin(), out.end(), {this}};
+  }
+
+  in_edge_range in_edges(vertex_t v) const
+  {
+    edge_list const& in = graph.in_edges(v);
+    return {in.begin(), in.end(), {this}};
+  }
+
+  std::size_t out_degree(vertex_t v) const { return out_edges(v).size(); }
+  std::size_t in_degree(vertex_t v) const { return in_edges(v).size(); }
+  std::size_t degree(vertex_t v) const
+  {
+    return out_degree(v) + in_degree(v);
+  }
+
+  bool has_vertex(vertex_t v) const { return vp(v); }
+
+  bool has_edge(vertex_t u, vertex_t v) const
+  {
+    return vp(u) && vp(v) && graph.has_edge(u, v) && ep(graph.edge(u, v));
+  }
+
+  vertex_t source(edge_t e) const { return graph.source(e); }
+  vertex_t target(edge_t e) const { return graph.target(e); }
+
+  G const& graph;
+  VP vp;
+  EP ep;
+};
+
+// Returns a view of g containing the vertices satisfying vp.
+template<typename G, typename VP>
+inline filtered_view<G, VP>
+filter_vertices(G const& g, VP vp)
+{
+  return filtered_view<G, VP>(g, vp);
+}
+
+// Returns a view of g containing the edges satisfying ep.
+template<typename G, typename EP>
+inline filtered_view<G, keep_all, EP>
+filter_edges(G const& g, EP ep)
+{
+  return filtered_view<G, keep_all, EP>(g, keep_all(), ep);
+}
+
+// Returns a view of g containing the vertices satisfying vp and the edges
+// satisfying ep.
+template<typename G, typename VP, typename EP>
+inline filtered_view<G, VP, EP>
+filtered(G const& g, VP vp, EP ep)
+{
+  return filtered_view<G, VP, EP>(g, vp, ep);
+}
+
+
+// An iterator over the outgoing and then the incoming edges of a vertex.
+struct incident_edge_iterator
+{
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = edge_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = edge_t const*;
+  using reference = edge_t;
+
+  incident_edge_iterator(edge_t const* p, edge_t const* l, edge_t const* n)
+    : pos(p), last(l), next(n)
+  {
+    if (pos == last)
+      pos = next;
+  }
+
+  edge_t operator*() const { return *pos; }
+
+  incident_edge_iterator& operator++()
+  {
+    if (++pos == last)
+      pos = next;
+    return *this;
+  }
+
+  incident_edge_iterator operator++(int)
+  {
+    incident_edge_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bool operator==(incident_edge_iterator const& x) const
+  {
+    return pos == x.pos;
+  }
+
+  bool operator!=(incident_edge_iterator const& x) const
+  {
+    return pos != x.pos;
+  }
+
+  edge_t const* pos;  // The current edge
+  edge_t const* last; // The end of the outgoing edges
+  edge_t const* next; // The start of the incoming edges
+};
+
+
+// The outgoing and incoming edges of a vertex.
+struct incident_edge_range
+{
+  incident_edge_iterator begin() const
+  {
+    return {out.data(), out.data() + out.size(), in.data()};
+  }
+
+  incident_edge_iterator end() const
+  {
+    edge_t const* p = in.data() + in.size();
+    return {p, p, p};
+  }
+
+  std::size_t size() const { return out.size() + in.size(); }
+  bool empty() const { return out.empty() && in.empty(); }
+
+  edge_list const& out;
+  edge_list const& in;
+};
+
+
+// An undirected graph whose edges are those of a directed graph without
+// their directions. The first and second ends of an edge are its source and
+// target. The edges of a vertex are its outgoing and then its incoming
+// edges, so a self loop appears twice. Edges (u, v) and (v, u) of the
+// digraph remain distinct.
+template<typename G>
+struct undirected_view
+{
+  using vertex_range = decltype(std::declval<G const&>().vertices());
+  using edge_range = decltype(std::declval<G const&>().edges());
+
+  explicit undirected_view(G const& g)
+    : graph(g)
+  { }
+
+  // Vertex list
+  bool is_null() const { return graph.is_null(); }
+  std::size_t num_vertices() const { return graph.num_vertices(); }
+  vertex_range vertices() const { return graph.vertices(); }
+
+  // Edge list
+  bool is_empty() const { return graph.is_empty(); }
+  std::size_t num_edges() const { return graph.num_edges(); }
+  edge_range edges() const { return graph.edges(); }
+
+  // Incidence list
+  incident_edge_range edges(vertex_t v) const
+  {
+    return {graph.out_edges(v), graph.in_edges(v)};
+  }
+
+  std::size_t degree(vertex_t v) const { return graph.degree(v); }
+
+  bool has_edge(vertex_t u, vertex_t v) const
+  {
+    return graph.has_edge(u, v) || graph.has_edge(v, u);
+  }
+
+  vertex_t first(edge_t e) const { return graph.source(e); }
+  vertex_t second(edge_t e) const { return graph.target(e); }
+
+  vertex_t opposite(edge_t e, vertex_t v) const
+  {
+    vertex_t u = graph.source(e);
+    return u == v ? graph.target(e) : u;
+  }
+
+  G const& graph;
+};
+
+template<typename G>
+inline undirected_view<G>
+undirected(G const& g)
+{
+  return undirected_view<G>(g);
+}
+
+
+} // namespace origin
+
+#endif
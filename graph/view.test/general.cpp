@@ -0,0 +1,119 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../dfs.hpp"
+#include "../output.hpp"
+#include "../view.hpp"
+
+#include <cassert>
+#include <sstream>
+#include <vector>
+
+
+using namespace origin;
+
+
+int
+main()
+{
+  using G = digraph<char, int>;
+  G g;
+  for (char c : {'a', 'b', 'c', 'd', 'e'})
+    g.add_vertex(c);
+  g.add_edge(0, 1, 5);  // a -> b
+  g.add_edge(1, 2, 1);  // b -> c
+  g.add_edge(2, 3, 7);  // c -> d
+  g.add_edge(0, 3, 2);  // a -> d
+  g.add_edge(4, 0, 9);  // e -> a
+
+  // Reversed edges.
+  {
+    auto r = reversed(g);
+    assert(r.num_vertices() == 5);
+    assert(r.num_edges() == 5);
+    assert(r.out_degree(3) == 2);
+    assert(r.in_degree(0) == 2);
+    assert(r.has_edge(3, 2) && !r.has_edge(2, 3));
+    assert(r.source(r.edge(1, 0)) == 1);
+
+    // Searching the reversed graph from d finds its ancestors.
+    directed_dfs<decltype(r)> dfs(r);
+    auto color = vertex_label(dfs.colors);
+    auto parent = vertex_label(dfs.parents);
+    dfs.explore(3, color, parent);
+    for (vertex_t v : g.vertices())
+      assert(dfs.colors[v] != white);
+
+    std::ostringstream os;
+    print_digraph<decltype(r)> print(os, r);
+    print();
+    assert(os.str().find("1 -> 0\n") != std::string::npos);
+  }
+
+  // Edges with heavy weights, and vertices other than c.
+  {
+    auto weight = [&g](edge_t e) { return g.edges_[e].data; };
+    auto heavy = filter_edges(g, [&](edge_t e) { return weight(e) > 4; });
+    std::vector<edge_t> es(heavy.edges().begin(), heavy.edges().end());
+    assert((es == std::vector<edge_t>{0, 2, 4}));
+    assert(heavy.out_degree(0) == 1);
+    assert(heavy.in_degree(3) == 1);
+    assert(heavy.has_edge(0, 1) && !heavy.has_edge(0, 3));
+
+    auto no_c = filter_vertices(g, [](vertex_t v) { return v != 2; });
+    std::vector<vertex_t> vs(no_c.vertices().begin(), no_c.vertices().end());
+    assert((vs == std::vector<vertex_t>{0, 1, 3, 4}));
+    assert(no_c.out_edges(1).empty());
+    assert(no_c.degree(3) == 1);
+    assert(!no_c.has_edge(1, 2));
+
+    // Without c and light edges, d is not reachable from a.
+    auto both = filtered(g, [](vertex_t v) { return v != 2; },
+                         [&](edge_t e) { return weight(e) > 4; });
+    directed_dfs<decltype(both)> dfs(both);
+    dfs();
+    assert(dfs.parents[1] == 0 && dfs.parents[0] == 0);
+    assert(dfs.parents[3] == 3);
+
+    std::ostringstream os;
+    print_digraph<decltype(both)> print(os, both);
+    print();
+    assert(os.str() == "digraph {\n0\n1\n3\n4\n0 -> 1\n4 -> 0\n}\n");
+
+    // Reversing a view, whose edge ranges are temporaries.
+    auto back = reversed(heavy);
+    std::vector<vertex_t> from_b;
+    for (edge_t e : back.out_edges(1))
+      from_b.push_back(back.target(e));
+    assert((from_b == std::vector<vertex_t>{0}));
+    std::vector<edge_t> into_a;
+    for (edge_t e : back.in_edges(0))
+      into_a.push_back(e);
+    assert((into_a == std::vector<edge_t>{0}));
+    assert(back.out_degree(0) == 1 && back.in_degree(0) == 1);
+  }
+
+  // Ignoring directions.
+  {
+    auto u = undirected(g);
+    assert(u.degree(0) == 3);
+    std::vector<vertex_t> adj;
+    for (edge_t e : u.edges(0))
+      adj.push_back(u.opposite(e, 0));
+    assert((adj == std::vector<vertex_t>{1, 3, 4}));
+    assert(u.has_edge(3, 2) && u.has_edge(2, 3));
+
+    undirected_dfs<decltype(u)> dfs(u);
+    auto color = vertex_label(dfs.colors);
+    auto parent = vertex_label(dfs.parents);
+    dfs.explore(3, color, parent);
+    for (vertex_t v : g.vertices())
+      assert(dfs.colors[v] != white);
+  }
+
+  // Views see later changes to the graph.
+  auto r = reversed(g);
+  g.add_edge(3, 4, 0);
+  assert(r.has_edge(4, 3));
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../view.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns the number of vertices reached by a breadth-first search of g
+// from each vertex in turn, until all are reached.
+template<typename G>
+std::size_t
+reach(G const& g)
+{
+  std::vector<char> seen(g.num_vertices(), 0);
+  std::vector<vertex_t> queue;
+  std::size_t count = 0;
+  for (vertex_t s : g.vertices()) {
+    if (seen[s])
+      continue;
+    seen[s] = 1;
+    queue.assign(1, s);
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+      for (edge_t e : g.out_edges(queue[i])) {
+        vertex_t v = g.target(e);
+        if (!seen[v]) {
+          seen[v] = 1;
+          queue.push_back(v);
+        }
+      }
+    }
+    count += queue.size();
+  }
+  return count;
+}
+
+// Compares traversing a graph directly, through views, and through a copy
+// made for the traversal.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using ms = std::chrono::duration<double, std::milli>;
+  using G = digraph<empty, int>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 200000;
+  std::size_t m = argc > 2 ? std::atoi(argv[2]) : 8 * n;
+
+  G g;
+  for (std::size_t i = 0; i < n; ++i)
+    g.add_vertex();
+  std::minstd_rand gen(5);
+  std::uniform_int_distribution<vertex_t> pick(0, n - 1);
+  while (g.num_edges() < m) {
+    vertex_t u = pick(gen), v = pick(gen);
+    if (!g.has_edge(u, v))
+      g.add_edge(u, v, gen() % 100);
+  }
+  std::cout << n << " vertices, " << m << " edges\n";
+
+  auto time = [](char const* name, auto f) {
+    auto start = clock::now();
+    std::size_t r = f();
+    ms t = clock::now() - start;
+    std::cout << name << ": " << t.count() << " ms (" << r << ")\n";
+  };
+
+  auto heavy = [&g](edge_t e) { return g.edges_[e].data >= 50; };
+  time("digraph", [&]() { return reach(g); });
+  time("reverse_view", [&]() { return reach(reversed(g)); });
+  time("filtered_view (all)", [&]() {
+    return reach(filtered_view<G>(g));
+  });
+  time("filtered_view (heavy)", [&]() {
+    return reach(filter_edges(g, heavy));
+  });
+  time("copy (heavy)", [&]() {
+    G h;
+    for (std::size_t i = 0; i < n; ++i)
+      h.add_vertex();
+    for (edge_t e : g.edges())
+      if (heavy(e))
+        h.add_edge(g.source(e), g.target(e), g.edges_[e].data);
+    return reach(h);
+  });
+}
@@ -0,0 +1,382 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#ifndef GRAPH_WALK_HPP
+#define GRAPH_WALK_HPP
+
+#include "common.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace origin {
+
+// Marks the positions of a walk after it reaches a vertex with no
+// successors, and samples of vertices with no neighbors.
+constexpr vertex_t walk_end = std::numeric_limits<vertex_t>::max();
+
+
+// A small, fast random number generator (splitmix64). Each thread owns
+// one, and reseeds it for each walk, so the walks do not depend on the
+// number of threads.
+struct walk_rng
+{
+  using result_type = std::uint64_t;
+
+  explicit walk_rng(std::uint64_t s = 0)
+    : state(s)
+  { }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()()
+  {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  // Returns a value in [0, n).
+  std::size_t below(std::size_t n)
+  {
+    return (unsigned __int128)(*this)() * n >> 64;
+  }
+
+  // Returns a value in [0, 1).
+  double unit() { return ((*this)() >> 11) * 0x1.0p-53; }
+
+  // Seed for the i-th task of a run seeded with s.
+  void reseed(std::uint64_t s, std::uint64_t i)
+  {
+    state = s;
+    state = (*this)() ^ i;
+    (*this)();
+  }
+
+  std::uint64_t state;
+};
+
+
+// Generates random walks and neighbor samples for a graph. Directed graphs
+// follow outgoing edges.
+//
+// The successors of each vertex are copied into a compact array, sorted by
+// vertex. Steps are uniform over the edges leaving a vertex, or are
+// weighted by a label W. Weighted steps draw from alias tables built for
+// each vertex, so each step takes constant time.
+//
+// Walks are first order (DeepWalk) when p and q are 1, and otherwise are
+// the second order walks of node2vec. Moving from t to v, the next vertex
+// x is weighted by 1/p if x is t, by 1 if x is a successor of t, and by
+// 1/q otherwise. These steps propose a first order step and accept it with
+// probability given by the bias, so they take constant expected time plus
+// a binary search of the successors of t. The search is skipped when the
+// random draw is accepted or rejected by both 1 and 1/q.
+//
+// Walks and samples are computed in parallel and written to a flat buffer
+// supplied by the caller. Task i is computed with a generator seeded from
+// seed and i, so results depend only on the seed.
+template<typename G, typename W = unit_weight>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+struct random_walker
+{
+  static constexpr bool weighted = !std::is_same<W, unit_weight>::value;
+
+  random_walker(G const& g, W weight = W());
+
+  std::size_t num_vertices() const { return offsets.size() - 1; }
+  std::size_t degree(vertex_t v) const
+  {
+    return offsets[v + 1] - offsets[v];
+  }
+
+  // Returns true if x is a successor of v.
+  bool adjacent(vertex_t v, vertex_t x) const
+  {
+    return std::binary_search(heads.begin() + offsets[v],
+                              heads.begin() + offsets[v + 1], x);
+  }
+
+  vertex_t step(vertex_t v, walk_rng& rng) const;
+  vertex_t step(vertex_t t, vertex_t v, walk_rng& rng) const;
+
+  void walk(vertex_t s, std::size_t length, walk_rng& rng,
+            vertex_t* out) const;
+
+  // Write a walk of length vertices from each start, including the start,
+  // to out[i * length, (i + 1) * length).
+  void walks(std::vector<vertex_t> const& starts, std::size_t length,
+             vertex_t* out) const;
+
+  // Write fanout successors of each vertex, sampled with replacement, to
+  // out[i * fanout, (i + 1) * fanout). Applying this to the samples of one
+  // layer gives the next layer, as in GraphSAGE.
+  void sample_neighbors(std::vector<vertex_t> const& vs, std::size_t fanout,
+                        vertex_t* out) const;
+
+  void build_aliases(vertex_t v, std::vector<double> const& w,
+                     std::vector<std::size_t>& small,
+                     std::vector<std::size_t>& large);
+
+  double p;
+  double q;
+  std::uint64_t seed;
+
+  std::vector<std::size_t> offsets;
+  std::vector<vertex_t> heads;
+  // The alias table of each vertex is stored with its successors. An entry
+  // packs the probability and the alias, so a step reads one entry.
+  struct alias_entry
+  {
+    float prob;
+    std::uint32_t alias;
+  };
+
+  std::vector<alias_entry> aliases;
+};
+
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+random_walker<G, W>::random_walker(G const& g, W weight)
+  : p(1), q(1), seed(1)
+{
+  std::size_t n = g.num_vertices();
+  offsets.assign(n + 1, 0);
+  for (vertex_t v = 0; v < n; ++v) {
+    if constexpr (incidence_graph<G>)
+      offsets[v + 1] = offsets[v] + g.out_degree(v);
+    else
+      offsets[v + 1] = offsets[v] + g.degree(v);
+  }
+  heads.resize(offsets[n]);
+  if (weighted)
+    aliases.resize(offsets[n]);
+
+  parallel_for(counted_range<vertex_t>(n), [&](counted_range<vertex_t> r) {
+    std::vector<std::pair<vertex_t, double>> adj;
+    std::vector<double> w;
+    std::vector<std::size_t> small, large;
+    for (vertex_t v : r) {
+      adj.clear();
+      for_each_successor(g, v, [&](vertex_t u, edge_t e) {
+        adj.emplace_back(u, weighted ? double(weight(e)) : 1.0);
+      });
+      std::sort(adj.begin(), adj.end());
+      std::size_t first = offsets[v];
+      w.clear();
+      for (std::size_t i = 0; i < adj.size(); ++i) {
+        heads[first + i] = adj[i].first;
+        w.push_back(adj[i].second);
+      }
+      if (weighted)
+        build_aliases(v, w, small, large);
+    }
+  }, 256);
+}
+
+// Build the alias table of v for the weights w of its successors, using
+// Vose's method. Successor i is taken with the probability of its entry,
+// and otherwise its alias is taken.
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+void
+random_walker<G, W>::build_aliases(vertex_t v, std::vector<double> const& w,
+                                   std::vector<std::size_t>& small,
+                                   std::vector<std::size_t>& large)
+{
+  std::size_t d = w.size();
+  assert(d < std::numeric_limits<std::uint32_t>::max());
+  std::size_t first = offsets[v];
+  double sum = 0;
+  for (double x : w) {
+    assert(x >= 0);
+    sum += x;
+  }
+  std::vector<double> scaled(d);
+  small.clear();
+  large.clear();
+  for (std::size_t i = 0; i < d; ++i) {
+    scaled[i] = sum > 0 ? w[i] * d / sum : 1.0;
+    (scaled[i] < 1 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    std::size_t s = small.back(), l = large.back();
+    small.pop_back();
+    aliases[first + s] = {float(scaled[s]), std::uint32_t(l)};
+    scaled[l] -= 1 - scaled[s];
+    if (scaled[l] < 1) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // Entries left over from rounding are taken with certainty.
+  for (std::size_t i : small)
+    aliases[first + i] = {1.0f, std::uint32_t(i)};
+  for (std::size_t i : large)
+    aliases[first + i] = {1.0f, std::uint32_t(i)};
+}
+
+// Returns a successor of v, or walk_end if there are none.
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+inline vertex_t
+random_walker<G, W>::step(vertex_t v, walk_rng& rng) const
+{
+  std::size_t d = degree(v);
+  if (d == 0)
+    return walk_end;
+  std::size_t i = offsets[v] + rng.below(d);
+  if (weighted) {
+    alias_entry a = aliases[i];
+    if (rng.unit() >= a.prob)
+      i = offsets[v] + a.alias;
+  }
+  return heads[i];
+}
+
+// Returns the successor of v after a step from t to v, with the node2vec
+// bias, or walk_end if there are none.
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+vertex_t
+random_walker<G, W>::step(vertex_t t, vertex_t v, walk_rng& rng) const
+{
+  double back = 1 / p, out = 1 / q;
+  double most = std::max({back, 1.0, out});
+  double lo = std::min(1.0, out), hi = std::max(1.0, out);
+  while (true) {
+    vertex_t x = step(v, rng);
+    if (x == walk_end)
+      return x;
+    double r = rng.unit() * most;
+    if (x == t) {
+      if (r < back)
+        return x;
+      continue;
+    }
+
+    // Search the successors of t only if the bias decides.
+    if (r < lo)
+      return x;
+    if (r >= hi)
+      continue;
+    if (r < (adjacent(t, x) ? 1.0 : out))
+      return x;
+  }
+}
+
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+void
+random_walker<G, W>::walk(vertex_t s, std::size_t length, walk_rng& rng,
+                          vertex_t* out) const
+{
+  if (length == 0)
+    return;
+  bool biased = p != 1 || q != 1;
+  out[0] = s;
+  vertex_t t = walk_end;
+  vertex_t v = s;
+  for (std::size_t i = 1; i < length; ++i) {
+    vertex_t x = biased && t != walk_end ? step(t, v, rng) : step(v, rng);
+    if (x == walk_end) {
+      std::fill(out + i, out + length, walk_end);
+      return;
+    }
+    out[i] = x;
+    t = v;
+    v = x;
+  }
+}
+
+// Walks are advanced in groups, one step of each walk at a time. Steps of
+// different walks are independent, so the cache misses of a group overlap
+// instead of being taken one after another. The results are the same as
+// calling walk() for each start.
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+void
+random_walker<G, W>::walks(std::vector<vertex_t> const& starts,
+                           std::size_t length, vertex_t* out) const
+{
+  constexpr std::size_t lanes = 16;
+  if (length == 0)
+    return;
+  bool biased = p != 1 || q != 1;
+  counted_range<std::size_t> r(starts.size());
+  parallel_for_dynamic(r, [&](counted_range<std::size_t> block) {
+    walk_rng rngs[lanes];
+    vertex_t prev[lanes];
+    vertex_t cur[lanes];
+    std::size_t first = *block.begin(), last = first + block.size();
+    for (std::size_t i = first; i < last; i += lanes) {
+      std::size_t m = std::min(lanes, last - i);
+      vertex_t* row = out + i * length;
+      for (std::size_t k = 0; k < m; ++k) {
+        rngs[k].reseed(seed, i + k);
+        prev[k] = walk_end;
+        cur[k] = row[k * length] = starts[i + k];
+      }
+      for (std::size_t j = 1; j < length; ++j) {
+        for (std::size_t k = 0; k < m; ++k) {
+          vertex_t v = cur[k];
+          vertex_t x = walk_end;
+          if (v != walk_end) {
+            x = biased && prev[k] != walk_end ? step(prev[k], v, rngs[k])
+                                              : step(v, rngs[k]);
+            if (x != walk_end)
+              __builtin_prefetch(&offsets[x]);
+          }
+          row[k * length + j] = x;
+          prev[k] = v;
+          cur[k] = x;
+        }
+      }
+    }
+  }, 64);
+}
+
+template<typename G, typename W>
+  requires vertex_list_graph<G> &&
+           (incidence_graph<G> || undirected_incidence_graph<G>)
+void
+random_walker<G, W>::sample_neighbors(std::vector<vertex_t> const& vs,
+                                      std::size_t fanout,
+                                      vertex_t* out) const
+{
+  counted_range<std::size_t> r(vs.size());
+  parallel_for_dynamic(r, [&](counted_range<std::size_t> block) {
+    walk_rng rng;
+    for (std::size_t i : block) {
+      rng.reseed(seed, i);
+      vertex_t* o = out + i * fanout;
+      for (std::size_t j = 0; j < fanout; ++j)
+        o[j] = vs[i] == walk_end ? walk_end : step(vs[i], rng);
+    }
+  }, 256);
+}
+
+
+} // namespace origin
+
+#endif
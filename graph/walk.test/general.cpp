@@ -0,0 +1,165 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../digraph.hpp"
+#include "../graph.hpp"
+#include "../walk.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Returns true if the frequency of k in n trials is close to p.
+bool
+near(std::size_t k, std::size_t n, double p)
+{
+  double sd = std::sqrt(p * (1 - p) / n);
+  return std::abs(double(k) / n - p) < 5 * sd + 1e-9;
+}
+
+
+int
+main()
+{
+  // Uniform walks on an undirected grid follow edges, and depend only on
+  // the seed.
+  {
+    graph<> g;
+    for (int i = 0; i < 25; ++i)
+      g.add_vertex();
+    for (vertex_t v = 0; v < 25; ++v) {
+      if (v % 5 < 4)
+        g.add_edge(v, v + 1);
+      if (v < 20)
+        g.add_edge(v, v + 5);
+    }
+    random_walker<graph<>> rw(g);
+    std::vector<vertex_t> starts;
+    for (int i = 0; i < 100; ++i)
+      starts.push_back(i % 25);
+    std::size_t length = 20;
+    std::vector<vertex_t> a(starts.size() * length);
+    rw.walks(starts, length, a.data());
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      assert(a[i * length] == starts[i]);
+      for (std::size_t j = 1; j < length; ++j)
+        assert(g.has_edge(a[i * length + j - 1], a[i * length + j]));
+    }
+    std::vector<vertex_t> b(a.size());
+    rw.walks(starts, length, b.data());
+    assert(a == b);
+
+    // Walks in groups are the same as single walks, also with node2vec.
+    for (double p : {1.0, 0.25}) {
+      rw.p = p;
+      rw.walks(starts, length, a.data());
+      walk_rng rng;
+      for (std::size_t i = 0; i < starts.size(); ++i) {
+        rng.reseed(rw.seed, i);
+        rw.walk(starts[i], length, rng, b.data() + i * length);
+      }
+      assert(a == b);
+    }
+    rw.p = 1;
+    rw.walks(starts, length, a.data());
+    rw.seed = 2;
+    rw.walks(starts, length, b.data());
+    assert(a != b);
+  }
+
+  // Directed walks stop at vertices without successors.
+  {
+    digraph<> g;
+    for (int i = 0; i < 3; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_edge(1, 2);
+    random_walker<digraph<>> rw(g);
+    std::vector<vertex_t> w(5);
+    rw.walks({0}, 5, w.data());
+    assert((w == std::vector<vertex_t> {0, 1, 2, walk_end, walk_end}));
+    rw.walks({2}, 1, w.data());
+    assert(w[0] == 2);
+  }
+
+  // Weighted steps follow the weights.
+  {
+    digraph<> g;
+    for (int i = 0; i < 5; ++i)
+      g.add_vertex();
+    std::vector<double> w;
+    for (vertex_t v = 1; v < 5; ++v) {
+      g.add_edge(0, v);
+      w.push_back(v);
+    }
+    g.add_edge(1, 0);
+    w.push_back(0);
+    random_walker<digraph<>, decltype(edge_label(w))> rw(g, edge_label(w));
+    std::size_t n = 100000;
+    std::vector<vertex_t> s(n);
+    rw.sample_neighbors({0}, n, s.data());
+    std::vector<std::size_t> counts(5, 0);
+    for (vertex_t v : s)
+      ++counts[v];
+    assert(counts[0] == 0);
+    for (vertex_t v = 1; v < 5; ++v)
+      assert(near(counts[v], n, v / 10.0));
+
+    // A vertex whose only edge has weight 0 still steps.
+    rw.sample_neighbors({1}, 10, s.data());
+    for (std::size_t i = 0; i < 10; ++i)
+      assert(s[i] == 0);
+  }
+
+  // node2vec steps from t to v weight a return by 1/p, a successor of t by
+  // 1, and other vertices by 1/q.
+  {
+    graph<> g;
+    for (int i = 0; i < 4; ++i)
+      g.add_vertex();
+    g.add_edge(0, 1);  // t = 0, v = 1
+    g.add_edge(1, 2);
+    g.add_edge(0, 2);  // 2 is a neighbor of t
+    g.add_edge(1, 3);  // 3 is not
+    random_walker<graph<>> rw(g);
+    rw.p = 0.5;
+    rw.q = 2;
+    std::size_t n = 100000;
+    std::vector<std::size_t> counts(4, 0);
+    walk_rng rng(7);
+    for (std::size_t i = 0; i < n; ++i)
+      ++counts[rw.step(0, 1, rng)];
+    assert(near(counts[0], n, 4.0 / 7));
+    assert(near(counts[2], n, 2.0 / 7));
+    assert(near(counts[3], n, 1.0 / 7));
+
+    // Walks use the biased steps.
+    std::vector<vertex_t> w(3000);
+    rw.walks(std::vector<vertex_t>(1000, 0), 3, w.data());
+    std::size_t back = 0, steps = 0;
+    for (std::size_t i = 0; i < 1000; ++i)
+      if (w[3 * i + 1] == 1) {
+        back += w[3 * i + 2] == 0;
+        ++steps;
+      }
+    assert(near(back, steps, 4.0 / 7));
+  }
+
+  // Neighbor samples of an isolated vertex, or of walk_end, are walk_end.
+  {
+    graph<> g;
+    g.add_vertex();
+    g.add_vertex();
+    g.add_edge(0, 1);
+    g.add_vertex();
+    random_walker<graph<>> rw(g);
+    std::vector<vertex_t> s(6);
+    rw.sample_neighbors({0, 2, walk_end}, 2, s.data());
+    assert((s == std::vector<vertex_t> {1, 1, walk_end, walk_end,
+                                        walk_end, walk_end}));
+  }
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2016 Andrew Sutton
+// All rights reserved
+
+#include "../graph.hpp"
+#include "../walk.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+using namespace origin;
+
+
+// Measures steps per second for uniform, weighted, and node2vec walks from
+// every vertex of a graph grown by preferential attachment, and samples
+// per second for two layers of neighbor sampling.
+int
+main(int argc, char* argv[])
+{
+  using clock = std::chrono::steady_clock;
+  using sec = std::chrono::duration<double>;
+
+  std::size_t n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  std::size_t length = argc > 2 ? std::atoi(argv[2]) : 80;
+  std::size_t d = 8;
+
+  graph<> g;
+  std::vector<vertex_t> ends;
+  std::minstd_rand gen(31);
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_t v = g.add_vertex();
+    for (std::size_t j = 0; j < d && !ends.empty(); ++j) {
+      vertex_t u = ends[gen() % ends.size()];
+      if (u != v && !g.has_edge(u, v)) {
+        g.add_edge(u, v);
+        ends.push_back(u);
+        ends.push_back(v);
+      }
+    }
+    ends.push_back(v);
+  }
+  std::vector<double> weights(g.num_edges());
+  for (double& w : weights)
+    w = 1 + gen() % 100;
+  std::cout << n << " vertices, " << g.num_edges() << " edges, walks of "
+            << length << '\n';
+
+  std::vector<vertex_t> starts(n);
+  for (vertex_t v = 0; v < n; ++v)
+    starts[v] = v;
+  std::vector<vertex_t> out(n * length);
+
+  auto run = [&](char const* name, auto const& rw) {
+    auto start = clock::now();
+    rw.walks(starts, length, out.data());
+    sec t = clock::now() - start;
+    std::cout << name << ": " << t.count() << " s, "
+              << n * (length - 1) / t.count() / 1e6 << " Msteps/s\n";
+  };
+
+  auto start = clock::now();
+  random_walker<graph<>> uniform(g);
+  sec t = clock::now() - start;
+  std::cout << "uniform tables: " << t.count() << " s\n";
+  run("deepwalk uniform", uniform);
+
+  start = clock::now();
+  random_walker<graph<>, decltype(edge_label(weights))>
+    weighted(g, edge_label(weights));
+  t = clock::now() - start;
+  std::cout << "alias tables: " << t.count() << " s\n";
+  run("deepwalk weighted", weighted);
+
+  uniform.p = 0.5;
+  uniform.q = 2;
+  run("node2vec p=0.5 q=2", uniform);
+  weighted.p = 4;
+  weighted.q = 0.25;
+  run("node2vec weighted p=4 q=0.25", weighted);
+
+  // Two layers with fanouts 10 and 5.
+  uniform.p = uniform.q = 1;
+  std::vector<vertex_t> layer1(n * 10), layer2(n * 50);
+  start = clock::now();
+  uniform.sample_neighbors(starts, 10, layer1.data());
+  uniform.sample_neighbors(layer1, 5, layer2.data());
+  t = clock::now() - start;
+  std::cout << "sage 10x5: " << t.count() << " s, "
+            << 60 * n / t.count() / 1e6 << " Msamples/s\n";
+}